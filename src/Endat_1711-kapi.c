@@ -45,6 +45,7 @@
  */
 
 #include "apci1710-private.h"
+#include "apci1710-trace.h"
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,0)
 static __inline__ unsigned long msecs_to_jiffies(unsigned long msecs)
@@ -64,6 +65,8 @@ EXPORT_SYMBOL( i_APCI1711_EndatSensorReceiveParameter);
 EXPORT_SYMBOL( i_APCI1711_EndatSensorSendPositionValue);
 EXPORT_SYMBOL( i_APCI1711_EndatSelectAdditionalData);
 EXPORT_SYMBOL( i_APCI1711_EndatSensorSendPositionValueWithAdditionalData);
+EXPORT_SYMBOL( i_APCI1711_EndatReadParameterArea);
+EXPORT_SYMBOL( i_APCI1711_EndatSetPositionStream);
 
 EXPORT_NO_SYMBOLS;
 
@@ -102,10 +105,11 @@ static __inline__ int WaitEndOfTransmission(struct pci_dev *pdev, uint8_t module
  * @param [in] mrsCode : EnDat mrs code (ex: 0xA1, 0xA3, ...) See EnDat specification page 31/131, 51/131, ...
  * @param [in] address : Address (usefull when getting/writting parameter) See EnDat specification page 51/131
  * @param [in] cmd : Command to send
+ * @param [in] pause : 1: wait 1 ms after the transmission, 0: the caller spaces the commands itself
  * @retval 0 success
  * @retval 1 timeout while sending
  */
-unsigned long Primary_EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t modeCommand, uint32_t mrsCode, uint32_t address, uint32_t cmd)
+static unsigned long EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t modeCommand, uint32_t mrsCode, uint32_t address, uint32_t cmd, int pause)
 {
 	uint32_t aiCount = 0;
 
@@ -124,6 +128,8 @@ unsigned long Primary_EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex
 	/* write the command that will be send to the sensor */
 	writel(cmd, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + (uint32_t) (64 * moduleIndex + (32 * channel) + 2) * WINDOWS_TO_LINUX_OFFSET);
 
+	trace_apci1710_endat_submit(pdev, moduleIndex, channel, modeCommand, cmd);
+
 	/* start the transmission */
 	writel(1, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + (uint32_t) (64 * moduleIndex + (32 * channel) + 11) * WINDOWS_TO_LINUX_OFFSET);
 
@@ -131,6 +137,9 @@ unsigned long Primary_EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex
 	if (WaitEndOfTransmission(pdev, moduleIndex, channel, 1000) != 0)
 	{
 		/* timeout */
+		trace_apci1710_endat_timeout(pdev, moduleIndex, channel);
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+
 		writel(0x2, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 11) * WINDOWS_TO_LINUX_OFFSET);
 
 		/* delay of 30 ms - as described in the specification */
@@ -140,12 +149,32 @@ unsigned long Primary_EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex
 		return 1;
 	}
 
+	trace_apci1710_endat_complete(pdev, moduleIndex, channel);
+
 	/* delay - as asked by the device manufacturor for compatibility with old devices */
-	mdelay(1);
+	if (pause)
+		mdelay(1);
 
 	return 0;
 }
 
+/**
+ * Send a command
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @param [in] modeCommand : EnDat mode (ex: 0x07, 0x0E, ...) See EnDat specification page 19/131
+ * @param [in] mrsCode : EnDat mrs code (ex: 0xA1, 0xA3, ...) See EnDat specification page 31/131, 51/131, ...
+ * @param [in] address : Address (usefull when getting/writting parameter) See EnDat specification page 51/131
+ * @param [in] cmd : Command to send
+ * @retval 0 success
+ * @retval 1 timeout while sending
+ */
+unsigned long Primary_EndatSendCommand(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t modeCommand, uint32_t mrsCode, uint32_t address, uint32_t cmd)
+{
+	return EndatSendCommand(pdev, moduleIndex, channel, modeCommand, mrsCode, address, cmd, 1);
+}
+
 /**
  * Send a command
  * @param [in] pdev : Pointer to the device
@@ -179,6 +208,11 @@ unsigned long Primary_EndatSendCommandWithExtraCmd(struct pci_dev *pdev, uint8_t
 	/* write the command that will be send to the sensor */
 	writel(cmd, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + (uint32_t) ((64 * moduleIndex + (32 * channel) + 2) * WINDOWS_TO_LINUX_OFFSET));
 
+	trace_apci1710_endat_submit(pdev, moduleIndex, channel, modeCommand, cmd);
+
+	/* the extra cmd selects another memory area */
+	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+
 	/* start the transmission */
 	writel(1, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + (uint32_t) ((64 * moduleIndex + (32 * channel) + 11) * WINDOWS_TO_LINUX_OFFSET));
 
@@ -189,6 +223,9 @@ unsigned long Primary_EndatSendCommandWithExtraCmd(struct pci_dev *pdev, uint8_t
 	if (WaitEndOfTransmission(pdev, moduleIndex, channel, 1000) != 0)
 	{
 		/* timeout */
+		trace_apci1710_endat_timeout(pdev, moduleIndex, channel);
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+
 		writel(0x2, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 11) * WINDOWS_TO_LINUX_OFFSET);
 
 		/* delay of 30 ms - as described in the specification */
@@ -198,6 +235,8 @@ unsigned long Primary_EndatSendCommandWithExtraCmd(struct pci_dev *pdev, uint8_t
 		return 1;
 	}
 
+	trace_apci1710_endat_complete(pdev, moduleIndex, channel);
+
 	/* delay - as asked by the device manufacturor for compatibility with old devices */
 	mdelay(1);
 
@@ -242,6 +281,121 @@ static int AllowEnDat22Command(struct pci_dev *pdev, unsigned char moduleIndex,
 	}
 }
 
+/**
+ * Return the index of a memory area in the parameter cache.
+ * Only the areas the sensor never changes by itself are cached: the parameters
+ * of the encoder manufacturer, the operating parameters and the OEM parameters.
+ * A cached parameter is read once from the sensor, then it is returned from the
+ * memory until it is written or the sensor is reset.
+ * @param [in] mrsCode : MRS-code of the memory area
+ * @retval -1 The memory area is not cached
+ */
+static int ParameterCacheArea(uint32_t mrsCode)
+{
+	const uint32_t cachedMrsCode[APCI1711_ENDAT_CACHED_AREAS] = {0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF};
+	int i = 0;
+
+	for (i = 0; i < APCI1711_ENDAT_CACHED_AREAS; i++)
+	{
+		if (mrsCode == cachedMrsCode[i])
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Forget everything the driver knows about a sensor (parameters and selected memory area)
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ */
+static void InvalidateParameterCache(struct pci_dev *pdev, unsigned char moduleIndex, unsigned char channel)
+{
+	memset(APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel], 0,
+	       sizeof(APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel]));
+
+	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+}
+
+/**
+ * Tell if a channel has a lock: the module is an EnDat module.
+ * The functionality of a module does not change while the board is used.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @retval 1 the channel exists
+ * @retval 0 wrong index or not an EnDat module
+ */
+static int EndatChannelExists(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	if ((moduleIndex > 3) || (channel > 1))
+		return 0;
+
+	return APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) == PCIE1711_ENDAT;
+}
+
+/**
+ * Take an EnDat channel for the whole execution of a function.
+ * The transfers of the ioctls, of the position compare thread and of the
+ * position stream do not interleave on the registers of the channel.
+ * A wrong index or a module which is not EnDat is not taken, the called
+ * function reports it.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @retval 0 the channel is taken (if it exists), release it with EndatChannelRelease
+ * @retval -EBUSY the position stream of the channel is running
+ */
+static int EndatChannelTake(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	if (!EndatChannelExists(pdev, moduleIndex, channel))
+		return 0;
+
+	mutex_lock(&APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].s_ChannelLock);
+
+	if (APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].b_Running)
+	{
+		mutex_unlock(&APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].s_ChannelLock);
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+/**
+ * Release a channel taken by EndatChannelTake
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ */
+static void EndatChannelRelease(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	if (!EndatChannelExists(pdev, moduleIndex, channel))
+		return;
+
+	mutex_unlock(&APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].s_ChannelLock);
+}
+
+/**
+ * Give the channel to the position stream or take it back.
+ * Waits for the function that uses the channel, the next ones return -EBUSY.
+ * @param [in] streamInfos : The stream of the channel
+ * @param [in] running : 1 the stream thread owns the channel, 0 the functions can use it again
+ */
+static void EndatChannelSetStream(str_EndatStreamInfos *streamInfos, uint8_t running)
+{
+	mutex_lock(&streamInfos->s_ChannelLock);
+	streamInfos->b_Running = running;
+	mutex_unlock(&streamInfos->s_ChannelLock);
+}
+
+/* used by EndatInitialiseSensor, the channel is already taken */
+static int EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel);
+static int EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode);
+static int EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t *param);
+static int EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t param);
+
 
 /** Initialise the EnDat sensor.
  * @param[in] pdev : Pointer to the device
@@ -265,7 +419,7 @@ static int AllowEnDat22Command(struct pci_dev *pdev, unsigned char moduleIndex,
  * @retval 15 Invalid freqValue
  * @retval 20 Transmission error
  */
-int i_APCI1711_EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t freqValue)
+static int EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t freqValue)
 {
 	uint32_t param = 0;
 	uint32_t registerValue = 0;
@@ -290,7 +444,7 @@ int i_APCI1711_EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex,
 		return 4;
 
 	/*reset the sensor*/
-	if (i_APCI1711_EndatSensorReceiveReset(pdev, moduleIndex, channel) != 0)
+	if (EndatSensorReceiveReset(pdev, moduleIndex, channel) != 0)
 		return 5;
 
 	/* delay of 50 ms - as described in the specification */
@@ -300,63 +454,63 @@ int i_APCI1711_EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex,
 	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 1;
 
 	/* select the memory space 0xB9 */
-	if (i_APCI1711_EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xB9) != 0)
+	if (EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xB9) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 6;
 	}
 
 	/* read the alarm space */
-	if (i_APCI1711_EndatSensorSendParameter(pdev, moduleIndex, channel, 0xB9, 0x0, &param) != 0)
+	if (EndatSensorSendParameter(pdev, moduleIndex, channel, 0xB9, 0x0, &param) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 7;
 	}
 
 	/* read the warning space */
-	if (i_APCI1711_EndatSensorSendParameter(pdev, moduleIndex, channel, 0xB9, 0x1, &param) != 0)
+	if (EndatSensorSendParameter(pdev, moduleIndex, channel, 0xB9, 0x1, &param) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 8;
 	}
 
 	/* clear the alarm */
-	if (i_APCI1711_EndatSensorReceiveParameter(pdev, moduleIndex, channel, 0xB9, 0x0, 0x0) != 0)
+	if (EndatSensorReceiveParameter(pdev, moduleIndex, channel, 0xB9, 0x0, 0x0) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 9;
 	}
 
 	/* clear the warning */
-	if (i_APCI1711_EndatSensorReceiveParameter(pdev, moduleIndex, channel, 0xB9, 0x1, 0x0) != 0)
+	if (EndatSensorReceiveParameter(pdev, moduleIndex, channel, 0xB9, 0x1, 0x0) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 10;
 	}
 
 	/* select the memory space 0xA1 */
-	if (i_APCI1711_EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xA1) != 0)
+	if (EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xA1) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 11;
 	}
 
 	/* read the with of a position value */
-	if (i_APCI1711_EndatSensorSendParameter(pdev, moduleIndex, channel, 0xA1, 0xD, &param) != 0)
+	if (EndatSensorSendParameter(pdev, moduleIndex, channel, 0xA1, 0xD, &param) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 12;
 	}
 
 	/* select the memory space 0xA5 */
-	if (i_APCI1711_EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xA5) != 0)
+	if (EndatSelectMemorySpace(pdev, moduleIndex, channel, 0xA5) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 13;
 	}
 
 	/* read the EnDat type */
-	if (i_APCI1711_EndatSensorSendParameter(pdev, moduleIndex, channel, 0xA5, 0x5, &param) != 0)
+	if (EndatSensorSendParameter(pdev, moduleIndex, channel, 0xA5, 0x5, &param) != 0)
 	{
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 		return 14;
@@ -427,7 +581,7 @@ int i_APCI1711_EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex,
  * @retval 4 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+static int EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
 {
 	uint32_t error = 0;
 
@@ -446,6 +600,9 @@ int i_APCI1711_EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex
 	/* reset the initialised state */
 	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.sensorInitialized[channel] = 0;
 
+	/* the sensor may have been replaced */
+	InvalidateParameterCache(pdev, moduleIndex, channel);
+
 	/* reset the frequency */
 	writel((124 << 8) + 124, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 0) * WINDOWS_TO_LINUX_OFFSET);
 
@@ -479,7 +636,7 @@ int i_APCI1711_EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex
  * @retval 2 channel is incorrect
  * @retval 3 the component is not programmed as EnDat
  */
-int i_APCI1711_EndatResetErrorBits(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+static int EndatResetErrorBits(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
 {
 	uint32_t error = 0;
 
@@ -530,20 +687,20 @@ int i_APCI1711_EndatResetErrorBits(struct pci_dev *pdev, uint8_t moduleIndex, ui
  * @retval 2 channel is incorrect
  * @retval 3 the component is not programmed as EnDat
  */
-int i_APCI1711_EndatGetErrorSources(struct pci_dev *pdev,
-                                    uint8_t moduleIndex,
-                                    uint8_t channel,
-                                    uint8_t *errorSrc1,
-                                    uint8_t *errorSrc2,
-                                    uint8_t *errorSrc3,
-                                    uint8_t *errorSrc4,
-                                    uint8_t *errorSrc7,
-                                    uint8_t *errorSrc8,
-                                    uint8_t *errorSrc9,
-                                    uint8_t *errorSrc10,
-                                    uint8_t *errorSrc11,
-                                    uint8_t *errorSrc12,
-                                    uint8_t *errorSrc13)
+static int EndatGetErrorSources(struct pci_dev *pdev,
+                                uint8_t moduleIndex,
+                                uint8_t channel,
+                                uint8_t *errorSrc1,
+                                uint8_t *errorSrc2,
+                                uint8_t *errorSrc3,
+                                uint8_t *errorSrc4,
+                                uint8_t *errorSrc7,
+                                uint8_t *errorSrc8,
+                                uint8_t *errorSrc9,
+                                uint8_t *errorSrc10,
+                                uint8_t *errorSrc11,
+                                uint8_t *errorSrc12,
+                                uint8_t *errorSrc13)
 
 {
 	uint32_t registerContent = 0;
@@ -577,8 +734,42 @@ int i_APCI1711_EndatGetErrorSources(struct pci_dev *pdev,
 	return 0;
 }
 
+/** Send the 0xE command and remember the selected memory area.
+ * The parameters must have been checked by the caller.
+ * @param[in] pdev : Pointer to the device
+ * @param[in] moduleIndex :	Index of the slave (0->3)
+ * @param[in] channel :	Index of the EnDat channel (0,1)
+ * @param[in] mrsCode :	The MRS-code corresponding to the memory area to select
+ *
+ * @retval 0 success
+ * @retval 6 timeout
+ * @retval 20 transmission error
+ */
+static int EndatSendMemorySelection(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+{
+	uint32_t error = 0;
+
+	/* send the 0xE command */
+	if (Primary_EndatSendCommand(pdev, moduleIndex, channel, 0xE, mrsCode, 0, ((0xE << 24) + (mrsCode << 16))) != 0)
+	{
+		/* timeout */
+		return 6;
+	}
+
+	error = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 13) * WINDOWS_TO_LINUX_OFFSET);
+	if ((error & 0x00000FDF) != 0)
+	{
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+		return 20;
+	}
+
+	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = mrsCode;
+	return 0;
+}
+
 /** Enable to execute the action "Select memory area" (see page 19/131 of EnDat specification)
  * The EnDat mode is 0xE
+ * The command is not sent again when the memory area is already selected.
  * @param[in] pdev : Pointer to the device
  * @param[in] moduleIndex :	Index of the slave (0->3)
  * @param[in] channel :	Index of the EnDat channel (0,1)
@@ -606,9 +797,8 @@ int i_APCI1711_EndatGetErrorSources(struct pci_dev *pdev,
  * @retval 6 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+static int EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
 {
-	uint32_t error = 0;
 
 	const int validMrsCodeSz = 13; /* if you change this value, please also change validMrsCode definition */
 	const uint32_t validMrsCode[13] = {0xB9, 0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF, 0xB1, 0xB3, 0xB5, 0xB7};
@@ -645,19 +835,11 @@ int i_APCI1711_EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex,
 		return 5;
 	}
 
-	/* send the 0xE command */
-	if (Primary_EndatSendCommand(pdev, moduleIndex, channel, 0xE, mrsCode, 0, ((0xE << 24) + (mrsCode << 16))) != 0)
-	{
-		/* timeout */
-		return 6;
-	}
+	/* the memory area is already selected (reads only, a write always selects it again) */
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] == mrsCode)
+		return 0;
 
-	error = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 13) * WINDOWS_TO_LINUX_OFFSET);
-	if ((error & 0x00000FDF) != 0)
-	{
-		return 20;
-	}
-	return 0;
+	return EndatSendMemorySelection(pdev, moduleIndex, channel, mrsCode);
 
 }
 
@@ -690,7 +872,7 @@ int i_APCI1711_EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex,
  * @retval 6 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSelectMemoryArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+static int EndatSelectMemoryArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
 {
 	const int validMrsCodeSz = 13; /* if you change this value, please also change validMrsCode definition */
 	const uint32_t validMrsCode[13] = {0xB9, 0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF, 0xB1, 0xB3, 0xB5, 0xB7};
@@ -717,7 +899,7 @@ int i_APCI1711_EndatSelectMemoryArea(struct pci_dev *pdev, uint8_t moduleIndex,
 		return 3;
 	}
 
-	if (i_APCI1711_EndatSelectMemorySpace(pdev, moduleIndex, channel, mrsCode) != 0)
+	if (EndatSelectMemorySpace(pdev, moduleIndex, channel, mrsCode) != 0)
 		return 4;
 
 	return 0;
@@ -755,7 +937,7 @@ int i_APCI1711_EndatSelectMemoryArea(struct pci_dev *pdev, uint8_t moduleIndex,
  * @retval 6 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorSendPositionAndRecvMemArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+static int EndatSensorSendPositionAndRecvMemArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
 {
 	uint32_t error = 0;
 
@@ -805,8 +987,11 @@ int i_APCI1711_EndatSensorSendPositionAndRecvMemArea(struct pci_dev *pdev, uint8
 
 	if ((error & 0x00000FDF) != 0)
 	{
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
 		return 20;
 	}
+
+	APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = mrsCode;
 	return 0;
 
 }
@@ -847,9 +1032,10 @@ int i_APCI1711_EndatSensorSendPositionAndRecvMemArea(struct pci_dev *pdev, uint8
  * @retval 8 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t *param)
+static int EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t *param)
 {
 	uint32_t error = 0;
+	int cacheArea = ParameterCacheArea(mrsCode);
 
 	const int validMrsCodeSz = 16; /* if you change this value, please also change validMrsCode definition */
 	const unsigned long validMrsCode[16] = {0xB9, 0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF, 0xB1, 0xB3, 0xB5, 0xB7, 0xBD, 0xBF, 0xBB};
@@ -896,6 +1082,14 @@ int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleInde
 		return 7;
 	}
 
+	/* return a cached parameter without using the channel */
+	if ((cacheArea >= 0) && (address < 16)
+	        && ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel][cacheArea] >> address) & 1))
+	{
+		*param = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCache[channel][cacheArea][address];
+		return 0;
+	}
+
 	/* send the 0x23 command */
 	if (Primary_EndatSendCommand(pdev, moduleIndex, channel, 0x23, mrsCode, address, ((0x23 << 24) + (address << 16))) != 0)
 	{
@@ -912,9 +1106,19 @@ int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleInde
 
 	if ((error & 0x00000FDF) != 0)
 	{
+		/* the sensor may have been reset or replaced, its memory area is unknown */
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
 		return 20;
 	}
 
+	/* cache the parameter if the answer comes from this memory area */
+	if ((cacheArea >= 0) && (address < 16)
+	        && (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] == mrsCode))
+	{
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCache[channel][cacheArea][address] = *param;
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel][cacheArea] |= (1 << address);
+	}
+
 	return 0;
 
 }
@@ -922,6 +1126,7 @@ int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleInde
 /**
  * Enable to execute the action "Sensor receive parameter" (see page 19/131 of EnDat specification)
  * The EnDat mode is 0x1C
+ * The memory area mrsCode is always selected again (0xE) before the write.
  * @param [in] pdev : Pointer to the device
  * @param [in] moduleIndex :Index of the slave (0->3)
  * @param [in] channel : Index of the EnDat channel (0,1)
@@ -951,9 +1156,10 @@ int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleInde
  * @retval 7 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t param)
+static int EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t param)
 {
 	uint32_t error = 0;
+	int cacheArea = ParameterCacheArea(mrsCode);
 
 	const int validMrsCodeSz = 13; /* if you change this value, please also change validMrsCode definition */
 	const uint32_t validMrsCode[13] = {0xB9, 0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF, 0xB1, 0xB3, 0xB5, 0xB7};
@@ -995,6 +1201,23 @@ int i_APCI1711_EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleI
 		return 6;
 	}
 
+	/* the cached value is read again from the sensor after a write */
+	if ((cacheArea >= 0) && (address < 16))
+	{
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel][cacheArea] &= ~(1 << address);
+	}
+
+	/* never write into a memory area the sensor may have left: select it again */
+	switch (EndatSendMemorySelection(pdev, moduleIndex, channel, mrsCode))
+	{
+		case 0:
+			break;
+		case 6:
+			return 7;
+		default:
+			return 20;
+	}
+
 	/* send the 0x1C command */
 	if (Primary_EndatSendCommand(pdev, moduleIndex, channel, 0x1C, mrsCode, address, ((0x1C << 24) + (address << 16)) + param) != 0)
 	{
@@ -1006,6 +1229,8 @@ int i_APCI1711_EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleI
 
 	if ((error & 0x00000FDF) != 0)
 	{
+		/* the sensor may have been reset or replaced, its memory area is unknown */
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
 		return 20;
 	}
 	return 0;
@@ -1029,7 +1254,7 @@ int i_APCI1711_EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleI
  * @retval 5 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorSendPositionValue(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t * positionLow, uint32_t * positionHigh, uint32_t * positionSz)
+static int EndatSensorSendPositionValue(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t * positionLow, uint32_t * positionHigh, uint32_t * positionSz)
 {
 	uint32_t error = 0;
 
@@ -1068,6 +1293,8 @@ int i_APCI1711_EndatSensorSendPositionValue(struct pci_dev *pdev, uint8_t module
 
 	if ((error & 0x00000FDF) != 0)
 	{
+		/* the sensor may have been reset or replaced, its memory area is unknown */
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
 		return 20;
 	}
 
@@ -1127,7 +1354,7 @@ int i_APCI1711_EndatSensorSendPositionValue(struct pci_dev *pdev, uint8_t module
  * @retval 12 Error while activating the second additional data
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSelectAdditionalData(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint8_t addInfoCount, uint32_t mrsCodeAI1, uint32_t mrsCodeAI2)
+static int EndatSelectAdditionalData(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint8_t addInfoCount, uint32_t mrsCodeAI1, uint32_t mrsCodeAI2)
 {
 	uint32_t registerContent = 0;
 	uint32_t currentAddInfoCount = 0;
@@ -1329,14 +1556,14 @@ int i_APCI1711_EndatSelectAdditionalData(struct pci_dev *pdev, uint8_t moduleInd
  * @retval 6 timeout
  * @retval 20 transmission error
  */
-int i_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pdev,
-                                                              uint8_t moduleIndex,
-                                                              uint8_t channel,
-                                                              uint32_t *positionLow,
-                                                              uint32_t *positionHigh,
-                                                              uint32_t *positionSz,
-                                                              uint32_t *addInfo1,
-                                                              uint32_t *addInfo2)
+static int EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pdev,
+                                                          uint8_t moduleIndex,
+                                                          uint8_t channel,
+                                                          uint32_t *positionLow,
+                                                          uint32_t *positionHigh,
+                                                          uint32_t *positionSz,
+                                                          uint32_t *addInfo1,
+                                                          uint32_t *addInfo2)
 {
 	uint32_t registerContent = 0;
 	uint32_t error = 0;
@@ -1387,6 +1614,8 @@ int i_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pd
 
 	if ((error & 0x00000FDF) != 0)
 	{
+		/* the sensor may have been reset or replaced, its memory area is unknown */
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
 		return 20;
 	}
 
@@ -1394,3 +1623,685 @@ int i_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pd
 
 }
 
+/**
+ * Read the parameters 0x0 - 0xF of a memory area once and keep them in the parameter cache.
+ * The following calls of i_APCI1711_EndatSensorSendParameter for these parameters
+ * are served from the memory, without using the EnDat channel.
+ * The parameters already cached are not read again. A parameter the sensor does not
+ * have (transmission error) is not cached.
+ * Writing a parameter (i_APCI1711_EndatSensorReceiveParameter) removes it from the cache,
+ * resetting the sensor (i_APCI1711_EndatSensorReceiveReset, i_APCI1711_EndatInitialiseSensor) empties the cache.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @param [in] mrsCode : The MRS-code of the memory area (0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF)
+ * @param [out] cachedMask : Bit n set: the parameter at address n is cached
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 mrsCode is incorrect
+ * @retval 4 the component is not programmed as EnDat
+ * @retval 5 the sensor is not initialised (initialise it and recall this function)
+ * @retval 6 Error while selecting the memory area
+ * @retval 7 timeout while reading a parameter
+ */
+static int EndatReadParameterArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t *cachedMask)
+{
+	int cacheArea = ParameterCacheArea(mrsCode);
+	uint32_t address = 0;
+	uint32_t param = 0;
+
+	/* check the parameters */
+	if (moduleIndex > 3)
+		return 1;
+
+	/* check the channel */
+	if (channel > 1)
+		return 2;
+
+	if (cacheArea < 0)
+		return 3;
+
+	/* confirm that the slave is configured for Endat */
+	if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != PCIE1711_ENDAT)
+		return 4;
+
+	/* check if the sensor is initialised */
+	if (IsSensorInitialised(pdev, moduleIndex, channel) != 1)
+	{
+		return 5;
+	}
+
+	/* the parameters of the first part of the encoder manufacturer begin at 0x4 */
+	for (address = ((mrsCode == 0xA1) ? 0x4 : 0x0); address < 16; address++)
+	{
+		if ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel][cacheArea] >> address) & 1)
+			continue;
+
+		/* select the memory area - only sent if another area was selected */
+		if (EndatSelectMemorySpace(pdev, moduleIndex, channel, mrsCode) != 0)
+			return 6;
+
+		/* 8: timeout, 20: the sensor does not have this parameter */
+		if (EndatSensorSendParameter(pdev, moduleIndex, channel, mrsCode, address, &param) == 8)
+			return 7;
+	}
+
+	*cachedMask = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.parameterCacheValid[channel][cacheArea];
+
+	return 0;
+}
+
+/**
+ * Acquire one position of a stream and write it in the next record.
+ * Only the acquisition thread of the channel writes the stream.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] streamInfos : The stream of the channel
+ */
+static void EndatStreamSample(struct pci_dev *pdev, str_EndatStreamInfos *streamInfos)
+{
+	str_APCI1711_EndatStream *stream = streamInfos->ps_Stream;
+	str_APCI1711_EndatStreamRecord *record = &stream->s_Record[stream->ul_Write % APCI1711_ENDAT_STREAM_SIZE];
+	uint8_t moduleIndex = streamInfos->b_ModulNbr;
+	uint8_t channel = streamInfos->b_Channel;
+	uint32_t modeCommand = (stream->ul_Mode == APCI1711_ENDAT_STREAM_ADDITIONAL_DATA) ? 0x38 : 0x07;
+
+	record->ull_TimeStamp = APCI1710_TIMESTAMP();
+
+	/* the period spaces the commands, no pause after the transmission */
+	if (EndatSendCommand(pdev, moduleIndex, channel, modeCommand, 0, 0, (modeCommand << 24), 0) != 0)
+	{
+		/* timeout */
+		record->ul_PositionLow = 0;
+		record->ul_PositionHigh = 0;
+		record->ul_AdditionalData1 = 0;
+		record->ul_AdditionalData2 = 0;
+		record->ul_ErrorBits = 0;
+		record->i_Error = APCI1711_ENDAT_STREAM_TIMEOUT;
+	}
+	else
+	{
+		record->ul_PositionLow = (uint32_t) readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 5) * WINDOWS_TO_LINUX_OFFSET);
+		record->ul_PositionHigh = (uint32_t) readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 6) * WINDOWS_TO_LINUX_OFFSET);
+
+		if (modeCommand == 0x38)
+		{
+			record->ul_AdditionalData1 = (uint32_t) (readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 9) * WINDOWS_TO_LINUX_OFFSET) & 0x1FFFFF);
+			record->ul_AdditionalData2 = (uint32_t) (readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 10) * WINDOWS_TO_LINUX_OFFSET) & 0x1FFFFF);
+		}
+		else
+		{
+			record->ul_AdditionalData1 = 0;
+			record->ul_AdditionalData2 = 0;
+		}
+
+		stream->ul_PositionSize = (uint32_t) readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 12) * WINDOWS_TO_LINUX_OFFSET);
+
+		record->ul_ErrorBits = (uint32_t) readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + ((64 * moduleIndex) + (32 * channel) + 13) * WINDOWS_TO_LINUX_OFFSET);
+		record->i_Error = ((record->ul_ErrorBits & 0x00000FDF) != 0) ? APCI1711_ENDAT_STREAM_TRANSMISSION_ERROR : 0;
+	}
+
+	if (record->i_Error != 0)
+	{
+		stream->ul_Errors++;
+		/* the sensor may have been reset or replaced, its memory area is unknown */
+		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_EndatModuleInfo.selectedMrsCode[channel] = 0;
+	}
+
+	/* the record is complete before the readers see it */
+	smp_wmb();
+	stream->ul_Write++;
+}
+
+/**
+ * Acquisition thread of a position stream.
+ * The transmission is polled, so the channel is served by a kernel thread
+ * rather than by a timer callback. The thread wakes up on an absolute
+ * deadline every period.
+ * @param [in] data : The stream of the channel (str_EndatStreamInfos)
+ */
+static int EndatStreamThread(void *data)
+{
+	str_EndatStreamInfos *streamInfos = (str_EndatStreamInfos *) data;
+	str_APCI1711_EndatStream *stream = streamInfos->ps_Stream;
+	ktime_t period = ns_to_ktime((uint64_t) stream->ul_Period * NSEC_PER_USEC);
+	ktime_t next = ktime_get();
+
+	while (!kthread_should_stop())
+	{
+		EndatStreamSample(streamInfos->pdev, streamInfos);
+
+		/* next deadline, skip the periods already missed */
+		next = ktime_add(next, period);
+		if (ktime_before(next, ktime_get()))
+		{
+			stream->ul_Overruns++;
+			next = ktime_add(ktime_get(), period);
+		}
+
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (!kthread_should_stop())
+			schedule_hrtimeout(&next, HRTIMER_MODE_ABS);
+		__set_current_state(TASK_RUNNING);
+	}
+
+	return 0;
+}
+
+/**
+ * Initialise the position streams of a new board.
+ * @param [in] pdev : Pointer to the device
+ */
+void apci1710_endat_stream_init(struct pci_dev *pdev)
+{
+	uint8_t moduleIndex = 0;
+	uint8_t channel = 0;
+
+	for (moduleIndex = 0; moduleIndex < 4; moduleIndex++)
+	{
+		for (channel = 0; channel < 2; channel++)
+		{
+			str_EndatStreamInfos *streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel];
+
+			mutex_init(&streamInfos->s_Mutex);
+			mutex_init(&streamInfos->s_ChannelLock);
+			streamInfos->pdev = pdev;
+			streamInfos->b_ModulNbr = moduleIndex;
+			streamInfos->b_Channel = channel;
+		}
+	}
+}
+
+/**
+ * Stop the acquisition threads of a board.
+ * @param [in] pdev : Pointer to the device
+ */
+void apci1710_endat_stream_stop(struct pci_dev *pdev)
+{
+	uint8_t moduleIndex = 0;
+	uint8_t channel = 0;
+
+	for (moduleIndex = 0; moduleIndex < 4; moduleIndex++)
+	{
+		for (channel = 0; channel < 2; channel++)
+		{
+			str_EndatStreamInfos *streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel];
+
+			mutex_lock(&streamInfos->s_Mutex);
+			if (streamInfos->ps_Thread)
+			{
+				kthread_stop(streamInfos->ps_Thread);
+				streamInfos->ps_Thread = NULL;
+				streamInfos->ps_Stream->ul_Period = 0;
+				EndatChannelSetStream(streamInfos, 0);
+			}
+			mutex_unlock(&streamInfos->s_Mutex);
+		}
+	}
+}
+
+/**
+ * Free the position streams of a removed board, the threads are stopped.
+ * A stream still mapped by a user is only freed with its last mapping
+ * (apci1710_mmap_lookup maps it with vm_insert_page).
+ * @param [in] pdev : Pointer to the device
+ */
+void apci1710_endat_stream_release(struct pci_dev *pdev)
+{
+	uint8_t moduleIndex = 0;
+	uint8_t channel = 0;
+
+	for (moduleIndex = 0; moduleIndex < 4; moduleIndex++)
+	{
+		for (channel = 0; channel < 2; channel++)
+		{
+			str_EndatStreamInfos *streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel];
+
+			if (streamInfos->ps_Stream == NULL)
+				continue;
+
+			free_pages((unsigned long) streamInfos->ps_Stream, streamInfos->ui_Order);
+			streamInfos->ps_Stream = NULL;
+		}
+	}
+}
+
+/**
+ * Move the acquisition threads on the worker CPUs after an affinity change.
+ * @param [in] pdev : Pointer to the device
+ */
+void apci1710_endat_stream_bind(struct pci_dev *pdev)
+{
+	uint8_t moduleIndex = 0;
+	uint8_t channel = 0;
+
+	for (moduleIndex = 0; moduleIndex < 4; moduleIndex++)
+	{
+		for (channel = 0; channel < 2; channel++)
+		{
+			str_EndatStreamInfos *streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel];
+
+			mutex_lock(&streamInfos->s_Mutex);
+			if (streamInfos->ps_Thread)
+				apci1710_worker_bind(pdev, streamInfos->ps_Thread);
+			mutex_unlock(&streamInfos->s_Mutex);
+		}
+	}
+}
+
+/**
+ * Tell if the position stream of a channel runs: the other functions of the channel return -EBUSY.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @retval 0 the stream is stopped
+ * @retval 1 the stream runs
+ */
+int apci1710_endat_stream_running(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	int running = 0;
+
+	mutex_lock(&APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].s_ChannelLock);
+	running = APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].b_Running;
+	mutex_unlock(&APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel].s_ChannelLock);
+
+	return running;
+}
+
+/**
+ * Return the position stream mapped at a page offset of the device (see APCI1710_MMAP_ENDAT_STREAM).
+ * @param [in] pdev : Pointer to the device
+ * @param [in] pageOffset : mmap page offset
+ * @param [out] size : Size of the allocated area in bytes
+ * @return The stream, NULL if the offset is not a stream or the stream was never started
+ */
+void * apci1710_endat_stream_area(struct pci_dev *pdev, unsigned long pageOffset, unsigned long *size)
+{
+	str_EndatStreamInfos *streamInfos = NULL;
+	void *area = NULL;
+
+	if ((pageOffset < APCI1710_MMAP_ENDAT_STREAM(0, 0)) || (pageOffset > APCI1710_MMAP_ENDAT_STREAM(3, 1)))
+		return NULL;
+
+	pageOffset -= APCI1710_MMAP_ENDAT_STREAM(0, 0);
+	streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[pageOffset / 2][pageOffset % 2];
+
+	mutex_lock(&streamInfos->s_Mutex);
+	area = streamInfos->ps_Stream;
+	*size = PAGE_SIZE << streamInfos->ui_Order;
+	mutex_unlock(&streamInfos->s_Mutex);
+
+	return area;
+}
+
+/**
+ * Start or stop the position stream of an EnDat channel.
+ * A kernel thread sends the position command (0x07, or 0x38 for the EnDat 2.2
+ * position with additional data) every period and writes the values with the
+ * time of the command in the stream of the channel (str_APCI1711_EndatStream),
+ * that the users map read only. A new configuration replaces the running one.
+ * While the stream runs, the other EnDat functions of the channel return -EBUSY.
+ * @warning This function sleeps, it must be called without the board lock.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @param [in] mode : APCI1711_ENDAT_STREAM_POSITION or APCI1711_ENDAT_STREAM_ADDITIONAL_DATA
+ * @param [in] period : Acquisition period in us (min APCI1711_ENDAT_STREAM_MIN_PERIOD), 0: stop the stream
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 the component is not programmed as EnDat
+ * @retval 4 mode is incorrect
+ * @retval 5 period is incorrect
+ * @retval 6 the sensor is not initialised (initialise it and recall this function)
+ * @retval 7 the sensor is not compatible with EnDat 2.2 commands
+ * @retval 8 the stream can not be allocated
+ * @retval 9 the acquisition thread can not be started
+ */
+int i_APCI1711_EndatSetPositionStream(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mode, uint32_t period)
+{
+	str_EndatStreamInfos *streamInfos = NULL;
+	int returnValue = 0;
+
+	/* check the parameters */
+	if (moduleIndex > 3)
+		return 1;
+
+	/* check the channel */
+	if (channel > 1)
+		return 2;
+
+	/* confirm that the slave is configured for Endat */
+	if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != PCIE1711_ENDAT)
+		return 3;
+
+	if (period != 0)
+	{
+		if ((mode != APCI1711_ENDAT_STREAM_POSITION) && (mode != APCI1711_ENDAT_STREAM_ADDITIONAL_DATA))
+			return 4;
+
+		if (period < APCI1711_ENDAT_STREAM_MIN_PERIOD)
+			return 5;
+
+		/* check if the sensor is initialised */
+		if (IsSensorInitialised(pdev, moduleIndex, channel) != 1)
+			return 6;
+
+		/* check if the sensor allows 2.2 command */
+		if ((mode == APCI1711_ENDAT_STREAM_ADDITIONAL_DATA) && (AllowEnDat22Command(pdev, moduleIndex, channel) != 1))
+			return 7;
+	}
+
+	streamInfos = &APCI1710_PRIVDATA(pdev)->s_EndatStream[moduleIndex][channel];
+
+	mutex_lock(&streamInfos->s_Mutex);
+
+	/* stop the running thread, the stream is then free to change */
+	if (streamInfos->ps_Thread)
+	{
+		kthread_stop(streamInfos->ps_Thread);
+		streamInfos->ps_Thread = NULL;
+		streamInfos->ps_Stream->ul_Period = 0;
+		EndatChannelSetStream(streamInfos, 0);
+	}
+
+	if (period != 0)
+	{
+		/* allocated at the first start and kept until the board is removed, as it may be mapped */
+		if (streamInfos->ps_Stream == NULL)
+		{
+			unsigned int order = get_order(sizeof(str_APCI1711_EndatStream));
+			/* compound: each page mapped with vm_insert_page holds a reference on the whole allocation */
+			struct page *page = alloc_pages_node(APCI1710_NODE(pdev), GFP_KERNEL | __GFP_ZERO | __GFP_COMP, order);
+
+			if (page != NULL)
+			{
+				streamInfos->ps_Stream = (str_APCI1711_EndatStream *) page_address(page);
+				streamInfos->ps_Stream->ul_Size = APCI1711_ENDAT_STREAM_SIZE;
+				streamInfos->ui_Order = order;
+			}
+			else
+				returnValue = 8;
+		}
+
+		if (returnValue == 0)
+		{
+			streamInfos->ps_Stream->ul_Mode = mode;
+			streamInfos->ps_Stream->ul_Period = period;
+
+			/* the thread owns the channel, the other functions return -EBUSY */
+			EndatChannelSetStream(streamInfos, 1);
+
+			streamInfos->ps_Thread = apci1710_worker_run(pdev, EndatStreamThread, streamInfos, "apci1710-endat");
+			if (IS_ERR(streamInfos->ps_Thread))
+			{
+				streamInfos->ps_Thread = NULL;
+				streamInfos->ps_Stream->ul_Period = 0;
+				EndatChannelSetStream(streamInfos, 0);
+				returnValue = 9;
+			}
+		}
+	}
+
+	mutex_unlock(&streamInfos->s_Mutex);
+
+	return returnValue;
+}
+
+/*
+ * Exported functions: each one takes the channel for its whole execution.
+ */
+
+/**
+ * See EndatInitialiseSensor, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatInitialiseSensor(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t freqValue)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatInitialiseSensor(pdev, moduleIndex, channel, freqValue);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorReceiveReset, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorReceiveReset(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorReceiveReset(pdev, moduleIndex, channel);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatResetErrorBits, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatResetErrorBits(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatResetErrorBits(pdev, moduleIndex, channel);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatGetErrorSources, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatGetErrorSources(struct pci_dev *pdev,
+                                    uint8_t moduleIndex,
+                                    uint8_t channel,
+                                    uint8_t *errorSrc1,
+                                    uint8_t *errorSrc2,
+                                    uint8_t *errorSrc3,
+                                    uint8_t *errorSrc4,
+                                    uint8_t *errorSrc7,
+                                    uint8_t *errorSrc8,
+                                    uint8_t *errorSrc9,
+                                    uint8_t *errorSrc10,
+                                    uint8_t *errorSrc11,
+                                    uint8_t *errorSrc12,
+                                    uint8_t *errorSrc13)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatGetErrorSources(pdev, moduleIndex, channel, errorSrc1, errorSrc2, errorSrc3, errorSrc4, errorSrc7, errorSrc8, errorSrc9, errorSrc10, errorSrc11, errorSrc12, errorSrc13);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSelectMemorySpace, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSelectMemorySpace(pdev, moduleIndex, channel, mrsCode);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSelectMemoryArea, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSelectMemoryArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSelectMemoryArea(pdev, moduleIndex, channel, mrsCode);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorSendPositionAndRecvMemArea, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorSendPositionAndRecvMemArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorSendPositionAndRecvMemArea(pdev, moduleIndex, channel, mrsCode);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorSendParameter, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t *param)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorSendParameter(pdev, moduleIndex, channel, mrsCode, address, param);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorReceiveParameter, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorReceiveParameter(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t address, uint32_t param)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorReceiveParameter(pdev, moduleIndex, channel, mrsCode, address, param);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorSendPositionValue, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorSendPositionValue(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t * positionLow, uint32_t * positionHigh, uint32_t * positionSz)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorSendPositionValue(pdev, moduleIndex, channel, positionLow, positionHigh, positionSz);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSelectAdditionalData, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSelectAdditionalData(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint8_t addInfoCount, uint32_t mrsCodeAI1, uint32_t mrsCodeAI2)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSelectAdditionalData(pdev, moduleIndex, channel, addInfoCount, mrsCodeAI1, mrsCodeAI2);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatSensorSendPositionValueWithAdditionalData, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pdev,
+                                                              uint8_t moduleIndex,
+                                                              uint8_t channel,
+                                                              uint32_t *positionLow,
+                                                              uint32_t *positionHigh,
+                                                              uint32_t *positionSz,
+                                                              uint32_t *addInfo1,
+                                                              uint32_t *addInfo2)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatSensorSendPositionValueWithAdditionalData(pdev, moduleIndex, channel, positionLow, positionHigh, positionSz, addInfo1, addInfo2);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
+
+/**
+ * See EndatReadParameterArea, the channel is taken for the whole function.
+ * @retval -EBUSY the position stream of the channel is running
+ */
+int i_APCI1711_EndatReadParameterArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t *cachedMask)
+{
+	int returnValue = EndatChannelTake(pdev, moduleIndex, channel);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	returnValue = EndatReadParameterArea(pdev, moduleIndex, channel, mrsCode, cachedMask);
+
+	EndatChannelRelease(pdev, moduleIndex, channel);
+
+	return returnValue;
+}
@@ -583,3 +583,82 @@ int do_CMD_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_de
 
 }
 
+/**
+ * Read the parameters 0x0 - 0xF of a memory area once and keep them in the parameter cache.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] arg[0] (moduleIndex) : Index of the slave (0->3)
+ * @param [in] arg[1] (channel) : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mrsCode) : The MRS-code of the memory area (0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF)
+ * @param [out] arg[3] (cachedMask) : Bit n set: the parameter at address n is cached
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 mrsCode is incorrect
+ * @retval 4 the component is not programmed as EnDat
+ * @retval 5 the sensor is not initialised (initialise it and recall this function)
+ * @retval 6 Error while selecting the memory area
+ * @retval 7 timeout while reading a parameter
+ * @retval -EFAULT : Fail to retrieve or write user data
+ */
+int do_CMD_APCI1711_EndatReadParameterArea(struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int returnValue = 0;
+	uint32_t argArray[4] = {0};
+
+	if (copy_from_user(argArray, (uint32_t __user *)arg, sizeof(argArray)))
+		return -EFAULT;
+
+	if (pdev->device != apcie1711_BOARD_DEVICE_ID)
+		return -ENOSYS;
+
+	returnValue = i_APCI1711_EndatReadParameterArea(pdev,
+	                                                (uint8_t) argArray[0], // moduleIndex
+	                                                (uint8_t) argArray[1], // channel
+	                                                argArray[2],           // mrsCode
+	                                                &argArray[3]);         // cachedMask
+
+	if (returnValue != 0)
+		return returnValue;
+
+	if (copy_to_user((uint32_t __user *)arg, argArray, sizeof(argArray)))
+		return -EFAULT;
+
+	return 0;
+}
+
+/**
+ * Start or stop the position stream of an EnDat channel.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] arg[0] (moduleIndex) : Index of the slave (0->3)
+ * @param [in] arg[1] (channel) : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mode) : APCI1711_ENDAT_STREAM_POSITION or APCI1711_ENDAT_STREAM_ADDITIONAL_DATA
+ * @param [in] arg[3] (period) : Acquisition period in us (min APCI1711_ENDAT_STREAM_MIN_PERIOD), 0: stop the stream
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 the component is not programmed as EnDat
+ * @retval 4 mode is incorrect
+ * @retval 5 period is incorrect
+ * @retval 6 the sensor is not initialised (initialise it and recall this function)
+ * @retval 7 the sensor is not compatible with EnDat 2.2 commands
+ * @retval 8 the stream can not be allocated
+ * @retval 9 the acquisition thread can not be started
+ * @retval -EFAULT : Fail to retrieve user data
+ */
+int do_CMD_APCI1711_EndatSetPositionStream(struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	uint32_t argArray[4] = {0};
+
+	if (copy_from_user(argArray, (uint32_t __user *)arg, sizeof(argArray)))
+		return -EFAULT;
+
+	if (pdev->device != apcie1711_BOARD_DEVICE_ID)
+		return -ENOSYS;
+
+	/* the function sleeps, it locks what it needs itself */
+	return i_APCI1711_EndatSetPositionStream(pdev,
+	                                         (uint8_t) argArray[0], // moduleIndex
+	                                         (uint8_t) argArray[1], // channel
+	                                         argArray[2],           // mode
+	                                         argArray[3]);          // period
+}
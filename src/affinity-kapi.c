@@ -0,0 +1,330 @@
+/** @file affinity-kapi.c
+ 
+   NUMA node and CPU affinity of a board (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_SetBoardAffinity);
+EXPORT_SYMBOL(i_APCI1710_GetBoardAffinity);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Return the CPUs of the NUMA node of a board, all the CPUs if unknown. */
+static const struct cpumask * ps_APCI1710_NodeCpumask (struct pci_dev *pdev)
+	{
+	int i_Node = APCI1710_NODE(pdev);
+
+	if ((i_Node >= 0) && !cpumask_empty (cpumask_of_node (i_Node)))
+		return cpumask_of_node (i_Node);
+
+	return cpu_possible_mask;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Convert a user mask, an empty mask selects the CPUs of the board node. */
+static void v_APCI1710_MaskToCpumask (struct pci_dev *pdev,
+                                      const uint64_t * pull_Mask,
+                                      struct cpumask * ps_Mask)
+	{
+	unsigned int ui_Cpu;
+
+	cpumask_clear (ps_Mask);
+
+	for (ui_Cpu = 0; (ui_Cpu < APCI1710_AFFINITY_MAX_CPUS) && (ui_Cpu < nr_cpu_ids); ui_Cpu++)
+		if ((pull_Mask[ui_Cpu / 64] >> (ui_Cpu % 64)) & 1)
+			cpumask_set_cpu (ui_Cpu, ps_Mask);
+
+	if (cpumask_empty (ps_Mask))
+		cpumask_copy (ps_Mask, ps_APCI1710_NodeCpumask (pdev));
+	}
+
+//------------------------------------------------------------------------------
+
+/** Convert a cpumask in a user mask. */
+static void v_APCI1710_CpumaskToMask (const struct cpumask * ps_Mask,
+                                      uint64_t * pull_Mask)
+	{
+	unsigned int ui_Cpu;
+
+	memset (pull_Mask, 0, (APCI1710_AFFINITY_MAX_CPUS / 64) * sizeof (uint64_t));
+
+	for_each_cpu (ui_Cpu, ps_Mask)
+		if (ui_Cpu < APCI1710_AFFINITY_MAX_CPUS)
+			pull_Mask[ui_Cpu / 64] |= 1ULL << (ui_Cpu % 64);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Set the affinity of the interrupt line, NULL removes the hint.
+ *
+ * The mask is kept by the IRQ core, it must stay valid until removed.
+ * Before 5.17, some kernels only publish the mask as a hint for irqbalance.
+ */
+static int i_APCI1710_SetIrqAffinity (unsigned int ui_Irq, const struct cpumask * ps_Mask)
+	{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,17,0)
+	return irq_set_affinity_and_hint (ui_Irq, ps_Mask);
+#elif LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,35)
+	return irq_set_affinity_hint (ui_Irq, ps_Mask);
+#else
+	return -ENOSYS;
+#endif
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return 1 if the interrupt line of the board may be shared.
+ *
+ * The INTx line is requested with IRQF_SHARED and other devices may use it,
+ * its affinity would move their interrupts too. Only a MSI vector is ours.
+ */
+static int i_APCI1710_IrqShared (struct pci_dev *pdev)
+	{
+	return !(pdev->msi_enabled || pdev->msix_enabled);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the affinity of a new board: the worker threads run on its node. */
+void apci1710_affinity_init (struct pci_dev *pdev)
+	{
+	str_AffinityInfos * ps_Affinity = &(APCI1710_PRIVDATA(pdev)->s_Affinity);
+
+	mutex_init (&ps_Affinity->s_Mutex);
+	cpumask_clear (&ps_Affinity->s_IrqMask);
+	cpumask_copy (&ps_Affinity->s_WorkerMask, ps_APCI1710_NodeCpumask (pdev));
+	ps_Affinity->ul_Flags = 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Remove the interrupt affinity hint of a removed board.
+ * Must be called before the interrupt handler is freed.
+ */
+void apci1710_affinity_release (struct pci_dev *pdev)
+	{
+	str_AffinityInfos * ps_Affinity = &(APCI1710_PRIVDATA(pdev)->s_Affinity);
+
+	mutex_lock (&ps_Affinity->s_Mutex);
+	if (ps_Affinity->ul_Flags & APCI1710_AFFINITY_IRQ)
+		{
+		i_APCI1710_SetIrqAffinity (pdev->irq, NULL);
+		ps_Affinity->ul_Flags &= ~APCI1710_AFFINITY_IRQ;
+		}
+	mutex_unlock (&ps_Affinity->s_Mutex);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Move a kernel thread of a board on the worker CPUs. */
+void apci1710_worker_bind (struct pci_dev *pdev, struct task_struct * ps_Thread)
+	{
+	str_AffinityInfos * ps_Affinity = &(APCI1710_PRIVDATA(pdev)->s_Affinity);
+
+	mutex_lock (&ps_Affinity->s_Mutex);
+	set_cpus_allowed_ptr (ps_Thread, &ps_Affinity->s_WorkerMask);
+	mutex_unlock (&ps_Affinity->s_Mutex);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Start a kernel thread of a board.
+ *
+ * The thread structures are allocated on the node of the board and
+ * the thread runs on the worker CPUs. It is named "<name>/<PCI slot>".
+ *
+ * @param [in] pdev                  : The device.
+ * @param [in] threadfn              : The thread function.
+ * @param [in] data                  : Passed to threadfn.
+ * @param [in] name                  : The thread name.
+ *
+ * @return The thread, or an ERR_PTR.
+ */
+struct task_struct * apci1710_worker_run (struct pci_dev *pdev, int (*threadfn)(void *data), void * data, const char * name)
+	{
+	struct task_struct * ps_Thread;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3,2,0)
+	ps_Thread = kthread_create_on_node (threadfn, data, APCI1710_NODE(pdev), "%s/%s", name, pci_name (pdev));
+#else
+	ps_Thread = kthread_create (threadfn, data, "%s/%s", name, pci_name (pdev));
+#endif
+	if (IS_ERR (ps_Thread))
+		return ps_Thread;
+
+	apci1710_worker_bind (pdev, ps_Thread);
+	wake_up_process (ps_Thread);
+
+	return ps_Thread;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Set the CPUs serving the interrupt and the kernel threads of a board.
+ *
+ * See CMD_APCI1710_SetBoardAffinity.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Config             : The masks to set.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Flags is wrong.
+ * @retval 3: A mask selects no online CPU.
+ * @retval 4: The interrupt affinity can not be set, the previous one is removed.
+ * @retval 5: The interrupt line is a shared INTx line, nothing is changed.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int i_APCI1710_SetBoardAffinity (struct pci_dev *pdev,
+                                 const str_APCI1710_Affinity * ps_Config)
+	{
+	str_AffinityInfos * ps_Affinity = NULL;
+	cpumask_var_t s_IrqMask;
+	cpumask_var_t s_WorkerMask;
+	int i_ReturnValue = 0;
+
+	if (!pdev)
+		return 1;
+
+	if ((ps_Config->ul_Flags == 0) ||
+	    (ps_Config->ul_Flags & ~(APCI1710_AFFINITY_IRQ | APCI1710_AFFINITY_WORKER)))
+		return 2;
+
+	if ((ps_Config->ul_Flags & APCI1710_AFFINITY_IRQ) && i_APCI1710_IrqShared (pdev))
+		return 5;
+
+	if (!zalloc_cpumask_var (&s_IrqMask, GFP_KERNEL))
+		return -ENOMEM;
+
+	if (!zalloc_cpumask_var (&s_WorkerMask, GFP_KERNEL))
+		{
+		free_cpumask_var (s_IrqMask);
+		return -ENOMEM;
+		}
+
+	v_APCI1710_MaskToCpumask (pdev, ps_Config->ull_IrqCpuMask, s_IrqMask);
+	v_APCI1710_MaskToCpumask (pdev, ps_Config->ull_WorkerCpuMask, s_WorkerMask);
+
+	if (((ps_Config->ul_Flags & APCI1710_AFFINITY_IRQ) && !cpumask_intersects (s_IrqMask, cpu_online_mask)) ||
+	    ((ps_Config->ul_Flags & APCI1710_AFFINITY_WORKER) && !cpumask_intersects (s_WorkerMask, cpu_online_mask)))
+		{
+		free_cpumask_var (s_WorkerMask);
+		free_cpumask_var (s_IrqMask);
+		return 3;
+		}
+
+	ps_Affinity = &(APCI1710_PRIVDATA(pdev)->s_Affinity);
+
+	mutex_lock (&ps_Affinity->s_Mutex);
+
+	if (ps_Config->ul_Flags & APCI1710_AFFINITY_WORKER)
+		{
+		cpumask_copy (&ps_Affinity->s_WorkerMask, s_WorkerMask);
+		ps_Affinity->ul_Flags |= APCI1710_AFFINITY_WORKER;
+		}
+
+	if (ps_Config->ul_Flags & APCI1710_AFFINITY_IRQ)
+		{
+		cpumask_copy (&ps_Affinity->s_IrqMask, s_IrqMask);
+		ps_Affinity->ul_Flags |= APCI1710_AFFINITY_IRQ;
+
+		if (i_APCI1710_SetIrqAffinity (pdev->irq, &ps_Affinity->s_IrqMask))
+			{
+			i_APCI1710_SetIrqAffinity (pdev->irq, NULL);
+			cpumask_clear (&ps_Affinity->s_IrqMask);
+			ps_Affinity->ul_Flags &= ~APCI1710_AFFINITY_IRQ;
+			i_ReturnValue = 4;
+			}
+		}
+
+	mutex_unlock (&ps_Affinity->s_Mutex);
+
+	free_cpumask_var (s_WorkerMask);
+	free_cpumask_var (s_IrqMask);
+
+	/* Move the running threads */
+	if (ps_Config->ul_Flags & APCI1710_AFFINITY_WORKER)
+		{
+		apci1710_position_compare_bind (pdev);
+		apci1710_endat_stream_bind (pdev);
+		}
+
+	return i_ReturnValue;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return the NUMA node and the CPU affinity of a board.
+ *
+ * See CMD_APCI1710_GetBoardAffinity.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Config            : The affinity.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_GetBoardAffinity (struct pci_dev *pdev,
+                                 str_APCI1710_Affinity * ps_Config)
+	{
+	str_AffinityInfos * ps_Affinity = NULL;
+
+	if (!pdev)
+		return 1;
+
+	ps_Affinity = &(APCI1710_PRIVDATA(pdev)->s_Affinity);
+
+	mutex_lock (&ps_Affinity->s_Mutex);
+
+	ps_Config->ul_Flags = ps_Affinity->ul_Flags;
+	ps_Config->l_Node   = APCI1710_NODE(pdev);
+	v_APCI1710_CpumaskToMask (&ps_Affinity->s_IrqMask, ps_Config->ull_IrqCpuMask);
+	v_APCI1710_CpumaskToMask (&ps_Affinity->s_WorkerMask, ps_Config->ull_WorkerCpuMask);
+
+	mutex_unlock (&ps_Affinity->s_Mutex);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
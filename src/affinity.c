@@ -0,0 +1,98 @@
+/** @file affinity.c
+ 
+   NUMA node and CPU affinity of a board (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Set the CPUs serving the interrupt and the kernel threads of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_Affinity) : The masks to set.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Flags is wrong.
+ * @retval 3: A mask selects no online CPU.
+ * @retval 4: The interrupt affinity can not be set.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_SetBoardAffinity (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_Affinity s_Affinity;
+
+	if ( copy_from_user(&s_Affinity, (str_APCI1710_Affinity __user *)arg, sizeof(str_APCI1710_Affinity) ) )
+		return -EFAULT;
+
+	/* Sleeps: called without the board lock */
+	return i_APCI1710_SetBoardAffinity (pdev, &s_Affinity);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the NUMA node and the CPU affinity of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_Affinity) : The affinity.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_GetBoardAffinity (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_Affinity s_Affinity;
+
+	i_APCI1710_GetBoardAffinity (pdev, &s_Affinity);
+
+	if ( copy_to_user( (str_APCI1710_Affinity __user *)arg, &s_Affinity, sizeof(str_APCI1710_Affinity) ) )
+		return -EFAULT;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
@@ -272,6 +272,41 @@ int   i_APCI1710_SetDigitalIOPortOff (struct pci_dev *pdev,
 
 //------------------------------------------------------------------------------
 
+/** Set and reset outputs of several digital I/O and TTL I/O modules at once.
+ *
+ * For each selected module, the outputs of ul_SetMask are set high and the
+ * outputs of ul_ClearMask are set low, the other outputs keep their state.
+ * All modules are tested before the first write, so on error no output
+ * is changed.
+ *
+ * The digital I/O channels are the bits of the port value
+ * (bit 0: H, bit 1: A, bit 2: B). If the digital output memory is off,
+ * the other outputs are set to "0" like with "i_APCI1710_SetDigitalIOPortOn".
+ * The TTL I/O channels are the bits of the port register, see
+ * APCI1710_TTL_PORT_A_MASK (bits 0-7: PA, bits 8-15: PB, bits 16-23: PC,
+ * bits 24-25: PD0-PD1).
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModuleMask          : Modules to write (bit n set: module n).
+ * @param [in] ul_SetMask            : Outputs to set, for each module.
+ * @param [in] ul_ClearMask          : Outputs to reset, for each module.
+ *
+ * @retval 0: No error.
+ * @retval 1: parameter pdev is NULL.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not a digital I/O or TTL I/O module.
+ * @retval 4: A mask is wrong (channel not available or set and reset at once).
+ * @retval 5: A selected module is not initialised.
+ * @retval 6: A selected channel is used for input.
+ * @retval 7: Digital Output Memory OFF and outputs to reset. Use previously the function "i_APCI1710_SetDigitalIOMemoryOn".
+ */
+int   i_APCI1710_SetDigitalOutputsMasked (struct pci_dev *pdev,
+                                          uint8_t b_ModuleMask,
+                                          const uint32_t ul_SetMask[4],
+                                          const uint32_t ul_ClearMask[4]);
+
+//------------------------------------------------------------------------------
+
 /** Initialize the counter.
  *
  * Configure the counter operating mode from selected module (b_ModulNbr).
@@ -543,6 +578,8 @@ int i_APCI1710_SetInputFilter (struct pci_dev *pdev,
  *
  * Latch the value from selected module (b_ModulNbr)
  * in to the selected latch register (b_LatchReg).
+ * A latch into register 0 keeps the value cache sampler, the counter
+ * extension sampler and the boards snapshot off the module until the register is read with i_APCI1710_ReadLatchRegisterValue.
  *
  * @param [in] pdev          : The device to initialize.
  * @param [in] b_ModulNbr    : Module number to configure (0 to 3).
@@ -1355,6 +1392,32 @@ int i_APCI1710_SetTTLIOChlOff (struct pci_dev *pdev,
 
 //------------------------------------------------------------------------------
 
+/** Read all ports of all initialised TTL I/O modules of the board.
+ *
+ * Each module is read with one access to its port register. The value
+ * is returned with the layout of the port register (see
+ * APCI1710_TTL_PORT_A_MASK), like the masks of
+ * i_APCI1710_SetDigitalOutputsMasked, together with the mask of the channels configured
+ * as input at "i_APCI1710_InitTTLIO" / "i_APCI1710_InitTTLIODirection" time.
+ * The other bits of the value are the state of the outputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] pb_ModuleMask        : Modules read (bit n set: module n).
+ * @param [out] pul_PortValue        : Port register of each module (0 for modules not read).
+ * @param [out] pul_InputMask        : Input channels of each module (0 for modules not read).
+ *
+ * @retval 0: No error.
+ * @retval 1: parameter pdev is NULL.
+ * @retval 2: No initialised TTL I/O module on this board.
+ */
+int i_APCI1710_ReadTTLIOAllPortValues (struct pci_dev *pdev,
+                                       uint8_t * pb_ModuleMask,
+                                       uint32_t pul_PortValue[4],
+                                       uint32_t pul_InputMask[4]);
+
+//------------------------------------------------------------------------------
+
 /** Initialize SSI.
  *
  * Configure the SSI operating mode from selected module
@@ -1864,6 +1927,99 @@ int   i_APCI1710_WritePulseEncoderValue (struct pci_dev *pdev,
                                          uint32_t      ul_WriteValue);
 
 
+//------------------------------------------------------------------------------
+
+/** Queue start values for a pulse encoder.
+ *
+ * Each underflow interrupt of the pulse encoder writes the next queued value
+ * as new start value. The pulse encoder must be enabled in
+ * APCI1710_CONTINUOUS mode with its interrupt.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ * @param [in] pul_Values        : Start values to queue (> 1).
+ * @param [in] ul_Count          : Number of values (1 to APCI1710_PULSE_ENCODER_QUEUE_SIZE).
+ *
+ * @param [out] pul_Queued       : Number of values queued, less than ul_Count
+ *                                 if the queue is full.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval 5: The number of values or a value is wrong.
+ */
+int   i_APCI1710_QueuePulseEncoderValues (struct pci_dev *pdev,
+                                          uint8_t        b_ModulNbr,
+                                          uint8_t        b_PulseEncoderNbr,
+                                          const uint32_t * pul_Values,
+                                          uint32_t       ul_Count,
+                                          uint32_t     * pul_Queued);
+
+//------------------------------------------------------------------------------
+
+/** Read the state of the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ *
+ * @param [out] pul_Pending      : Number of values still queued.
+ * @param [out] pul_Underruns    : Number of interrupts which found the queue
+ *                                 empty since the last call.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ */
+int   i_APCI1710_GetPulseEncoderQueueStatus (struct pci_dev *pdev,
+                                             uint8_t        b_ModulNbr,
+                                             uint8_t        b_PulseEncoderNbr,
+                                             uint32_t     * pul_Pending,
+                                             uint32_t     * pul_Underruns);
+
+//------------------------------------------------------------------------------
+
+/** Empty the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ */
+int   i_APCI1710_ClearPulseEncoderQueue (struct pci_dev *pdev,
+                                         uint8_t        b_ModulNbr,
+                                         uint8_t        b_PulseEncoderNbr);
+
+//------------------------------------------------------------------------------
+
+/** Read the value and status of all initialised pulse encoders of the board.
+ *
+ * The status of the returned pulse encoders is cleared like by
+ * i_APCI1710_ReadPulseEncoderStatus.
+ *
+ * @param [in] pdev              : The device to use.
+ *
+ * @param [out] ps_Values        : Values and status, bit (4 * module + encoder)
+ *                                 of the masks selects a pulse encoder.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised pulse encoder on this board.
+ */
+int   i_APCI1710_ReadAllPulseEncoderValues (struct pci_dev *pdev,
+                                            str_APCI1710_PulseEncoderValues * ps_Values);
+
+
 //------------------------------------------------------------------------------
 
 /** Set the digital output H on.
@@ -2213,6 +2369,78 @@ int i_APCI1710_ReadChronoPortValue (struct pci_dev *pdev,
 								   uint8_t b_ModulNbr,
 								   uint8_t *pb_PortValue);
 
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the measurements of a chronometer.
+ *
+ * The stream and the statistics of the module are restarted.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] b_Flags                : Combination of APCI1710_CHRONO_STREAM,
+ *                                      APCI1710_CHRONO_STATISTICS and
+ *                                      APCI1710_CHRONO_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: Chronometer not initialised see function "i_APCI1710_InitChrono".
+ * @retval 5: The flags are wrong.
+ */
+int i_APCI1710_SetChronoStream (struct pci_dev *pdev,
+								uint8_t b_ModulNbr,
+								uint8_t b_Flags);
+
+//------------------------------------------------------------------------------
+
+/** Read the measured values stored in the stream of a chronometer.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] ul_MaxCount            : Size of pul_Values (1 to APCI1710_CHRONO_STREAM_SIZE).
+ *
+ * @param [out] pul_Count             : Number of values read.
+ * @param [out] pul_Lost              : Values dropped since the last read.
+ * @param [out] pul_Values            : Raw measured values, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The stream is not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval 5: ul_MaxCount is wrong.
+ */
+int i_APCI1710_ReadChronoStream (struct pci_dev *pdev,
+								 uint8_t b_ModulNbr,
+								 uint32_t ul_MaxCount,
+								 uint32_t *pul_Count,
+								 uint32_t *pul_Lost,
+								 uint32_t *pul_Values);
+
+//------------------------------------------------------------------------------
+
+/** Read the statistics of a chronometer.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] b_Reset                : 1: restart the statistics after the read.
+ *
+ * @param [out] ps_Statistics         : The statistics, in the timing unit of
+ *                                      "i_APCI1710_InitChrono". The variance
+ *                                      saturates, see str_APCI1710_ChronoStatistics.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The statistics are not enabled see function "i_APCI1710_SetChronoStream".
+ */
+int i_APCI1710_GetChronoStatistics (struct pci_dev *pdev,
+									uint8_t b_ModulNbr,
+									uint8_t b_Reset,
+									str_APCI1710_ChronoStatistics *ps_Statistics);
+
 //----------------------------------------------------------------------------
 
 /** Get the board type.
@@ -2274,6 +2502,9 @@ int   i_APCI1710_SetBaliseTelegram (struct pci_dev *pdev,
 //----------------------------------------------------------------------------
 
 /* Initialize ETM functionality.
+ *
+ * The capture rings and the aggregates of both ETMs are restarted,
+ * see function "i_APCI1710_SetETMCapture".
  *
  * @param [in] pdev                  : The device to use.
  * @param [in] b_ModulNbr            : Module number to configure (0 to 3).
@@ -2525,6 +2756,85 @@ int	i_APCI1710_ReadETMTotalTime	(struct pci_dev *pdev,
 
 //----------------------------------------------------------------------------
 
+/** Select what the interrupt routine does with the interrupts of an ETM.
+ *
+ * The capture ring and the aggregates of the ETM are restarted.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] b_Flags               : Combination of APCI1710_ETM_CAPTURE_RING,
+ *                                     APCI1710_ETM_CAPTURE_STATISTICS and
+ *                                     APCI1710_ETM_CAPTURE_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: ETM not initialised, see function "i_APCI1710_InitETM"
+ * @retval 6: The flags are wrong
+ */
+int	i_APCI1710_SetETMCapture	(struct pci_dev *pdev,
+					 uint8_t b_ModulNbr,
+					 uint8_t b_ETM,
+					 uint8_t b_Flags);
+
+//----------------------------------------------------------------------------
+
+/** Read the records stored in the capture ring of an ETM.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] ul_MaxCount           : Size of ps_Records (1 to APCI1710_ETM_CAPTURE_SIZE).
+ *
+ * @param [out] pul_Count            : Number of records read.
+ * @param [out] pul_Lost             : Records dropped since the last read.
+ * @param [out] ps_Records           : Records, oldest first.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: The capture ring is not enabled, see function "i_APCI1710_SetETMCapture"
+ * @retval 6: ul_MaxCount is wrong
+ */
+int	i_APCI1710_ReadETMCapture	(struct pci_dev *pdev,
+					 uint8_t b_ModulNbr,
+					 uint8_t b_ETM,
+					 uint32_t ul_MaxCount,
+					 uint32_t *pul_Count,
+					 uint32_t *pul_Lost,
+					 str_APCI1710_ETMCaptureRecord *ps_Records);
+
+//----------------------------------------------------------------------------
+
+/** Read the aggregates of an ETM.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] b_Reset               : 1: restart the aggregates after the read.
+ *
+ * @param [out] ps_Statistics        : The aggregates.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: The aggregates are not enabled, see function "i_APCI1710_SetETMCapture"
+ */
+int	i_APCI1710_GetETMCaptureStatistics	(struct pci_dev *pdev,
+						 uint8_t b_ModulNbr,
+						 uint8_t b_ETM,
+						 uint8_t b_Reset,
+						 str_APCI1710_ETMCaptureStatistics *ps_Statistics);
+
+//----------------------------------------------------------------------------
+
 /** Disable the IDV interrupt.
  *
  * @param [in] pdev                  : The device to initialize.
@@ -2735,9 +3045,42 @@ int i_APCI1711_BissMasterSingleCycleRegisterWrite(struct  pci_dev *pdev,
  */
 int i_APCI1711_BissMasterReleaseSingleCycle(struct pci_dev *pdev, uint8_t moduleIndex);
 
+/** Do several register reads and writes on the slaves of a module in one operation
+ * The transfers are done in the order of the list, the lock is released between two transfers.
+ * The static registers are returned from the register cache.
+ * The first failing transfer stops the operation.
+ * @param[in] deviceData                Pointer to the device
+ * @param[in,out] transfers             The transfers; i_Error, b_Data (reads), ul_Done and ul_CacheHits are returned
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid number of transfers
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval 5 : A transfer failed, see its i_Error. The following transfers are not done (i_Error -1)
+ */
+int i_APCI1711_BissMasterRegisterTransfer(struct pci_dev *pdev, str_APCI1710_BissRegisterTransfers *transfers);
+
+/** Declare the static registers of a slave, that are read once and then returned from the register cache.
+ * @param[in] deviceData                Pointer to the device
+ * @param[in] moduleIndex               Index of the slave (0->3)
+ * @param[in] slaveIndex                index of the slave(sensor) (depend of the index by the initialisation)
+ * @param[in] staticMask                bit n (staticMask[n / 32], bit n % 32) set: the register n is static
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ */
+int i_APCI1711_BissMasterSetStaticRegisters(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, const uint32_t staticMask[4]);
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
+/* EnDat: the functions of a channel take it for their whole execution, they
+ * sleep while another function uses it and return -EBUSY while the position
+ * stream of the channel runs (see i_APCI1711_EndatSetPositionStream).
+ * They must be called without the board lock.
+ */
 
 /** Initialise Initialises the EnDat sensor.
  * @param[in] deviceData		Pointer to the device
@@ -2933,6 +3276,7 @@ int i_APCI1711_EndatSensorSendParameter(struct pci_dev *pdev, uint8_t moduleInde
 /**
 * Enable to execute the action "Sensor receive parameter" (see page 19/131 of EnDat specification)
 * The EnDat mode is 0x1C
+* The memory area mrsCode is always selected again (0xE) before the write.
 * @param deviceData    Pointer to the device
 * @param moduleIndex   Index of the slave (0->3)
 * @param channel               Index of the EnDat channel (0,1)
@@ -3096,6 +3440,52 @@ int i_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pd
  * @retval 20 transmission error
  */
 int i_APCI1711_EndatSelectMemorySpace(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode);
+
+/**
+ * Read the parameters 0x0 - 0xF of a memory area once and keep them in the parameter cache.
+ * The following calls of i_APCI1711_EndatSensorSendParameter for these parameters
+ * are served from the memory, without using the EnDat channel.
+ * Writing a parameter removes it from the cache, resetting the sensor empties the cache.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @param [in] mrsCode : The MRS-code of the memory area (0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF)
+ * @param [out] cachedMask : Bit n set: the parameter at address n is cached
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 mrsCode is incorrect
+ * @retval 4 the component is not programmed as EnDat
+ * @retval 5 the sensor is not initialised (initialise it and recall this function)
+ * @retval 6 Error while selecting the memory area
+ * @retval 7 timeout while reading a parameter
+ */
+int i_APCI1711_EndatReadParameterArea(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mrsCode, uint32_t *cachedMask);
+
+/**
+ * Start or stop the position stream of an EnDat channel.
+ * A kernel thread sends the position command (0x07, or 0x38 for the EnDat 2.2
+ * position with additional data) every period and writes the values with the
+ * time of the command in the stream of the channel (str_APCI1711_EndatStream).
+ * While the stream runs, the other EnDat functions of the channel return -EBUSY.
+ * @warning This function sleeps, it must be called without the board lock.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] moduleIndex : Index of the slave (0->3)
+ * @param [in] channel : Index of the EnDat channel (0,1)
+ * @param [in] mode : APCI1711_ENDAT_STREAM_POSITION or APCI1711_ENDAT_STREAM_ADDITIONAL_DATA
+ * @param [in] period : Acquisition period in us (min APCI1711_ENDAT_STREAM_MIN_PERIOD), 0: stop the stream
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 the component is not programmed as EnDat
+ * @retval 4 mode is incorrect
+ * @retval 5 period is incorrect
+ * @retval 6 the sensor is not initialised (initialise it and recall this function)
+ * @retval 7 the sensor is not compatible with EnDat 2.2 commands
+ * @retval 8 the stream can not be allocated
+ * @retval 9 the acquisition thread can not be started
+ */
+int i_APCI1711_EndatSetPositionStream(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t mode, uint32_t period);
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
@@ -3170,9 +3560,456 @@ int i_APCI1710_ELDisableTimers (struct pci_dev *pdev, uint8_t b_ModulNbr);
  */
 int i_APCI1710_ELSetNewTimerValue (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_TimerNbr, uint32_t dw_Time);
 
+//----------------------------------------------------------------------------
+
+/** Return the latest values of the board.
+ *
+ * Lock free: this function does not lock the board and does not access
+ * the hardware. It can be called with or without the board lock.
+ *
+ * @param [in] pdev                : The device to use.
+ *
+ * @param [out] ps_Values          : Coherent copy of the value cache.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadValueCache (struct pci_dev *pdev, str_APCI1710_ValueCache * ps_Values);
+
+/** Start or stop the kernel sampler of the value cache.
+ *
+ * See CMD_APCI1710_SetValueCacheSampler. A counter whose latch register 0
+ * is used by the application is not sampled (see i_APCI1710_LatchCounter).
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                : The device to use.
+ * @param [in] b_ModuleMask        : Modules to sample (bit n set: module n).
+ * @param [in] ul_Period           : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not an incremental counter, digital I/O or TTL I/O module.
+ * @retval 4: The period is wrong.
+ */
+int i_APCI1710_SetValueCacheSampler (struct pci_dev *pdev, uint8_t b_ModuleMask, uint32_t ul_Period);
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
+/** Select the input edges to detect on a digital I/O or TTL I/O module.
+ *
+ * The channels are the bits of the port value returned by
+ * "i_APCI1710_ReadDigitalIOPortValue" for a digital I/O module
+ * (bits 0-6) and of the port register for a TTL I/O module
+ * (bits 0-7: port A, 8-15: port B, 16-23: port C, 24-25: port D).
+ * Both masks at 0 stop the detection on the module.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] ul_RisingMask         : Channels generating an APCI1710_EDGE_RISING_INTERRUPT event.
+ * @param [in] ul_FallingMask        : Channels generating an APCI1710_EDGE_FALLING_INTERRUPT event.
+ *
+ * @retval 0: No error.
+ * @retval 1: parameter pdev is NULL.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a digital I/O or TTL I/O module.
+ * @retval 4: The module is not initialised.
+ * @retval 5: A mask selects a channel which is not an input.
+ */
+int i_APCI1710_InitEdgeDetection (struct pci_dev *pdev,
+                                  uint8_t b_ModulNbr,
+                                  uint32_t ul_RisingMask,
+                                  uint32_t ul_FallingMask);
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the edge detection sampler.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ul_Period             : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: parameter pdev is NULL.
+ * @retval 2: The period is wrong.
+ */
+int i_APCI1710_SetEdgeDetectionPeriod (struct pci_dev *pdev, uint32_t ul_Period);
+
+//------------------------------------------------------------------------------
+
+/** Latch the 32-bit counter and return its 64-bit extended position.
+ *
+ * The difference with the previous read is taken as a signed 32-bit step;
+ * see i_APCI1710_SetCounterExtensionPeriod to read the counters often enough.
+ * See CMD_APCI1710_Read64BitCounterValue for the restarts of the position.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ *
+ * @param [out] pll_Position     : 64-bit extended position.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No counter module found.
+ * @retval 3: Counter not initialised see function "i_APCI1710_InitCounter".
+ * @retval 4: The counter is not in 32-bit mode.
+ */
+int i_APCI1710_Read64BitCounterValue (struct pci_dev *pdev,
+                                      uint8_t b_ModulNbr,
+                                      int64_t * pll_Position);
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the counter extension sampler.
+ *
+ * A counter whose latch register 0 is used by the application is not
+ * sampled (see i_APCI1710_LatchCounter).
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ul_Period             : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ */
+int i_APCI1710_SetCounterExtensionPeriod (struct pci_dev *pdev, uint32_t ul_Period);
+
+//------------------------------------------------------------------------------
+
+/** Load a scan program and run it periodically.
+ *
+ * See CMD_APCI1710_LoadScanProgram for the instructions.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Program            : The program. A period of 0 or no instruction stops the program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The number of instructions is wrong.
+ * @retval 4: An instruction has a wrong opcode, register or condition.
+ * @retval 5: An instruction reads or writes a module which does not support it.
+ */
+int i_APCI1710_LoadScanProgram (struct pci_dev *pdev,
+                                const str_APCI1710_ScanProgram * ps_Program);
+
+//------------------------------------------------------------------------------
+
+/** Return the state and the registers of the scan program.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Status            : State of the program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_GetScanStatus (struct pci_dev *pdev,
+                              str_APCI1710_ScanStatus * ps_Status);
+
+//------------------------------------------------------------------------------
+
+/** Configure the software position compare of an absolute encoder axis.
+ *
+ * See CMD_APCI1710_SetPositionCompare.
+ *
+ * @warning This function sleeps, it must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Config             : The configuration, a period of 0 stops the compare.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 5: The number of windows is wrong.
+ * @retval 6: A window is wrong (limits or output module).
+ * @retval 7: The sampling thread can not be started.
+ * @retval 8: The EnDat channel runs its position stream.
+ */
+int i_APCI1710_SetPositionCompare (struct pci_dev *pdev,
+                                   const str_APCI1710_PositionCompare * ps_Config);
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the trigger log of the position compare.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Triggers          : The logged triggers, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadPositionTriggers (struct pci_dev *pdev,
+                                     str_APCI1710_PositionTriggers * ps_Triggers);
+
+//------------------------------------------------------------------------------
+
+/** Queue output changes at absolute times.
+ *
+ * See CMD_APCI1710_QueueTimedOutputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Outputs            : The outputs.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of outputs is wrong.
+ * @retval 3: An output module is wrong or has no output.
+ * @retval 4: Not enough room in the schedule.
+ */
+int i_APCI1710_QueueTimedOutputs (struct pci_dev *pdev,
+                                  const str_APCI1710_TimedOutputs * ps_Outputs);
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the execution reports of the timed outputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Reports           : The reports, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadTimedOutputReports (struct pci_dev *pdev,
+                                       str_APCI1710_TimedOutputReports * ps_Reports);
+
+//------------------------------------------------------------------------------
+
+/** Remove all the pending timed outputs.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ClearTimedOutputs (struct pci_dev *pdev);
+
+//------------------------------------------------------------------------------
+
+/** Set the CPUs serving the interrupt and the kernel threads of a board.
+ *
+ * See CMD_APCI1710_SetBoardAffinity.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Config             : The masks to set.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Flags is wrong.
+ * @retval 3: A mask selects no online CPU.
+ * @retval 4: The interrupt affinity can not be set, the previous one is removed.
+ * @retval 5: The interrupt line is a shared INTx line, nothing is changed.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int i_APCI1710_SetBoardAffinity (struct pci_dev *pdev,
+                                 const str_APCI1710_Affinity * ps_Config);
+
+//------------------------------------------------------------------------------
+
+/** Return the NUMA node and the CPU affinity of a board.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Config            : The affinity.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_GetBoardAffinity (struct pci_dev *pdev,
+                                 str_APCI1710_Affinity * ps_Config);
+
+//------------------------------------------------------------------------------
+
+/** Validate and apply the configuration of a whole board in one call.
+ *
+ * See CMD_APCI1710_ApplyBoardConfig.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in,out] ps_Config         : The configuration,
+ *                                     ul_ErrorModule, ul_ErrorStep and i_ErrorCode are set on error 4.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ * @retval 4: An initialisation step failed.
+ */
+int i_APCI1710_ApplyBoardConfig (struct pci_dev *pdev,
+                                 str_APCI1710_BoardConfig * ps_Config);
+
+//------------------------------------------------------------------------------
+
+/** Return the current configuration of a board.
+ *
+ * See CMD_APCI1710_ReadBoardConfig.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Config            : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadBoardConfig (struct pci_dev *pdev,
+                                str_APCI1710_BoardConfig * ps_Config);
+
+//------------------------------------------------------------------------------
+
+/** Feed recorded events back to the board event delivery.
+ *
+ * See CMD_APCI1710_ReplayEvents.
+ * The events reach all the users of the board. The function does not
+ * check the capabilities of the calling task: a kernel caller feeding
+ * events from user space must require CAP_SYS_ADMIN like the ioctl.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in,out] ps_Replay         : The events, ul_Replayed is set to the events delivered,
+ *                                     ull_ReplayStart and ull_RecordStart are set if ull_ReplayStart is 0.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The module of an event is wrong.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -ENODEV : The board is being removed.
+ */
+int i_APCI1710_ReplayEvents (struct pci_dev *pdev,
+                             str_APCI1710_EventReplay * ps_Replay);
+
+//------------------------------------------------------------------------------
+
+/** Set the coalescing of the event notifications of the board.
+ *
+ * See CMD_APCI1710_SetNotificationCoalescing.
+ *
+ * @warning This function must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ul_MaxEvents          : Events per notification (0 or 1: notify each event).
+ * @param [in] ul_Delay              : Maximal delay of a notification in us.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The delay is wrong.
+ */
+int i_APCI1710_SetNotificationCoalescing (struct pci_dev *pdev,
+                                          uint32_t ul_MaxEvents,
+                                          uint32_t ul_Delay);
+
+//------------------------------------------------------------------------------
+
+/* Prepared handles */
+
+/** Operations of a prepared handle. */
+#define APCI1710_HANDLE_READ_COUNTER32		1	/**< Latch and read the 32-bit counter of an incremental counter module */
+#define APCI1710_HANDLE_READ_DIGITAL_PORT	2	/**< Read the port of a digital I/O module (see i_APCI1710_ReadDigitalIOPortValue) */
+#define APCI1710_HANDLE_READ_TTL_PORT		3	/**< Read the port register of a TTL I/O module (bits 0-25) */
+
+/** Prepared access to one module, see i_APCI1710_PrepareHandle.
+ * The fields are private to the driver.
+ */
+typedef struct
+{
+	struct pci_dev * pdev;
+	unsigned long ui_Address;    /* Base address of the module registers */
+	uint8_t b_ModulNbr;
+	uint8_t b_Operation;         /* APCI1710_HANDLE_xxx                  */
+} str_APCI1710_PreparedHandle;
+
+//------------------------------------------------------------------------------
+
+/** Validate an access to a module once and prepare it in a handle.
+ *
+ * The board, the module number, the functionality and the initialisation of
+ * the module are checked here and the register address is computed, so
+ * i_APCI1710_ExecuteHandle only tests that the module is still initialised
+ * before it accesses the registers. Meant for kernel modules sampling a
+ * module at high rate. The handle stays valid as long as the board exists.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_Operation           : APCI1710_HANDLE_xxx.
+ *
+ * @param [out] ps_Handle            : The prepared handle.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module does not support the operation.
+ * @retval 4: The module is not initialised.
+ */
+int i_APCI1710_PrepareHandle (struct pci_dev *pdev,
+                              uint8_t b_ModulNbr,
+                              uint8_t b_Operation,
+                              str_APCI1710_PreparedHandle * ps_Handle);
+
+//------------------------------------------------------------------------------
+
+/** Execute the operation of a prepared handle.
+ *
+ * Like the other read functions, the value is published in the value
+ * cache and a 32-bit counter value updates the 64-bit counter extension.
+ *
+ * @warning The board lock must be held, see APCI1710_LOCK.
+ *
+ * @param [in] ps_Handle             : Handle prepared by i_APCI1710_PrepareHandle.
+ *
+ * @param [out] pul_Value            : Value read.
+ *
+ * @retval 0: No error.
+ * @retval 4: The module is not initialised anymore.
+ */
+int i_APCI1710_ExecuteHandle (const str_APCI1710_PreparedHandle * ps_Handle,
+                              uint32_t * pul_Value);
+
+//------------------------------------------------------------------------------
+
+/** Latch and read the initialised modules of all the boards in one call.
+ *
+ * The counters of all the boards are latched (latch register 0) and the SSI
+ * acquisitions of all the boards are started back to back, each board under
+ * its own lock, then the values are read board by board. The counters
+ * whose latch register 0 is used by the application are left out
+ * (see i_APCI1710_LatchCounter).
+ * See CMD_APCI1710_ReadBoardsSnapshot for the layout of the snapshot.
+ *
+ * @warning This function must be called without any board lock.
+ *
+ * @param [out] ps_Snapshot      : The snapshot.
+ *
+ * @retval 0: No error.
+ * @retval 1: ps_Snapshot is NULL.
+ */
+int i_APCI1710_ReadBoardsSnapshot (str_APCI1710_Snapshot * ps_Snapshot);
+
+//------------------------------------------------------------------------------
+
+/** Return the board of the given minor number, NULL if none.
+ *
+ * Takes no lock: it can be called from any context, interrupts included.
+ * The board stays valid while the caller is in an RCU read-side section
+ * (rcu_read_lock) or holds an open file of the board.
+ */
 struct pci_dev * apci1710_lookup_board_by_index(unsigned int index);
 
 //----------------------------------------------------------------------------
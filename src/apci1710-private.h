@@ -77,6 +77,19 @@
 #include <linux/delay.h>
 #include <linux/init.h>
 #include <linux/proc_fs.h>
+#include <linux/list.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/mutex.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/hrtimer.h>
+#include <linux/mm.h>
+#include <linux/kthread.h>
+#include <linux/rcupdate.h>
 
 #include "apci1710.h"
 #include "apci1710-kapi.h"
@@ -107,6 +120,18 @@ static __inline__ unsigned long GET_BAR3(struct pci_dev * dev)
 	return dev->resource[3].start;
 }
 
+/** NUMA node of a board, the board data is allocated on it.
+ * @return The node, NUMA_NO_NODE (-1) if unknown.
+ */
+static __inline__ int APCI1710_NODE(struct pci_dev * dev)
+{
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,20)
+	return -1;
+#else
+	return dev_to_node(&dev->dev);
+#endif
+}
+
 /** Utility fonction that returns 0 if the given index corresponds to a card already configured.
  *
  * @param count Number of board
@@ -187,6 +212,27 @@ int apci1710_release_lookup (struct inode *inode,struct file *filp);
 								unsigned int cmd,
 								unsigned long arg);
 #endif
+ssize_t apci1710_read_lookup (struct file *filp, char __user *buf, size_t count, loff_t *ppos);
+unsigned int apci1710_poll_lookup (struct file *filp, poll_table *wait);
+int apci1710_mmap_lookup (struct file *filp, struct vm_area_struct *vma);
+
+/* event subscription functions (event.c) */
+struct apci1710_str_FileInformations;
+int apci1710_do_file_ioctl (struct file *filp, unsigned int cmd, unsigned long arg);
+void apci1710_event_release (struct apci1710_str_FileInformations * ps_File);
+void apci1710_event_detach_all (struct pci_dev * pdev);
+int apci1710_event_pop (struct apci1710_str_FileInformations * ps_File, str_APCI1710_Event * ps_Event);
+int apci1710_event_pending (struct apci1710_str_FileInformations * ps_File);
+void apci1710_event_dispatch (struct pci_dev * pdev,
+                              uint8_t b_Module,
+                              uint32_t ul_InterruptMask,
+                              uint32_t * ul_Value);
+void apci1710_event_wake_up (struct pci_dev * pdev);
+
+/* coalescing of the event notifications (notify-kapi.c), called by the interrupt functions */
+void apci1710_notify_coalescing_init (struct pci_dev *pdev);
+void v_APCI1710_Notify (struct pci_dev *pdev);
+void v_APCI1710_CoalesceNotification (struct pci_dev *pdev);
 
 /*/proc functions  */
 void apci1710_proc_init(void);
@@ -194,9 +240,62 @@ void apci1710_proc_release(void);
 void apci1710_proc_create_device(struct pci_dev * dev, unsigned int minor_number);
 void apci1710_proc_release_device(struct pci_dev * dev);
 
+/* use of latch register 0 by the application (inc_cpt-kapi.c), checked by the samplers */
+int apci1710_inc_cpt_latch0_in_use (struct pci_dev *pdev, uint8_t b_ModulNbr);
+
+/* latest value cache (cache-kapi.c) */
+int apci1710_value_cache_init (struct pci_dev *pdev);
+void apci1710_value_cache_release (struct pci_dev *pdev);
+
+/* input edge detection (edge-kapi.c) */
+void apci1710_edge_detection_init (struct pci_dev *pdev);
+
+/* 64-bit counter extension (counter64-kapi.c) */
+void apci1710_counter_extension_init (struct pci_dev *pdev);
+
+/* cyclic scan program (scan-kapi.c) */
+void apci1710_scan_program_init (struct pci_dev *pdev);
+
+/* SSI conversion without waiting (ssi-kapi.c), used by the scan program */
+void apci1710_ssi_start_conversion (struct pci_dev *pdev, uint8_t b_ModulNbr);
+int apci1710_ssi_read_conversion (struct pci_dev *pdev, uint8_t b_ModulNbr, uint32_t * pul_Position, uint32_t *pul_TurnCpt);
+
+/* software position compare (poscmp-kapi.c) */
+void apci1710_position_compare_init (struct pci_dev *pdev);
+
+/* timed output scheduler (outsched-kapi.c) */
+void apci1710_timed_output_init (struct pci_dev *pdev);
+
+/* board affinity (affinity-kapi.c) */
+void apci1710_affinity_init (struct pci_dev *pdev);
+void apci1710_affinity_release (struct pci_dev *pdev);
+struct task_struct * apci1710_worker_run (struct pci_dev *pdev, int (*threadfn)(void *data), void * data, const char * name);
+void apci1710_worker_bind (struct pci_dev *pdev, struct task_struct * ps_Thread);
+
+/* software position compare (poscmp-kapi.c), called when the worker affinity changes */
+void apci1710_position_compare_bind (struct pci_dev *pdev);
+
+/* EnDat position streams (Endat_1711-kapi.c) */
+void apci1710_endat_stream_init (struct pci_dev *pdev);
+void apci1710_endat_stream_stop (struct pci_dev *pdev);
+void apci1710_endat_stream_release (struct pci_dev *pdev);
+void apci1710_endat_stream_bind (struct pci_dev *pdev);
+void * apci1710_endat_stream_area (struct pci_dev *pdev, unsigned long ul_PageOffset, unsigned long * pul_Size);
+int apci1710_endat_stream_running (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_Channel);
+
 /* interrupt related function */
 int apci1710_register_interrupt(struct pci_dev * pdev);
 int apci1710_deregister_interrupt(struct pci_dev * pdev);
+void v_APCI1710_UpdateArmedModules (struct pci_dev * pdev);
+
+/* pulse encoder reload queue (imp_cpt-kapi.c), called by the interrupt function */
+uint32_t ul_APCI1710_ReloadPulseEncoder (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_PulseEncoderNbr);
+
+/* chronometer measurement stream (chronos-kapi.c), called by the interrupt function */
+int i_APCI1710_ChronoStreamAdd (struct pci_dev *pdev, uint8_t b_ModulNbr, uint32_t ul_Value);
+
+/* ETM capture (etm-kapi.c), called by the interrupt function */
+int i_APCI1710_ETMCaptureAdd (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_ETM, uint32_t *pul_Value);
 
 #include "api.h"
 #include "privdata.h"
@@ -0,0 +1,225 @@
+/* Static tracepoints of the driver (ftrace / perf: events/apci1710/).
+ *
+ * They cost a patched-out branch when disabled, so they may be used in the
+ * interrupt path and in the encoder bus loops.
+ * The events are created in trace.c, this header may be included anywhere
+ * after apci1710-private.h.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM apci1710
+
+#if !defined(APCI1710_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define APCI1710_TRACE_H_
+
+#include <linux/version.h>
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,32)
+	/* no TRACE_EVENT() before 2.6.32: the trace_*() calls are compiled out */
+	#define TP_PROTO(args...) args
+	#define TRACE_EVENT(name, proto, args, tstruct, assign, print) \
+		static __inline__ void trace_##name(proto) { }
+#else
+	#include <linux/tracepoint.h>
+#endif
+
+//------------------------------------------------------------------------------
+
+/* ioctl dispatch (ioctl.c) */
+
+TRACE_EVENT(apci1710_ioctl_entry,
+	TP_PROTO(struct pci_dev *pdev, unsigned int cmd),
+	TP_ARGS(pdev, cmd),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(unsigned int, cmd)
+	),
+	TP_fast_assign(
+		__entry->board = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->cmd   = cmd;
+	),
+	TP_printk("board=%u cmd=0x%08x nr=%u",
+		  __entry->board, __entry->cmd, _IOC_NR(__entry->cmd))
+);
+
+TRACE_EVENT(apci1710_ioctl_exit,
+	TP_PROTO(struct pci_dev *pdev, unsigned int cmd, int ret),
+	TP_ARGS(pdev, cmd, ret),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(unsigned int, cmd)
+		__field(int, ret)
+	),
+	TP_fast_assign(
+		__entry->board = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->cmd   = cmd;
+		__entry->ret   = ret;
+	),
+	TP_printk("board=%u cmd=0x%08x nr=%u ret=%d",
+		  __entry->board, __entry->cmd, _IOC_NR(__entry->cmd), __entry->ret)
+);
+
+//------------------------------------------------------------------------------
+
+/* interrupt events (irq-private-kapi.h, v_APCI1710_UserInterruptManagement) */
+
+TRACE_EVENT(apci1710_interrupt_event,
+	TP_PROTO(struct pci_dev *pdev, uint8_t b_Module, uint32_t ul_InterruptMask, uint32_t ul_Value),
+	TP_ARGS(pdev, b_Module, ul_InterruptMask, ul_Value),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+		__field(uint32_t, mask)
+		__field(uint32_t, value)
+	),
+	TP_fast_assign(
+		__entry->board  = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module = b_Module;
+		__entry->mask   = ul_InterruptMask;
+		__entry->value  = ul_Value;
+	),
+	TP_printk("board=%u module=0x%02x mask=0x%08x value=0x%08x",
+		  __entry->board, __entry->module, __entry->mask, __entry->value)
+);
+
+//------------------------------------------------------------------------------
+
+/* SSI conversion (ssi-kapi.c) */
+
+TRACE_EVENT(apci1710_ssi_start,
+	TP_PROTO(struct pci_dev *pdev, uint8_t b_ModulNbr),
+	TP_ARGS(pdev, b_ModulNbr),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+	),
+	TP_fast_assign(
+		__entry->board  = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module = b_ModulNbr;
+	),
+	TP_printk("board=%u module=%u", __entry->board, __entry->module)
+);
+
+TRACE_EVENT(apci1710_ssi_complete,
+	TP_PROTO(struct pci_dev *pdev, uint8_t b_ModulNbr, uint32_t dw_StatusReg),
+	TP_ARGS(pdev, b_ModulNbr, dw_StatusReg),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+		__field(uint32_t, status)
+	),
+	TP_fast_assign(
+		__entry->board  = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module = b_ModulNbr;
+		__entry->status = dw_StatusReg;
+	),
+	TP_printk("board=%u module=%u status=0x%08x",
+		  __entry->board, __entry->module, __entry->status)
+);
+
+//------------------------------------------------------------------------------
+
+/* BiSS master commands (biss_1711-kapi.c) */
+
+TRACE_EVENT(apci1710_biss_submit,
+	TP_PROTO(struct pci_dev *pdev, uint32_t command),
+	TP_ARGS(pdev, command),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint32_t, command)
+	),
+	TP_fast_assign(
+		__entry->board   = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->command = command;
+	),
+	TP_printk("board=%u command=0x%02x", __entry->board, __entry->command)
+);
+
+TRACE_EVENT(apci1710_biss_eot,
+	TP_PROTO(struct pci_dev *pdev, uint32_t bit, int timeout),
+	TP_ARGS(pdev, bit, timeout),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint32_t, bit)
+		__field(int, timeout)
+	),
+	TP_fast_assign(
+		__entry->board   = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->bit     = bit;
+		__entry->timeout = timeout;
+	),
+	TP_printk("board=%u status bit=%u %s",
+		  __entry->board, __entry->bit, __entry->timeout ? "timeout" : "eot")
+);
+
+//------------------------------------------------------------------------------
+
+/* EnDat commands (Endat_1711-kapi.c, Primary_EndatSendCommand) */
+
+TRACE_EVENT(apci1710_endat_submit,
+	TP_PROTO(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel, uint32_t modeCommand, uint32_t cmd),
+	TP_ARGS(pdev, moduleIndex, channel, modeCommand, cmd),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+		__field(uint8_t, channel)
+		__field(uint32_t, mode)
+		__field(uint32_t, cmd)
+	),
+	TP_fast_assign(
+		__entry->board   = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module  = moduleIndex;
+		__entry->channel = channel;
+		__entry->mode    = modeCommand;
+		__entry->cmd     = cmd;
+	),
+	TP_printk("board=%u module=%u channel=%u mode=0x%02x cmd=0x%08x",
+		  __entry->board, __entry->module, __entry->channel, __entry->mode, __entry->cmd)
+);
+
+TRACE_EVENT(apci1710_endat_complete,
+	TP_PROTO(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel),
+	TP_ARGS(pdev, moduleIndex, channel),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+		__field(uint8_t, channel)
+	),
+	TP_fast_assign(
+		__entry->board   = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module  = moduleIndex;
+		__entry->channel = channel;
+	),
+	TP_printk("board=%u module=%u channel=%u",
+		  __entry->board, __entry->module, __entry->channel)
+);
+
+TRACE_EVENT(apci1710_endat_timeout,
+	TP_PROTO(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t channel),
+	TP_ARGS(pdev, moduleIndex, channel),
+	TP_STRUCT__entry(
+		__field(unsigned int, board)
+		__field(uint8_t, module)
+		__field(uint8_t, channel)
+	),
+	TP_fast_assign(
+		__entry->board   = APCI1710_PRIVDATA(pdev)->ui_Index;
+		__entry->module  = moduleIndex;
+		__entry->channel = channel;
+	),
+	TP_printk("board=%u module=%u channel=%u",
+		  __entry->board, __entry->module, __entry->channel)
+);
+
+//------------------------------------------------------------------------------
+
+#endif /* APCI1710_TRACE_H_ */
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,32)
+/* this part must be outside the header guard, see trace.c */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE apci1710-trace
+#include <trace/define_trace.h>
+#endif
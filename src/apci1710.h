@@ -501,6 +501,9 @@
 0x00010004	index high level
 0x00000008	compare
 0x00010000	frequency
+0x00100000	input rising edges (see CMD_APCI1710_InitEdgeDetection)
+0x00200000	input falling edges (see CMD_APCI1710_InitEdgeDetection)
+0x80000000	or'ed into the mask of a replayed event (see CMD_APCI1710_ReplayEvents)
  *
  */
 #define CMD_APCI1710_TestInterrupt				_IOWR(APCI1710_MAGIC, 14, unsigned long*)
@@ -2570,11 +2573,1698 @@ after each INDEX action.
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
+/* Event subscription */
+
+/** Event delivered to a file that subscribed with CMD_APCI1710_SubscribeEvents.
+ *
+ * Events are read with read() on the subscribed file (one or several
+ * str_APCI1710_Event per call) or with CMD_APCI1710_TestSubscribedEvent.
+ */
+typedef struct
+{
+	uint64_t ull_TimeStamp;    /* Monotonic time of the event in ns                  */
+	uint32_t ul_InterruptMask; /* Interrupt mask (see CMD_APCI1710_TestInterrupt)    */
+	uint32_t ul_Value[2];      /* Index 0: Counter or ETM value
+	                              Index 1: ETM total time value                      */
+	uint8_t  b_ModuleNbr;      /* Module that generated the event (0 to 3)           */
+	uint8_t  b_Reserved[3];
+} str_APCI1710_Event;
+
+/** Default number of events of a subscription ring. */
+#define APCI1710_SUBSCRIPTION_DEFAULT_SIZE	256
+
+/** Maximum number of events of a subscription ring. */
+#define APCI1710_SUBSCRIPTION_MAX_SIZE		65536
+
+//------------------------------------------------------------------------------
+
+/** Subscribe the file to the board events.
+ *
+ * Each subscribed file owns a ring filled by the interrupt routine with
+ * the events matching its filter. Several files can subscribe to the
+ * same board, each one receives its own copy of the events and
+ * reading from one file never removes an event from another one.
+ * The events are still saved in the board FIFO read by
+ * CMD_APCI1710_TestInterrupt.
+ * Calling this command on an already subscribed file replaces the
+ * previous subscription (pending events are lost).
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)       : Modules to listen (bit n set: module n, 1 to 0xF).
+ * @param [in] arg[1] (ul_InterruptMask)   : Interrupt mask filter. An event is delivered
+ *                                           if its interrupt mask has at least one bit
+ *                                           in common with the filter. 0: all the events.
+ * @param [in] arg[2] (ul_RingSize)        : Number of events of the ring, rounded up to a
+ *                                           power of two (0: APCI1710_SUBSCRIPTION_DEFAULT_SIZE,
+ *                                           max APCI1710_SUBSCRIPTION_MAX_SIZE).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: The ring size is wrong.
+ * @retval -ENOMEM : Fail to allocate the ring.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SubscribeEvents _IOW(APCI1710_MAGIC, 103, uint32_t*)
+//------------------------------------------------------------------------------
+
+/** Cancel the subscription of the file.
+ *
+ * Pending events are lost.
+ *
+ * @param [in] fd                  : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The file has no subscription.
+ */
+#define CMD_APCI1710_UnsubscribeEvents _IO(APCI1710_MAGIC, 104)
+//------------------------------------------------------------------------------
+
+/** Return the oldest pending event of the file subscription.
+ *
+ * This command never blocks. Use read() or poll() on the file to wait
+ * for events.
+ *
+ * @param [in] fd                  : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_Event) : The event.
+ *
+ * @retval 0: No error, the event is returned.
+ * @retval 1: No event pending.
+ * @retval 2: The file has no subscription.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_TestSubscribedEvent _IOR(APCI1710_MAGIC, 105, str_APCI1710_Event)
+//------------------------------------------------------------------------------
+
+/** Return the status of the file subscription.
+ *
+ * @param [in] fd                  : The device to use.
+ *
+ * @param [out] arg[0] (ul_PendingEvents) : Number of events not read yet.
+ * @param [out] arg[1] (ul_LostEvents)    : Number of events lost because the ring was
+ *                                          full since the last call.
+ * @param [out] arg[2] (ul_RingSize)      : Number of events of the ring.
+ *
+ * @retval 0: No error.
+ * @retval 2: The file has no subscription.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_GetSubscriptionStatus _IOR(APCI1710_MAGIC, 106, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Latest value cache */
+
+/** Latest values of a board.
+ *
+ * The values are updated by the read functions of the control path
+ * (32-bit counter read, digital I/O and TTL I/O input reads) and by the
+ * kernel sampler (see CMD_APCI1710_SetValueCacheSampler).
+ * Monitoring processes read them without locking the board and
+ * without hardware access, either with CMD_APCI1710_ReadValueCache or
+ * by mapping the page APCI1710_MMAP_VALUE_CACHE of the device read only.
+ *
+ * A mapped reader must use the sequence counter to get a coherent copy:
+ * @verbatim
+   do
+   {
+      ul_Sequence = ps_Cache->ul_Sequence;  // odd: update in progress
+      __sync_synchronize ();
+      s_Copy = *ps_Cache;
+      __sync_synchronize ();
+   }
+   while ((ul_Sequence & 1) || (ul_Sequence != ps_Cache->ul_Sequence));
+   @endverbatim
+ */
+typedef struct
+{
+	uint32_t ul_Sequence;       /* Incremented before and after each update      */
+	uint32_t ul_ValidMask;      /* Bit n set: ul_Value[n] holds a value          */
+	uint64_t ull_TimeStamp[4];  /* Monotonic time of the last update in ns       */
+	uint32_t ul_Value[4];       /* Latest value of module n:
+	                               Incremental counter: 32-bit counter value
+	                               Digital I/O: input port value
+	                               TTL I/O: port A (bits 0-7), B (8-15),
+	                                        C (16-23), D (24-25)             */
+} str_APCI1710_ValueCache;
+
+/** mmap page offset of the latest value cache (one page, read only). */
+#define APCI1710_MMAP_VALUE_CACHE			0
+
+/** Minimum period of the value cache sampler in us. */
+#define APCI1710_VALUE_CACHE_MIN_PERIOD	100
+
+//------------------------------------------------------------------------------
+
+/** Return the latest values of the board.
+ *
+ * This command does not lock the board and does not access the hardware.
+ *
+ * @param [in] fd                  : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ValueCache) : The latest values.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_ReadValueCache _IOR(APCI1710_MAGIC, 107, str_APCI1710_ValueCache)
+//------------------------------------------------------------------------------
+
+/** Start or stop the kernel sampler of the value cache.
+ *
+ * The sampler periodically reads the selected modules and updates the
+ * value cache. Modules that are not initialised are skipped.
+ * The counter of an incremental counter module is read with the
+ * software latch, like CMD_APCI1710_Read32BitCounterValue. The counter is
+ * skipped while the application uses latch register 0: a software latch
+ * into it not read yet, the index latch or the latch interrupt.
+ *
+ * @param [in] fd                      : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)   : Modules to sample (bit n set: module n).
+ *                                       Incremental counter, digital I/O or TTL I/O modules.
+ * @param [in] arg[1] (ul_Period)      : Sampling period in us
+ *                                       (min APCI1710_VALUE_CACHE_MIN_PERIOD). 0: stop the sampler.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not an incremental counter, digital I/O or TTL I/O module.
+ * @retval 4: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetValueCacheSampler _IOW(APCI1710_MAGIC, 108, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Masked digital outputs */
+
+/** Channels of a TTL I/O module in one 32-bit value.
+ *
+ * The layout is the one of the port register of the module; it is used by
+ * CMD_APCI1710_SetDigitalOutputsMasked, CMD_APCI1710_ReadTTLIOAllPortValues
+ * and by the value cache.
+ * PD0 and PD1 are the bits 24 and 25.
+ */
+#define APCI1710_TTL_PORT_A_MASK	0x000000FFUL	/**< PA0 to PA7: bits 0-7    */
+#define APCI1710_TTL_PORT_B_MASK	0x0000FF00UL	/**< PB0 to PB7: bits 8-15   */
+#define APCI1710_TTL_PORT_C_MASK	0x00FF0000UL	/**< PC0 to PC7: bits 16-23  */
+#define APCI1710_TTL_PORT_D_MASK	0x03000000UL	/**< PD0 and PD1: bits 24-25 */
+
+/** Set and reset outputs of several digital I/O and TTL I/O modules at once.
+ *
+ * For each selected module, the outputs of the set mask are set high and the
+ * outputs of the reset mask are set low, the other outputs keep their state.
+ * All modules are tested before the first write, so on error no output
+ * is changed.
+ *
+ * Digital I/O channels: bit 0: H, bit 1: A, bit 2: B. If the digital output
+ * memory is off, the other outputs are set to "0" like with
+ * CMD_APCI1710_SetDigitalIOPortOn.
+ * TTL I/O channels: APCI1710_TTL_PORT_A_MASK to APCI1710_TTL_PORT_D_MASK
+ * (bits 0-7: PA, bits 8-15: PB, bits 16-23: PC, bits 24-25: PD0-PD1).
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)       : Modules to write (bit n set: module n).
+ * @param [in] arg[1 + 2n] (ul_SetMask)    : Outputs to set on module n (n = 0 to 3).
+ * @param [in] arg[2 + 2n] (ul_ClearMask)  : Outputs to reset on module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not a digital I/O or TTL I/O module.
+ * @retval 4: A mask is wrong (channel not available or set and reset at once).
+ * @retval 5: A selected module is not initialised.
+ * @retval 6: A selected channel is used for input.
+ * @retval 7: Digital Output Memory OFF and outputs to reset. Use previously the command "CMD_APCI1710_SetDigitalIOMemoryOn".
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetDigitalOutputsMasked _IOW(APCI1710_MAGIC, 109, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Read all ports of all initialised TTL I/O modules of the board.
+ *
+ * Each module is read with one access to its port register.
+ * Port value: see APCI1710_TTL_PORT_A_MASK (bits 0-7: port A, bits 8-15:
+ * port B, bits 16-23: port C, bits 24-25: port D). The input mask gives the channels configured as input
+ * (see CMD_APCI1710_InitTTLIODirection), the other bits of the value are
+ * the state of the outputs.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg[0] (b_ModuleMask)      : Modules read (bit n set: module n).
+ * @param [out] arg[1 + n] (ul_PortValue)  : Port register of module n (n = 0 to 3).
+ * @param [out] arg[5 + n] (ul_InputMask)  : Input channels of module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised TTL I/O module on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_ReadTTLIOAllPortValues _IOR(APCI1710_MAGIC, 110, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Input edge detection */
+
+/** Interrupt mask of the rising edge events, the value is the channels which rose. */
+#define APCI1710_EDGE_RISING_INTERRUPT  0x00100000UL
+
+/** Interrupt mask of the falling edge events, the value is the channels which fell. */
+#define APCI1710_EDGE_FALLING_INTERRUPT 0x00200000UL
+
+/** Minimal period of the edge detection sampler in us. */
+#define APCI1710_EDGE_DETECTION_MIN_PERIOD 100
+
+/** Select the input edges to detect on a digital I/O or TTL I/O module.
+ *
+ * The kernel samples the port of the module (see
+ * CMD_APCI1710_SetEdgeDetectionPeriod) and compares it with the previous
+ * sample. The edges are delivered like the interrupts of the module:
+ * to the files subscribed with CMD_APCI1710_SubscribeEvents, to
+ * CMD_APCI1710_TestInterrupt and with SIGIO.
+ * The channels are the bits of the value of CMD_APCI1710_ReadDigitalIOPortValue
+ * for a digital I/O module (bits 0-6) and of the port register for a TTL I/O
+ * module (bits 0-7: port A, 8-15: port B, 16-23: port C, 24-25: port D).
+ * Edges shorter than the sampling period can be missed.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (ul_RisingMask)      : Channels generating an APCI1710_EDGE_RISING_INTERRUPT event.
+ * @param [in] arg[2] (ul_FallingMask)     : Channels generating an APCI1710_EDGE_FALLING_INTERRUPT event.
+ *                                           Both masks at 0: stop the detection on this module.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a digital I/O or TTL I/O module.
+ * @retval 4: The module is not initialised.
+ * @retval 5: A mask selects a channel which is not an input.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_InitEdgeDetection _IOW(APCI1710_MAGIC, 111, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the edge detection sampler of the board.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (ul_Period)          : Sampling period in us
+ *                                           (min APCI1710_EDGE_DETECTION_MIN_PERIOD). 0: stop the sampler.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetEdgeDetectionPeriod _IOW(APCI1710_MAGIC, 112, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Pulse encoder reload queue */
+
+/** Number of reload values a pulse encoder can queue. */
+#define APCI1710_PULSE_ENCODER_QUEUE_SIZE 64
+
+/** Queue start values for a pulse encoder.
+ *
+ * Each time the pulse encoder reaches 0 and generates its interrupt, the
+ * kernel writes the next queued value as new start value (like
+ * CMD_APCI1710_WritePulseEncoderValue). The pulse encoder must be enabled in
+ * APCI1710_CONTINUOUS mode with its interrupt, so that the hardware loads the
+ * written value on the next pulse: a sequence of pulse trains is then
+ * generated without a round trip to user space between two segments.
+ * The value of the interrupt event (mask 0x100 << b_PulseEncoderNbr) is the
+ * number of values still queued after the reload.
+ * The queue is emptied by CMD_APCI1710_InitPulseEncoder.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr)  : Pulse encoder selection (0 to 3).
+ * @param [in] arg[2] (ul_Count)           : Number of values (1 to APCI1710_PULSE_ENCODER_QUEUE_SIZE).
+ * @param [in] arg[3 + n] (ul_Value)       : Start values to queue (> 1).
+ *
+ * @param [out] arg[2] (ul_Queued)         : Number of values queued, less than
+ *                                           ul_Count if the queue is full.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong.
+ * @retval 3: Pulse encoder selection is wrong.
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval 5: The number of values or a value is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_QueuePulseEncoderValues _IOWR(APCI1710_MAGIC, 113, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Read the state of the reload queue of a pulse encoder.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr)  : Pulse encoder selection (0 to 3).
+ *
+ * @param [out] arg[0] (ul_Pending)        : Number of values still queued.
+ * @param [out] arg[1] (ul_Underruns)      : Number of interrupts which found the
+ *                                           queue empty since the last call.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong.
+ * @retval 3: Pulse encoder selection is wrong.
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_GetPulseEncoderQueueStatus _IOWR(APCI1710_MAGIC, 114, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Empty the reload queue of a pulse encoder.
+ *
+ * The current start value of the pulse encoder is kept.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr)  : Pulse encoder selection (0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong.
+ * @retval 3: Pulse encoder selection is wrong.
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_ClearPulseEncoderQueue _IOW(APCI1710_MAGIC, 115, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Bulk pulse encoder read */
+
+/** Values and status of all pulse encoders of a board.
+ *
+ * Bit (4 * module + encoder) of the masks selects pulse encoder
+ * "encoder" of module "module".
+ */
+typedef struct
+{
+	uint32_t ul_InitMask;       /* Initialised pulse encoders, the others are not read */
+	uint32_t ul_StatusMask;     /* Pulse encoders with an overflow since the last
+	                               read of their status (see CMD_APCI1710_ReadPulseEncoderStatus) */
+	uint32_t ul_Value[4][4];    /* [module][encoder] pulse encoder value             */
+} str_APCI1710_PulseEncoderValues;
+
+//------------------------------------------------------------------------------
+
+/** Read the value and status of all initialised pulse encoders of the board.
+ *
+ * Same result as CMD_APCI1710_ReadPulseEncoderValue and
+ * CMD_APCI1710_ReadPulseEncoderStatus for each initialised pulse encoder,
+ * in one call. The status register of each module is read once; the status
+ * of the returned pulse encoders is cleared like by
+ * CMD_APCI1710_ReadPulseEncoderStatus.
+ *
+ * @param [in] fd                  : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PulseEncoderValues) : The values and status.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised pulse encoder on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_ReadAllPulseEncoderValues _IOR(APCI1710_MAGIC, 116, str_APCI1710_PulseEncoderValues)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Chronometer measurement stream and statistics */
+
+/** Store the measured values in the stream of the module (CMD_APCI1710_ReadChronoStream). */
+#define APCI1710_CHRONO_STREAM			0x1
+/** Update the statistics of the module (CMD_APCI1710_GetChronoStatistics). */
+#define APCI1710_CHRONO_STATISTICS		0x2
+/** Do not deliver the measurements as interrupt events (mask 0x80). */
+#define APCI1710_CHRONO_NO_EVENT		0x4
+
+/** Number of measured values the stream of a module can hold. */
+#define APCI1710_CHRONO_STREAM_SIZE		256
+
+/** Number of buckets of the statistics histogram. */
+#define APCI1710_CHRONO_HISTOGRAM_SIZE	32
+
+/** Statistics of the chronometer measurements of a module.
+ *
+ * The values are in the timing unit of CMD_APCI1710_InitChrono
+ * (measured value * base timing value). Bucket 0 of the histogram counts
+ * the values 0, bucket n (1 to 30) the values from 2^(n-1) to 2^n - 1
+ * and bucket 31 the values from 2^30.
+ * The sum of the squared deviations behind ull_Variance saturates at
+ * 2^64 - 1 instead of wrapping: with deviations of 2^32 units and more
+ * (about 4 s in ns) ull_Variance can be a lower bound. Read the
+ * statistics with b_Reset = 1 to restart them.
+ */
+typedef struct
+{
+	uint8_t  b_ModulNbr;        /* [in] Module number (0 to 3)                        */
+	uint8_t  b_Reset;           /* [in] 1: restart the statistics after the read     */
+	uint8_t  b_Reserved[6];
+	uint64_t ull_Count;         /* Number of measurements                             */
+	uint64_t ull_Min;           /* Smallest value                                     */
+	uint64_t ull_Max;           /* Largest value                                      */
+	uint64_t ull_Mean;          /* Mean value                                         */
+	uint64_t ull_Variance;      /* Sample variance (unit^2)                           */
+	uint32_t ul_Histogram[APCI1710_CHRONO_HISTOGRAM_SIZE]; /* log2 histogram          */
+} str_APCI1710_ChronoStatistics;
+
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the measurements of a chronometer.
+ *
+ * Mainly for the APCI1710_CONTINUOUS cycle mode: each measurement can be
+ * stored in a stream of the module and accounted in its statistics in the
+ * kernel, without a user space read per measurement.
+ * The stream and the statistics are restarted.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_Flags)            : Combination of APCI1710_CHRONO_STREAM,
+ *                                           APCI1710_CHRONO_STATISTICS and
+ *                                           APCI1710_CHRONO_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: Chronometer not initialised see function "i_APCI1710_InitChrono".
+ * @retval 5: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetChronoStream _IOW(APCI1710_MAGIC, 117, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Read the measured values stored in the stream of a chronometer.
+ *
+ * The values are the raw values of CMD_APCI1710_ReadChronoValue.
+ * When the stream is full the oldest values are dropped.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (ul_MaxCount)        : Size of arg[2 ...] (1 to APCI1710_CHRONO_STREAM_SIZE).
+ *
+ * @param [out] arg[0] (ul_Count)          : Number of values read.
+ * @param [out] arg[1] (ul_Lost)           : Values dropped since the last read.
+ * @param [out] arg[2 + n] (ul_Value)      : Measured values, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The stream is not enabled see CMD_APCI1710_SetChronoStream.
+ * @retval 5: ul_MaxCount is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_ReadChronoStream _IOWR(APCI1710_MAGIC, 118, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Read the statistics of a chronometer.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in,out] arg (str_APCI1710_ChronoStatistics) : b_ModulNbr and b_Reset
+ *                                           select the module, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The statistics are not enabled see CMD_APCI1710_SetChronoStream.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_GetChronoStatistics _IOWR(APCI1710_MAGIC, 119, str_APCI1710_ChronoStatistics)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* ETM capture */
+
+/** Store a record of each ETM interrupt in the capture ring (CMD_APCI1710_ReadETMCapture). */
+#define APCI1710_ETM_CAPTURE_RING		0x1
+/** Update the aggregates of the ETM (CMD_APCI1710_GetETMCaptureStatistics). */
+#define APCI1710_ETM_CAPTURE_STATISTICS	0x2
+/** Do not deliver the ETM interrupts as interrupt events (mask 0x20000 << ETM). */
+#define APCI1710_ETM_CAPTURE_NO_EVENT	0x4
+
+/** Number of records the capture ring of an ETM can hold. */
+#define APCI1710_ETM_CAPTURE_SIZE		64
+
+/** Record of an ETM interrupt.
+ *
+ * ul_EdgeTime and ul_TotalTime are the raw values of i_APCI1710_ReadETMValue
+ * and i_APCI1710_ReadETMTotalTime, in the base timing of i_APCI1710_InitETM.
+ */
+typedef struct
+{
+	uint64_t ull_TimeStamp;     /* Monotonic time of the interrupt in ns              */
+	uint32_t ul_EdgeTime;       /* Time between the trigger and the selected edge     */
+	uint32_t ul_TotalTime;      /* Total time (period)                                */
+	uint32_t ul_DutyCycle;      /* ul_EdgeTime / ul_TotalTime in 0.01 % (0 to 10000)  */
+	uint32_t ul_Reserved;
+} str_APCI1710_ETMCaptureRecord;
+
+/** Aggregates of the ETM interrupts since the last restart. */
+typedef struct
+{
+	uint8_t  b_ModulNbr;        /* [in] Module number (0 to 3)                        */
+	uint8_t  b_ETMNbr;          /* [in] ETM selection (0 or 1)                        */
+	uint8_t  b_Reset;           /* [in] 1: restart the aggregates after the read      */
+	uint8_t  b_Reserved[5];
+	uint64_t ull_Count;         /* Number of records                                  */
+	uint32_t ul_MinTotalTime;   /* Total time                                         */
+	uint32_t ul_MaxTotalTime;
+	uint32_t ul_MeanTotalTime;
+	uint32_t ul_MinDutyCycle;   /* Duty cycle in 0.01 %                               */
+	uint32_t ul_MaxDutyCycle;
+	uint32_t ul_MeanDutyCycle;
+} str_APCI1710_ETMCaptureStatistics;
+
+/** Records read from the capture ring of an ETM. */
+typedef struct
+{
+	uint8_t  b_ModulNbr;        /* [in] Module number (0 to 3)                        */
+	uint8_t  b_ETMNbr;          /* [in] ETM selection (0 or 1)                        */
+	uint8_t  b_Reserved[2];
+	uint32_t ul_Count;          /* [in] Maximal number of records
+	                               [out] Number of records read, oldest first         */
+	uint32_t ul_Lost;           /* Records dropped since the last read                */
+	uint32_t ul_Reserved;
+	str_APCI1710_ETMCaptureRecord s_Record[APCI1710_ETM_CAPTURE_SIZE];
+} str_APCI1710_ETMCapture;
+
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the interrupts of an ETM.
+ *
+ * Each interrupt of the ETM can be stored as a str_APCI1710_ETMCaptureRecord
+ * in a capture ring and accounted in running aggregates, so that a PWM signal
+ * can be monitored at the interrupt rate without a user space read per edge.
+ * The ring and the aggregates are restarted.
+ * The ETM is initialised and enabled with its interrupt through the kernel
+ * API (i_APCI1710_InitETM, i_APCI1710_EnableETM); i_APCI1710_InitETM
+ * restarts the ring and the aggregates as well.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_ETMNbr)           : ETM selection (0 or 1).
+ * @param [in] arg[2] (b_Flags)            : Combination of APCI1710_ETM_CAPTURE_RING,
+ *                                           APCI1710_ETM_CAPTURE_STATISTICS and
+ *                                           APCI1710_ETM_CAPTURE_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: ETM not initialised.
+ * @retval 6: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetETMCapture _IOW(APCI1710_MAGIC, 120, uint32_t*)
+
+//------------------------------------------------------------------------------
+
+/** Read the records stored in the capture ring of an ETM.
+ *
+ * When the ring is full the oldest records are dropped.
+ * Only the first ul_Count records of s_Record are written.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCapture) : b_ModulNbr, b_ETMNbr and
+ *                                           ul_Count (maximal number of records, 1 to
+ *                                           APCI1710_ETM_CAPTURE_SIZE) select the ETM,
+ *                                           ul_Count, ul_Lost and s_Record are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The capture ring is not enabled see CMD_APCI1710_SetETMCapture.
+ * @retval 6: ul_Count is wrong.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_ReadETMCapture _IOWR(APCI1710_MAGIC, 121, str_APCI1710_ETMCapture)
+
+//------------------------------------------------------------------------------
+
+/** Read the aggregates of an ETM.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCaptureStatistics) : b_ModulNbr, b_ETMNbr and
+ *                                           b_Reset select the ETM, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The aggregates are not enabled see CMD_APCI1710_SetETMCapture.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+#define CMD_APCI1710_GetETMCaptureStatistics _IOWR(APCI1710_MAGIC, 122, str_APCI1710_ETMCaptureStatistics)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Cross-board snapshot */
+
+/** Maximal number of boards in a snapshot. */
+#define APCI1710_SNAPSHOT_MAX_BOARDS	8
+
+/** Maximal time to wait for the end of the SSI acquisitions of a snapshot in us. */
+#define APCI1710_SNAPSHOT_SSI_TIMEOUT	200
+
+/** Values of one board in a snapshot.
+ *
+ * ul_Value[n] holds the values of module n, depending on its functionality:
+ * - Incremental counter: [0] 32-bit counter value (latch register 0).
+ * - SSI counter: [2 * s] position and [2 * s + 1] turn counter of SSI s (0 to 2).
+ * - Digital I/O: [0] input port value.
+ * - TTL I/O: [0] port register (see CMD_APCI1710_ReadTTLIOAllPortValues).
+ */
+typedef struct
+{
+	uint64_t ull_TimeStamp;     /* Monotonic time of the latch of the board in ns     */
+	uint32_t ul_ValidMask;      /* Bit n set: ul_Value[n] holds the values of module n */
+	uint32_t ul_Reserved;
+	uint32_t ul_Value[4][6];
+} str_APCI1710_BoardSnapshot;
+
+/** Snapshot of all the boards, s_Board[n] is the board of minor number n.
+ * The entries of removed boards have an empty ul_ValidMask.
+ */
+typedef struct
+{
+	uint32_t ul_NumberOfBoards; /* Number of valid entries of s_Board                 */
+	uint32_t ul_Reserved;
+	str_APCI1710_BoardSnapshot s_Board[APCI1710_SNAPSHOT_MAX_BOARDS];
+} str_APCI1710_Snapshot;
+
+//------------------------------------------------------------------------------
+
+/** Latch and read the initialised modules of all the boards in one call.
+ *
+ * The command can be sent to any board; it covers all the boards of the
+ * driver. The counters of all the boards are latched and the SSI
+ * acquisitions of all the boards are started first, back to back, then the
+ * values are read board by board. Each board carries the time of its latch.
+ * Modules which are not initialised, not supported or whose SSI acquisition
+ * did not end within APCI1710_SNAPSHOT_SSI_TIMEOUT are not set in ul_ValidMask.
+ * Nor are the counters whose latch register 0 is used by the application
+ * (see CMD_APCI1710_SetValueCacheSampler): their latched value is kept.
+ *
+ * @param [in] fd                  : The device to use (any board).
+ *
+ * @param [out] arg (str_APCI1710_Snapshot) : The snapshot.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_ReadBoardsSnapshot _IOR(APCI1710_MAGIC, 123, str_APCI1710_Snapshot)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* 64-bit extended counter position */
+
+/** Minimal period of the counter extension sampler in us. */
+#define APCI1710_COUNTER_EXTENSION_MIN_PERIOD 1000
+
+/** Latch the 32-bit counter and return its 64-bit extended position.
+ *
+ * The driver extends the 32-bit counter of each module to 64 bits on every
+ * read (CMD_APCI1710_Read32BitCounterValue, this command, the value cache
+ * sampler) and with the counter extension sampler
+ * (CMD_APCI1710_SetCounterExtensionPeriod). The counter must not move by
+ * more than 2^31 steps between two reads. The position restarts from the
+ * counter value after CMD_APCI1710_InitCounter, CMD_APCI1710_ClearCounterValue,
+ * CMD_APCI1710_ClearAllCounterValue or CMD_APCI1710_Write32BitCounterValue,
+ * and after an index which clears the counter (CMD_APCI1710_InitIndex) once
+ * the driver sees it: index interrupt or CMD_APCI1710_GetIndexStatus.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg (b_ModulNbr)            : Module number (0 to 3).
+ *
+ * @param [out] arg (ll_Position)          : 64-bit extended position.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No counter module found.
+ * @retval 3: Counter not initialised see command "CMD_APCI1710_InitCounter".
+ * @retval 4: The counter is not in 32-bit mode.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_Read64BitCounterValue _IOWR(APCI1710_MAGIC, 124, int64_t)
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the counter extension sampler of the board.
+ *
+ * The sampler reads every 32-bit counter of the board, so the extended
+ * positions stay right however seldom the users read them. The period
+ * must be shorter than the time the fastest counter needs for 2^31 steps.
+ * The counters whose latch register 0 is used by the application are not
+ * read (see CMD_APCI1710_SetValueCacheSampler): the users must read them.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg[0] (ul_Period)          : Sampling period in us
+ *                                           (min APCI1710_COUNTER_EXTENSION_MIN_PERIOD). 0: stop the sampler.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetCounterExtensionPeriod _IOW(APCI1710_MAGIC, 125, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Cyclic scan program */
+
+/** Maximal number of instructions of a scan program. */
+#define APCI1710_SCAN_MAX_INSTRUCTIONS	64
+
+/** Number of registers of a scan program. */
+#define APCI1710_SCAN_NUMBER_OF_REGISTERS	16
+
+/** Minimal period of a scan program in us. */
+#define APCI1710_SCAN_MIN_PERIOD	50
+
+/* Scan instructions (b_OpCode) */
+
+/** R[b_Register] = value of the module b_ModulNbr:
+ * - Incremental counter: 32-bit counter value (i_APCI1710_Read32BitCounterValue).
+ * - SSI counter: position of the SSI b_Channel (0 to 2) (i_APCI1710_ReadAllSSIValue).
+ *   The cycle does not wait for the SSI transfer: it reads the conversion
+ *   started by the previous cycle and starts the next one. The position is
+ *   one period old, 0 in the first cycle, and a transfer longer than the
+ *   period keeps the previous position.
+ * - Digital I/O: port value (i_APCI1710_ReadDigitalIOPortValue).
+ * - TTL I/O: port register (i_APCI1710_ReadTTLIOAllPortValues).
+ */
+#define APCI1710_SCAN_READ		1
+/** R[b_Register] = (R[b_Register] <b_Channel condition> (int32_t) ul_Value) ? 1 : 0 */
+#define APCI1710_SCAN_COMPARE	2
+/** R[b_Register] = (R[b_Register] != 0) && (R[ul_Value] != 0) */
+#define APCI1710_SCAN_AND		3
+/** R[b_Register] = (R[b_Register] != 0) || (R[ul_Value] != 0) */
+#define APCI1710_SCAN_OR		4
+/** Set the output b_Channel of the module b_ModulNbr on if R[b_Register] != 0, else off:
+ * - Incremental counter: output H, b_Channel is not used (i_APCI1710_SetDigitalChlOn/Off).
+ * - Digital I/O: i_APCI1710_SetDigitalIOChlOn/Off.
+ * - TTL I/O: i_APCI1710_SetTTLIOChlOn/Off.
+ */
+#define APCI1710_SCAN_WRITE		5
+
+/** Conditions of APCI1710_SCAN_COMPARE (b_Channel), signed comparison. */
+#define APCI1710_SCAN_EQUAL			0
+#define APCI1710_SCAN_NOT_EQUAL		1
+#define APCI1710_SCAN_LESS			2
+#define APCI1710_SCAN_LESS_EQUAL	3
+#define APCI1710_SCAN_GREATER		4
+#define APCI1710_SCAN_GREATER_EQUAL	5
+
+/** One instruction of a scan program. */
+typedef struct
+{
+	uint8_t  b_OpCode;          /* APCI1710_SCAN_xxx                              */
+	uint8_t  b_ModulNbr;        /* Module of READ and WRITE (0 to 3)              */
+	uint8_t  b_Channel;         /* SSI, output channel or COMPARE condition       */
+	uint8_t  b_Register;        /* Register (0 to APCI1710_SCAN_NUMBER_OF_REGISTERS - 1) */
+	uint32_t ul_Value;          /* COMPARE constant or AND/OR second register     */
+} str_APCI1710_ScanInstruction;
+
+/** A scan program, executed by the kernel once per period. */
+typedef struct
+{
+	uint32_t ul_Period;                 /* Period in us, 0: stop the program   */
+	uint32_t ul_NumberOfInstructions;   /* Used entries of s_Instruction        */
+	str_APCI1710_ScanInstruction s_Instruction[APCI1710_SCAN_MAX_INSTRUCTIONS];
+} str_APCI1710_ScanProgram;
+
+/** State of the scan program of a board. */
+typedef struct
+{
+	uint32_t ul_Running;                /* 1: the program runs                                  */
+	uint32_t ul_Cycles;                 /* Executed cycles since the load                       */
+	uint32_t ul_Overruns;               /* Periods missed because a cycle was late              */
+	int32_t  i_Error;                   /* Error of the kernel function which stopped the program */
+	uint32_t ul_ErrorInstruction;       /* Index of the instruction which stopped the program   */
+	uint32_t ul_LastDuration;           /* Execution time of the last cycle in ns               */
+	uint32_t ul_MaxDuration;            /* Longest execution time of a cycle in ns              */
+	uint32_t ul_Reserved;
+	uint64_t ull_TimeStamp;             /* Monotonic time of the start of the last cycle in ns  */
+	int32_t  l_Register[APCI1710_SCAN_NUMBER_OF_REGISTERS]; /* Registers after the last cycle */
+} str_APCI1710_ScanStatus;
+
+//------------------------------------------------------------------------------
+
+/** Load a scan program and run it periodically in the kernel.
+ *
+ * Each period the instructions are executed in order, with the board
+ * locked, then the registers are published (CMD_APCI1710_GetScanStatus).
+ * The registers are cleared at load time and keep their values from one
+ * cycle to the next. The program is checked at load time; a kernel function
+ * failing at run time (for example a module initialised again with another
+ * configuration) stops the program and is reported in the status.
+ * A running program is replaced, a program with a period of 0 or without
+ * instruction stops it.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg (str_APCI1710_ScanProgram) : The program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The number of instructions is wrong.
+ * @retval 4: An instruction has a wrong opcode, register or condition.
+ * @retval 5: An instruction reads or writes a module which does not support it.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_LoadScanProgram _IOW(APCI1710_MAGIC, 126, str_APCI1710_ScanProgram)
+
+//------------------------------------------------------------------------------
+
+/** Return the state and the registers of the scan program.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ScanStatus) : The state of the program.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_GetScanStatus _IOR(APCI1710_MAGIC, 127, str_APCI1710_ScanStatus)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Software position compare of absolute encoder axes */
+
+/** Maximal number of position windows. */
+#define APCI1710_POSITION_COMPARE_MAX_WINDOWS	16
+
+/** Number of entries of the trigger log. */
+#define APCI1710_POSITION_TRIGGER_LOG_SIZE	64
+
+/** Minimal sampling period of the position compare in us. */
+#define APCI1710_POSITION_COMPARE_MIN_PERIOD	100
+
+/** Axis types (b_AxisType). */
+#define APCI1710_COMPARE_AXIS_SSI	1	/**< b_Channel: SSI counter (0 to 2)       */
+#define APCI1710_COMPARE_AXIS_BISS	2	/**< b_Channel: BiSS slave index            */
+#define APCI1710_COMPARE_AXIS_ENDAT	3	/**< b_Channel: EnDat channel (0 or 1)      */
+
+/** Interrupt mask of the position compare events.
+ * The value is the window index, bit 31 set when the position entered the window.
+ */
+#define APCI1710_POSITION_COMPARE_INTERRUPT 0x00400000UL
+
+/** One position window and the output it drives.
+ * The output is on while ull_Low <= position <= ull_High (off with b_Inverted).
+ * A threshold is a window with ull_High at 0xFFFFFFFFFFFFFFFF.
+ */
+typedef struct
+{
+	uint64_t ull_Low;
+	uint64_t ull_High;
+	uint8_t  b_OutputModule;    /* Digital I/O, TTL I/O or incremental counter module */
+	uint8_t  b_OutputChannel;   /* Output channel, not used for a counter module (output H) */
+	uint8_t  b_Inverted;        /* 1: output off inside the window                   */
+	uint8_t  b_Reserved[5];
+} str_APCI1710_PositionWindow;
+
+/** Position compare configuration of a board. */
+typedef struct
+{
+	uint8_t  b_AxisType;        /* APCI1710_COMPARE_AXIS_xxx                 */
+	uint8_t  b_ModulNbr;        /* Module of the axis (0 to 3)               */
+	uint8_t  b_Channel;         /* SSI counter, BiSS slave or EnDat channel  */
+	uint8_t  b_Reserved;
+	uint32_t ul_Period;         /* Sampling period in us, 0: stop            */
+	uint32_t ul_NumberOfWindows;
+	uint32_t ul_Reserved;
+	str_APCI1710_PositionWindow s_Window[APCI1710_POSITION_COMPARE_MAX_WINDOWS];
+} str_APCI1710_PositionCompare;
+
+/** One logged trigger. */
+typedef struct
+{
+	uint64_t ull_TimeStamp;     /* Monotonic time of the sample in ns        */
+	uint64_t ull_Position;      /* Position which caused the trigger         */
+	uint32_t ul_Window;         /* Window index                              */
+	uint32_t ul_Entered;        /* 1: entered the window, 0: left it         */
+} str_APCI1710_PositionTrigger;
+
+/** Trigger log of a board. */
+typedef struct
+{
+	uint32_t ul_NumberOfTriggers;   /* Valid entries of s_Trigger, oldest first      */
+	uint32_t ul_LostTriggers;       /* Triggers lost because the log was full        */
+	uint64_t ull_Samples;           /* Positions sampled since the configuration     */
+	uint64_t ull_Position;          /* Last sampled position                         */
+	int32_t  i_LastError;           /* Last error of a position read or output write */
+	uint32_t ul_Errors;             /* Number of failing reads and writes            */
+	str_APCI1710_PositionTrigger s_Trigger[APCI1710_POSITION_TRIGGER_LOG_SIZE];
+} str_APCI1710_PositionTriggers;
+
+//------------------------------------------------------------------------------
+
+/** Configure the software position compare of an absolute encoder axis.
+ *
+ * A kernel thread samples the position of the axis every period and
+ * compares it with the windows. When the position enters or leaves a window
+ * the output of the window is set or reset, the trigger is logged with the
+ * time of the sample (CMD_APCI1710_ReadPositionTriggers) and an
+ * APCI1710_POSITION_COMPARE_INTERRUPT event is delivered. The outputs are
+ * set according to the first sample. A new configuration replaces the
+ * running one; a period of 0 stops the compare.
+ * The SSI axes are read like CMD_APCI1710_ReadAllSSIValue without waiting
+ * for the conversion: each period reads the conversion started at the
+ * previous one, stamped with its start, and starts the next; a conversion
+ * not complete yet gives no sample for the period. The BiSS axes are read
+ * with the single cycle data read and the EnDat axes with the "send
+ * position value" command; these must be initialised first.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg (str_APCI1710_PositionCompare) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 5: The number of windows is wrong.
+ * @retval 6: A window is wrong (limits or output module).
+ * @retval 7: The sampling thread can not be started.
+ * @retval 8: The EnDat channel runs its position stream.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetPositionCompare _IOW(APCI1710_MAGIC, 128, str_APCI1710_PositionCompare)
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the trigger log of the position compare.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PositionTriggers) : The logged triggers.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_ReadPositionTriggers _IOR(APCI1710_MAGIC, 129, str_APCI1710_PositionTriggers)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Timed output scheduler */
+
+/** Maximal number of pending timed outputs of a board. */
+#define APCI1710_TIMED_OUTPUT_SCHEDULE_SIZE	64
+
+/** Maximal number of timed outputs queued by one command. */
+#define APCI1710_TIMED_OUTPUT_MAX_QUEUE	16
+
+/** Number of entries of the execution report log. */
+#define APCI1710_TIMED_OUTPUT_REPORT_SIZE	64
+
+/** One output change at an absolute time.
+ * The output is set with the function matching the module functionality:
+ * - Digital I/O: i_APCI1710_SetDigitalIOChlOn/Off (b_Channel: output channel).
+ * - TTL I/O: i_APCI1710_SetTTLIOChlOn/Off (b_Channel: output channel).
+ * - Pulse encoder: i_APCI1710_PulseEncoderSetDigitalOutputOn/Off (b_Channel not used).
+ * - Incremental counter: i_APCI1710_SetDigitalChlOn/Off (b_Channel not used).
+ */
+typedef struct
+{
+	uint64_t ull_Time;          /* CLOCK_MONOTONIC deadline in ns           */
+	uint8_t  b_ModulNbr;        /* Module (0 to 3)                          */
+	uint8_t  b_Channel;         /* Output channel                           */
+	uint8_t  b_On;              /* 1: set the output on, 0: off             */
+	uint8_t  b_Reserved;
+	uint32_t ul_Tag;            /* User value returned in the report        */
+} str_APCI1710_TimedOutput;
+
+/** Timed outputs to queue. */
+typedef struct
+{
+	uint32_t ul_NumberOfOutputs;
+	uint32_t ul_Reserved;
+	str_APCI1710_TimedOutput s_Output[APCI1710_TIMED_OUTPUT_MAX_QUEUE];
+} str_APCI1710_TimedOutputs;
+
+/** Execution report of one timed output. */
+typedef struct
+{
+	uint64_t ull_Time;          /* Requested time in ns                     */
+	uint64_t ull_ExecutionTime; /* CLOCK_MONOTONIC time of the write in ns  */
+	uint32_t ul_Tag;            /* ul_Tag of the timed output               */
+	int32_t  i_Error;           /* Error of the output function, 0: set     */
+} str_APCI1710_TimedOutputReport;
+
+/** Execution reports of a board. */
+typedef struct
+{
+	uint32_t ul_NumberOfReports;    /* Valid entries of s_Report, oldest first    */
+	uint32_t ul_LostReports;        /* Reports lost because the log was full      */
+	uint32_t ul_Pending;            /* Timed outputs not executed yet             */
+	uint32_t ul_Reserved;
+	str_APCI1710_TimedOutputReport s_Report[APCI1710_TIMED_OUTPUT_REPORT_SIZE];
+} str_APCI1710_TimedOutputReports;
+
+//------------------------------------------------------------------------------
+
+/** Queue output changes at absolute times.
+ *
+ * The kernel executes the outputs in time order from an hrtimer and logs
+ * the time each output was actually written (CMD_APCI1710_ReadTimedOutputReports).
+ * Outputs with a time already past are executed at once. All the outputs
+ * of the command are queued, or none.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg (str_APCI1710_TimedOutputs) : The outputs.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of outputs is wrong.
+ * @retval 3: An output module is wrong or has no output.
+ * @retval 4: Not enough room in the schedule.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_QueueTimedOutputs _IOW(APCI1710_MAGIC, 130, str_APCI1710_TimedOutputs)
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the execution reports of the timed outputs.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_TimedOutputReports) : The reports.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_ReadTimedOutputReports _IOR(APCI1710_MAGIC, 131, str_APCI1710_TimedOutputReports)
+
+//------------------------------------------------------------------------------
+
+/** Remove all the pending timed outputs.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+#define CMD_APCI1710_ClearTimedOutputs _IO(APCI1710_MAGIC, 132)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Board affinity */
+
+/** Highest number of CPUs of an affinity mask. */
+#define APCI1710_AFFINITY_MAX_CPUS	256
+
+/** Flags of str_APCI1710_Affinity.ul_Flags: masks to set. */
+#define APCI1710_AFFINITY_IRQ		0x1	/* ull_IrqCpuMask is set     */
+#define APCI1710_AFFINITY_WORKER	0x2	/* ull_WorkerCpuMask is set  */
+
+/** CPU affinity of a board.
+ * Bit n of word n/64 of a mask stands for the CPU n.
+ * An empty mask selects the CPUs of the NUMA node of the board.
+ */
+typedef struct
+{
+	uint32_t ul_Flags;          /* APCI1710_AFFINITY_IRQ | APCI1710_AFFINITY_WORKER */
+	int32_t  l_Node;            /* NUMA node of the board, -1: unknown (output)     */
+	uint64_t ull_IrqCpuMask    [APCI1710_AFFINITY_MAX_CPUS / 64]; /* Interrupt line */
+	uint64_t ull_WorkerCpuMask [APCI1710_AFFINITY_MAX_CPUS / 64]; /* Kernel threads */
+} str_APCI1710_Affinity;
+
+//------------------------------------------------------------------------------
+
+/** Set the CPUs serving the interrupt and the kernel threads of a board.
+ *
+ * The interrupt affinity is only set with a MSI vector: the INTx line may
+ * be shared with other devices and its affinity would move them too.
+ * The driver uses MSI when the board and the kernel support it and falls
+ * back to the INTx line otherwise.
+ * The worker threads (position compare) are moved at once.
+ * The hrtimer functions run on the CPU that started them: start them
+ * from a thread running on the worker CPUs.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in] arg (str_APCI1710_Affinity) : The masks to set.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Flags is wrong.
+ * @retval 3: A mask selects no online CPU.
+ * @retval 4: The interrupt affinity can not be set.
+ * @retval 5: APCI1710_AFFINITY_IRQ on a shared INTx line, nothing is changed.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetBoardAffinity _IOW(APCI1710_MAGIC, 133, str_APCI1710_Affinity)
+
+//------------------------------------------------------------------------------
+
+/** Return the NUMA node and the CPU affinity of a board.
+ *
+ * ull_IrqCpuMask is empty as long as the interrupt affinity was not set
+ * with CMD_APCI1710_SetBoardAffinity.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_Affinity) : The affinity, ul_Flags tells the masks set.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_GetBoardAffinity _IOR(APCI1710_MAGIC, 134, str_APCI1710_Affinity)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Board configuration */
+
+/** Version of str_APCI1710_BoardConfig. */
+#define APCI1710_BOARD_CONFIG_VERSION	1
+
+/** Flags of str_APCI1710_BoardConfig.ul_Flags. */
+#define APCI1710_CONFIG_INTERRUPT_ROUTINE	0x100	/* Install the interrupt routine (CMD_APCI1710_SetBoardIntRoutine) */
+
+/** Flags of str_APCI1710_ModuleConfig.ul_Flags: the initialisation steps of the module. */
+#define APCI1710_CONFIG_INIT		0x01	/* InitCounter, InitSSI, InitDigitalIO, InitTTLIODirection,
+                                           InitChrono, InitETM or InitPulseEncoder (see b_EncoderMask) */
+#define APCI1710_CONFIG_INPUT_FILTER	0x02	/* Incremental counter: SetInputFilter              */
+#define APCI1710_CONFIG_COMPARE_LOGIC	0x04	/* Incremental counter: InitCompareLogic            */
+#define APCI1710_CONFIG_INDEX		0x08	/* Incremental counter: InitIndex                   */
+#define APCI1710_CONFIG_REFERENCE	0x10	/* Incremental counter: InitReference               */
+#define APCI1710_CONFIG_OUTPUT_MEMORY	0x20	/* Digital I/O: SetDigitalIOMemoryOn                */
+
+/** Initialisation parameters of one module.
+ * The fields are the parameters of the matching initialisation commands.
+ */
+typedef struct
+{
+	uint32_t ul_Functionality;  /* Functionality of the module (APCI1710_INCREMENTAL_COUNTER...), 0: module not configured */
+	uint32_t ul_Flags;          /* APCI1710_CONFIG_* steps to apply, in the order of the flags */
+	union
+	{
+		struct
+		{
+			uint8_t  b_CounterRange;
+			uint8_t  b_FirstCounterModus;
+			uint8_t  b_FirstCounterOption;
+			uint8_t  b_SecondCounterModus;
+			uint8_t  b_SecondCounterOption;
+			uint8_t  b_PCIInputClock;      /* Input filter */
+			uint8_t  b_Filter;             /* Input filter */
+			uint8_t  b_ReferenceAction;    /* Index        */
+			uint8_t  b_IndexOperation;     /* Index        */
+			uint8_t  b_AutoMode;           /* Index        */
+			uint8_t  b_InterruptEnable;    /* Index        */
+			uint8_t  b_ReferenceLevel;     /* Reference    */
+			uint32_t ul_CompareValue;      /* Compare logic */
+		} s_Counter;
+
+		struct
+		{
+			uint8_t  b_SSIProfile;
+			uint8_t  b_PositionTurnLength;
+			uint8_t  b_TurnCptLength;
+			uint8_t  b_PCIInputClock;
+			uint8_t  b_SSICountingMode;
+			uint8_t  b_Reserved[3];
+			uint32_t ul_SSIOutputClock;
+		} s_SSI;
+
+		struct
+		{
+			uint8_t  b_ChannelAMode;
+			uint8_t  b_ChannelBMode;
+		} s_DigitalIO;
+
+		struct
+		{
+			uint8_t  b_PortMode[4];        /* Ports A to D, 0: input, 1: output */
+		} s_TTLIO;
+
+		struct
+		{
+			uint8_t  b_ChronoMode;
+			uint8_t  b_PCIInputClock;
+			uint8_t  b_TimingUnit;
+			uint8_t  b_Reserved;
+			uint32_t ul_TimingInterval;
+		} s_Chrono;
+
+		struct
+		{
+			uint8_t  b_ClockSelection;
+			uint8_t  b_TimingUnit;
+			uint8_t  b_Reserved[2];
+			uint32_t ul_Timing;
+		} s_ETM;
+
+		struct
+		{
+			uint8_t  b_EncoderMask;        /* Bit n set: the encoder n is initialised */
+			uint8_t  b_Reserved[3];
+			struct
+			{
+				uint8_t  b_InputLevelSelection;
+				uint8_t  b_TriggerOutputAction;
+				uint8_t  b_Reserved[2];
+				uint32_t ul_StartValue;
+			} s_Encoder[4];
+		} s_PulseEncoder;
+
+		uint32_t ul_Reserved[16];
+	} u;
+} str_APCI1710_ModuleConfig;
+
+/** Configuration of a whole board. */
+typedef struct
+{
+	uint32_t ul_Version;        /* APCI1710_BOARD_CONFIG_VERSION             */
+	uint32_t ul_Flags;          /* APCI1710_CONFIG_INTERRUPT_ROUTINE         */
+	str_APCI1710_ModuleConfig s_Module[4];
+	uint32_t ul_ErrorModule;    /* Apply error 4: module of the failing step (output)     */
+	uint32_t ul_ErrorStep;      /* Apply error 4: APCI1710_CONFIG_* failing step (output),
+	                               APCI1710_CONFIG_INTERRUPT_ROUTINE: the board step      */
+	int32_t  i_ErrorCode;       /* Apply error 4: error of the failing command (output)   */
+	uint32_t ul_Reserved;
+} str_APCI1710_BoardConfig;
+
+//------------------------------------------------------------------------------
+
+/** Validate and apply the configuration of a whole board in one call.
+ *
+ * The whole configuration is checked first: nothing is changed on
+ * errors 2 and 3. The interrupt routine is installed first, so that
+ * the index interrupt can be enabled, then the modules are initialised
+ * in order, each step calling the matching initialisation command.
+ * On error 4 the steps before the failing one stay applied,
+ * ul_ErrorModule, ul_ErrorStep and i_ErrorCode tell the failing step.
+ * Modules with ul_Functionality 0 are left as they are.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in,out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ * @retval 4: An initialisation step failed.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ */
+#define CMD_APCI1710_ApplyBoardConfig _IOWR(APCI1710_MAGIC, 135, str_APCI1710_BoardConfig)
+
+//------------------------------------------------------------------------------
+
+/** Return the current configuration of a board.
+ *
+ * The result has the format of CMD_APCI1710_ApplyBoardConfig:
+ * it holds the parameters of the initialisation commands that
+ * succeeded on each module, through this command or through the
+ * single initialisation commands. Applying it again restores the board.
+ *
+ * @param [in] fd                          : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+#define CMD_APCI1710_ReadBoardConfig _IOR(APCI1710_MAGIC, 136, str_APCI1710_BoardConfig)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Event replay */
+
+/** Maximum number of events of one CMD_APCI1710_ReplayEvents call. */
+#define APCI1710_REPLAY_MAX_EVENTS	256
+
+/** Set in the interrupt mask of the replayed events, in the FIFO record
+ * (CMD_APCI1710_TestInterrupt), the subscribed events and the kernel callback.
+ * A subscription mask without this bit still receives the replayed events
+ * of its interrupt sources.
+ */
+#define APCI1710_REPLAYED_INTERRUPT	0x80000000UL
+
+/** Recorded events to feed back to the board event delivery.
+ *
+ * A recording is the stream of str_APCI1710_Event read from a file
+ * subscribed to all the events (CMD_APCI1710_SubscribeEvents with
+ * b_ModuleMask 0xF and ul_InterruptMask 0). It is replayed in batches
+ * of APCI1710_REPLAY_MAX_EVENTS, ull_ReplayStart and ull_RecordStart
+ * keep the timing from one batch to the next one.
+ */
+typedef struct
+{
+	uint32_t ul_NumberOfEvents; /* Number of events in s_Event                              */
+	uint32_t ul_Speed;          /* 0: no delay between the events,
+	                               1: original timing, n: n times faster                   */
+	uint64_t ull_ReplayStart;   /* CLOCK_MONOTONIC time in ns of ull_RecordStart,
+	                               0: now, set by the driver (in/out)                      */
+	uint64_t ull_RecordStart;   /* Recorded time stamp replayed at ull_ReplayStart,
+	                               set to the first event time stamp by the driver
+	                               if ull_ReplayStart is 0 (in/out)                        */
+	uint32_t ul_Replayed;       /* Number of events replayed (output)                      */
+	uint32_t ul_Reserved;
+	str_APCI1710_Event s_Event[APCI1710_REPLAY_MAX_EVENTS];
+} str_APCI1710_EventReplay;
+
+//------------------------------------------------------------------------------
+
+/** Feed recorded events back to the board event delivery.
+ *
+ * Each event goes through the path of the interrupt events: the board
+ * FIFO (CMD_APCI1710_TestInterrupt), the subscribed files with a new
+ * time stamp, the kernel callback and SIGIO. The events are delivered
+ * at ull_ReplayStart + (ull_TimeStamp - ull_RecordStart) / ul_Speed,
+ * late events are delivered at once.
+ * The call blocks until the last event is delivered. A signal stops
+ * the replay, ul_Replayed tells the events delivered.
+ * The replayed events reach all the users of the board, like real
+ * interrupts, so the command requires CAP_SYS_ADMIN. Their interrupt
+ * mask has APCI1710_REPLAYED_INTERRUPT set.
+ * The removal of the board stops the replay.
+ *
+ * @param [in] fd                          : The device to use.
+ * @param [in,out] arg (str_APCI1710_EventReplay) : The events.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The module of an event is wrong, the events before it are replayed.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -ENODEV : The board is being removed.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ * @retval -ENOMEM : Not enough memory.
+ * @retval -EPERM : The caller does not have CAP_SYS_ADMIN.
+ */
+#define CMD_APCI1710_ReplayEvents _IOWR(APCI1710_MAGIC, 137, str_APCI1710_EventReplay)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* EnDat parameter cache */
+
+/** Read the parameters 0x0 - 0xF of a memory area once and keep them in the parameter cache.
+ *
+ * The areas that the sensor never changes by itself are cached (MRS-codes
+ * 0xA1 to 0xAF). CMD_APCI1711_EndatSensorSendParameter returns a cached
+ * parameter from the memory, without using the EnDat channel, and caches
+ * the parameters it reads after CMD_APCI1711_EndatSelectMemoryArea.
+ * CMD_APCI1711_EndatSelectMemoryArea is not sent again for the memory
+ * area already selected, a parameter write always selects its area again.
+ * Writing a parameter (CMD_APCI1711_EndatSensorReceiveParameter) removes it
+ * from the cache, resetting the sensor (CMD_APCI1711_EndatSensorReceiveReset,
+ * CMD_APCI1711_EndatInitialiseSensor) empties the cache.
+ *
+ * @param [in] fd                     : The device to use.
+ * @param [in] arg[0] (moduleIndex)   : Index of the slave (0->3)
+ * @param [in] arg[1] (channel)       : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mrsCode)       : The MRS-code of the memory area (0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF)
+ *
+ * @param [out] arg[3] (cachedMask)   : Bit n set: the parameter at address n is cached
+ *
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 mrsCode is incorrect
+ * @retval 4 the component is not programmed as EnDat
+ * @retval 5 the sensor is not initialised (initialise it and recall this function)
+ * @retval 6 Error while selecting the memory area
+ * @retval 7 timeout while reading a parameter
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ */
+#define CMD_APCI1711_EndatReadParameterArea _IOWR(APCI1710_MAGIC, 138, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* EnDat position stream */
+
+/** Number of records of the position stream of a channel. */
+#define APCI1711_ENDAT_STREAM_SIZE	1024
+
+/** Minimal acquisition period of the position stream in us. */
+#define APCI1711_ENDAT_STREAM_MIN_PERIOD	100
+
+/** Acquisition modes (ul_Mode). */
+#define APCI1711_ENDAT_STREAM_POSITION			1	/**< mode command 0x07, position only                 */
+#define APCI1711_ENDAT_STREAM_ADDITIONAL_DATA	2	/**< mode command 0x38, EnDat 2.2 position with additional data */
+
+/** Errors of a record (i_Error). */
+#define APCI1711_ENDAT_STREAM_TIMEOUT				1	/**< the sensor did not answer, the values are 0      */
+#define APCI1711_ENDAT_STREAM_TRANSMISSION_ERROR	2	/**< ul_ErrorBits has an error bit set (0x00000FDF)     */
+
+/** mmap page offset of the position stream of an EnDat channel (read only). */
+#define APCI1710_MMAP_ENDAT_STREAM(module,channel)	(1 + ((module) * 2) + (channel))
+
+/** One acquired position. */
+typedef struct
+{
+	uint64_t ull_TimeStamp;       /* Monotonic time of the command in ns          */
+	uint32_t ul_PositionLow;      /* Low bits of the position                     */
+	uint32_t ul_PositionHigh;     /* High bits of the position                    */
+	uint32_t ul_AdditionalData1;  /* Additional data 1 (0 in position mode)       */
+	uint32_t ul_AdditionalData2;  /* Additional data 2 (0 in position mode)       */
+	uint32_t ul_ErrorBits;        /* Content of the error register of the channel */
+	int32_t  i_Error;             /* 0 or APCI1711_ENDAT_STREAM_xxx error         */
+} str_APCI1711_EndatStreamRecord;
+
+/** Position stream of an EnDat channel, as mapped in user space.
+ *
+ * Record n is s_Record[n % ul_Size]. ul_Write counts the records written
+ * since the first start of the stream and is never reset, a reader keeps
+ * its own free running read index and checks that the record it copied was
+ * not overwritten meanwhile:
+ * @verbatim
+   while (ul_Read != ps_Stream->ul_Write)
+   {
+      __sync_synchronize ();
+      s_Copy = ps_Stream->s_Record [ul_Read % ps_Stream->ul_Size];
+      __sync_synchronize ();
+      if ((ps_Stream->ul_Write - ul_Read) > ps_Stream->ul_Size - 1)
+         ul_Read = ps_Stream->ul_Write - (ps_Stream->ul_Size - 1);   // overrun, s_Copy is lost
+      else
+         ul_Read++;                                                   // s_Copy is valid
+   }
+   @endverbatim
+ */
+typedef struct
+{
+	uint32_t ul_Write;            /* Free running number of written records       */
+	uint32_t ul_Size;             /* APCI1711_ENDAT_STREAM_SIZE                   */
+	uint32_t ul_Mode;             /* APCI1711_ENDAT_STREAM_xxx acquisition mode   */
+	uint32_t ul_Period;           /* Acquisition period in us, 0: stopped         */
+	uint32_t ul_PositionSize;     /* Size of the position in bits                 */
+	uint32_t ul_Errors;           /* Records with an error                        */
+	uint32_t ul_Overruns;         /* Periods skipped because the thread was late  */
+	uint32_t ul_Reserved[9];
+	str_APCI1711_EndatStreamRecord s_Record[APCI1711_ENDAT_STREAM_SIZE];
+} str_APCI1711_EndatStream;
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the position stream of an EnDat channel.
+ *
+ * A kernel thread sends the position command to the sensor every period
+ * and writes the position, the additional data and the error bits with
+ * the time of the command in the stream of the channel. The stream is
+ * mapped read only at the page APCI1710_MMAP_ENDAT_STREAM(module, channel)
+ * of the device (sizeof (str_APCI1711_EndatStream) bytes), it can be
+ * mapped once the stream has been started.
+ * The commands are not spaced by the 1 ms pause of the other EnDat commands;
+ * sensors that need it require a period of 1000 us or more.
+ * In APCI1711_ENDAT_STREAM_ADDITIONAL_DATA mode, the additional data must be
+ * selected first (CMD_APCI1711_EndatSelectAdditionalData).
+ * While the stream runs, the other EnDat commands of the channel fail with EBUSY.
+ * A new configuration replaces the running one; a period of 0 stops the stream.
+ *
+ * @param [in] fd                     : The device to use.
+ * @param [in] arg[0] (moduleIndex)   : Index of the slave (0->3)
+ * @param [in] arg[1] (channel)       : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mode)          : APCI1711_ENDAT_STREAM_POSITION or APCI1711_ENDAT_STREAM_ADDITIONAL_DATA
+ * @param [in] arg[3] (period)        : Acquisition period in us (min APCI1711_ENDAT_STREAM_MIN_PERIOD), 0: stop
+ *
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 the component is not programmed as EnDat
+ * @retval 4 mode is incorrect
+ * @retval 5 period is incorrect
+ * @retval 6 the sensor is not initialised (initialise it and recall this function)
+ * @retval 7 the sensor is not compatible with EnDat 2.2 commands
+ * @retval 8 the stream can not be allocated
+ * @retval 9 the acquisition thread can not be started
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1711_EndatSetPositionStream _IOW(APCI1710_MAGIC, 139, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* BiSS register transfers */
+
+/** Maximal number of register transfers of one operation. */
+#define APCI1710_BISS_MAX_TRANSFERS	16
+
+/** One register read or write. */
+typedef struct
+{
+	uint8_t  b_SlaveIndex;      /* Slave (sensor) index, as initialised                 */
+	uint8_t  b_Address;         /* Register address (0->127)                            */
+	uint8_t  b_Size;            /* Number of bytes (1->64)                              */
+	uint8_t  b_Write;           /* 1: write b_Data, 0: read into b_Data                 */
+	int32_t  i_Error;           /* Returned: error of the single cycle register read or
+	                               write (0: success), -1: not done                     */
+	uint8_t  b_Data[64];
+} str_APCI1710_BissRegisterTransfer;
+
+/** Register transfers on the slaves of a module. */
+typedef struct
+{
+	uint8_t  b_ModulNbr;        /* Module (0->3)                                        */
+	uint8_t  b_Reserved[3];
+	uint32_t ul_NumberOfTransfers; /* Used entries of s_Transfer (1->APCI1710_BISS_MAX_TRANSFERS) */
+	uint32_t ul_Done;           /* Returned: transfers done                             */
+	uint32_t ul_CacheHits;      /* Returned: reads served by the register cache         */
+	str_APCI1710_BissRegisterTransfer s_Transfer[APCI1710_BISS_MAX_TRANSFERS];
+} str_APCI1710_BissRegisterTransfers;
+
+//------------------------------------------------------------------------------
+
+/** Do several register reads and writes on the slaves of a module in one operation
+ *
+ * The transfers are done in the order of the list, like
+ * CMD_APCI1710_BissMasterSingleCycleRegisterRead and
+ * CMD_APCI1710_BissMasterSingleCycleRegisterWrite. The BiSS lock is released
+ * between two transfers, so that the data cycles of the other users are not
+ * delayed by the whole list. The static registers are returned from the
+ * register cache (see CMD_APCI1710_BissMasterSetStaticRegisters).
+ * The first failing transfer stops the operation.
+ *
+ * @param [in] fd                                   : The device to use.
+ * @param [in,out] arg (str_APCI1710_BissRegisterTransfers) : The transfers.
+ *
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid number of transfers
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval 5 : A transfer failed, see its i_Error. The following transfers are not done (i_Error -1)
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+#define CMD_APCI1710_BissMasterRegisterTransfer _IOWR(APCI1710_MAGIC, 140, str_APCI1710_BissRegisterTransfers)
+
+//------------------------------------------------------------------------------
+
+/** Declare the static registers of a slave
+ *
+ * The static registers are read on the bus once, then the register reads
+ * return them from the register cache, without a BiSS transfer.
+ * Writing a register removes it from the cache, writing the bank select
+ * register (0x40) removes the bank registers (0x00 - 0x3F). The
+ * initialisation and the release of the single cycle empty the cache.
+ * After the initialisation, the identification registers are static:
+ * profile ID and serial number (0x42 - 0x47), device ID and manufacturer ID
+ * (0x78 - 0x7F).
+ *
+ * @param [in] fd                       : The device to use.
+ * @param [in] arg[0] (moduleIndex)     : Index of the slave (0->3)
+ * @param [in] arg[1] (slaveIndex)      : Index of the slave (sensor), as initialised
+ * @param [in] arg[2-5] (staticMask)    : Bit n of arg[2 + n / 32] set: the register n is static
+ *
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_BissMasterSetStaticRegisters _IOW(APCI1710_MAGIC, 141, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+/* Coalescing of the event notifications */
+
+/** Maximal number of events per notification. */
+#define APCI1710_NOTIFY_MAX_EVENTS	1000
+
+/** Limits of the notification delay in us. */
+#define APCI1710_NOTIFY_MIN_DELAY	10
+#define APCI1710_NOTIFY_MAX_DELAY	1000000
+
+//------------------------------------------------------------------------------
+
+/** Set the coalescing of the event notifications of the board.
+ *
+ * Each event is recorded at once (interrupt FIFO, subscribed files), but
+ * the notifications - wake up of the files waiting in read() or poll(),
+ * user kernel callback and SIGIO - are sent once ul_MaxEvents events are
+ * pending or ul_Delay us have passed since the first pending event,
+ * whichever comes first. The readers then get the events in batches.
+ * The events pending when the setting changes are notified at once.
+ * By default, each event is notified.
+ *
+ * @param [in] fd                     : The device to use.
+ * @param [in] arg[0] (ul_MaxEvents)  : Events per notification (0 or 1: notify each event,
+ *                                      max APCI1710_NOTIFY_MAX_EVENTS).
+ * @param [in] arg[1] (ul_Delay)      : Maximal delay of a notification in us
+ *                                      (APCI1710_NOTIFY_MIN_DELAY to APCI1710_NOTIFY_MAX_DELAY),
+ *                                      not used if each event is notified.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The delay is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+#define CMD_APCI1710_SetNotificationCoalescing _IOW(APCI1710_MAGIC, 142, uint32_t*)
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
 /** Used internally. This is the ioctl CMD with the highest number.
  * @internal
  */
 
-#define __APCI1710_UPPER_IOCTL_CMD (102)
+#define __APCI1710_UPPER_IOCTL_CMD (142)
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -57,6 +57,20 @@ int do_CMD_APCI1710_SetBoardInformation(struct pci_dev * pdev, unsigned int cmd,
 
 //------------------------------------------------------------------------------
 
+/** Latch and read the initialised modules of all the boards in one call.
+ *
+ * @param [in] pdev              : The device to use (any board).
+ *
+ * @param [out] arg (str_APCI1710_Snapshot) : The snapshot.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadBoardsSnapshot (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
 /** Initialize the counter.
  *
  * Configure the counter operating mode from selected module (b_ModulNbr).
@@ -456,6 +470,38 @@ int do_CMD_APCI1710_Read32BitCounterValue (struct pci_dev *pdev, unsigned int cm
 
 //----------------------------------------------------------------------------
 
+/** Latch the 32-bit counter and return its 64-bit extended position.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg (b_ModulNbr)           : Module number (0 to 3).
+ *
+ * @param [out] arg (ll_Position)         : 64-bit extended position.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No counter module found.
+ * @retval 3: Counter not initialised see function "i_APCI1710_InitCounter".
+ * @retval 4: The counter is not in 32-bit mode.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_Read64BitCounterValue (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//----------------------------------------------------------------------------
+
+/** Start or stop the counter extension sampler.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (ul_Period)         : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetCounterExtensionPeriod (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//----------------------------------------------------------------------------
+
 /** Sets the digital output H.
  *
  * Sets the digital output H. Setting an output means setting an ouput high.
@@ -743,6 +789,27 @@ int do_CMD_APCI1710_SetDigitalIOPortOff (struct pci_dev *pdev, unsigned int cmd,
 
 //----------------------------------------------------------------------------
 
+/** Set and reset outputs of several digital I/O and TTL I/O modules at once.
+ *
+ * @param [in] pdev                          : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)         : Modules to write (bit n set: module n).
+ * @param [in] arg[1 + 2n] (ul_SetMask)      : Outputs to set on module n (n = 0 to 3).
+ * @param [in] arg[2 + 2n] (ul_ClearMask)    : Outputs to reset on module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not a digital I/O or TTL I/O module.
+ * @retval 4: A mask is wrong (channel not available or set and reset at once).
+ * @retval 5: A selected module is not initialised.
+ * @retval 6: A selected channel is used for input.
+ * @retval 7: Digital Output Memory OFF and outputs to reset. Use previously the function "i_APCI1710_SetDigitalIOMemoryOn".
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetDigitalOutputsMasked (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//----------------------------------------------------------------------------
+
 /** Configure the TTL I/O operating mode on the selected module.
  *  You must call this function before you call any other TTL function.
  *
@@ -824,6 +891,23 @@ int do_CMD_APCI1710_SetTTLIOChlOn (struct pci_dev *pdev, unsigned int cmd, unsig
  */
 int do_CMD_APCI1710_SetTTLIOChlOff (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
 
+//----------------------------------------------------------------------------
+
+/** Read all ports of all initialised TTL I/O modules of the board.
+ *
+ * @param [in] pdev                        : The device to use.
+ *
+ * @param [out] arg[0] (b_ModuleMask)      : Modules read (bit n set: module n).
+ * @param [out] arg[1 + n] (ul_PortValue)  : Port register of module n (n = 0 to 3).
+ * @param [out] arg[5 + n] (ul_InputMask)  : Input channels of module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised TTL I/O module on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadTTLIOAllPortValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
 //------------------------------------------------------------------------------
 
 /** Execute a command.
@@ -1085,6 +1169,80 @@ int do_CMD_APCI1710_ReadPulseEncoderValue (struct pci_dev *pdev, unsigned int cm
  */
 int do_CMD_APCI1710_WritePulseEncoderValue (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
 
+//------------------------------------------------------------------------------
+
+/** Queue start values for a pulse encoder, loaded by its underflow interrupt.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ * @param [in] arg[2] (ul_Count)          : Number of values (1 to APCI1710_PULSE_ENCODER_QUEUE_SIZE).
+ * @param [in] arg[3 + n] (ul_Value)      : Start values to queue (> 1).
+ *
+ * @param [out] arg[2] (ul_Queued)        : Number of values queued.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval 5: The number of values or a value is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_QueuePulseEncoderValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the state of the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ *
+ * @param [out] arg[0] (ul_Pending)       : Number of values still queued.
+ * @param [out] arg[1] (ul_Underruns)     : Interrupts which found the queue empty since the last call.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_GetPulseEncoderQueueStatus (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Empty the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_ClearPulseEncoderQueue (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the value and status of all initialised pulse encoders of the board.
+ *
+ * @param [in] pdev                       : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PulseEncoderValues) : The values and status.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised pulse encoder on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadAllPulseEncoderValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
 
 /** Set the digital output H on.
  *
@@ -1434,6 +1592,65 @@ int do_CMD_APCI1710_ReadChronoPortValue (struct pci_dev *pdev, unsigned int cmd,
 
 //------------------------------------------------------------------------------
 
+/** Select what the interrupt routine does with the measurements of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_Flags)            : Combination of APCI1710_CHRONO_STREAM,
+ *                                           APCI1710_CHRONO_STATISTICS and
+ *                                           APCI1710_CHRONO_NO_EVENT.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: Chronometer not initialised see function "i_APCI1710_InitChrono".
+ * @retval 5: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetChronoStream (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the measured values stored in the stream of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (ul_MaxCount)        : Size of arg[2 ...] (1 to APCI1710_CHRONO_STREAM_SIZE).
+ *
+ * @param [out] arg[0] (ul_Count)          : Number of values read.
+ * @param [out] arg[1] (ul_Lost)           : Values dropped since the last read.
+ * @param [out] arg[2 + n] (ul_Value)      : Measured values, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The stream is not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval 5: ul_MaxCount is wrong.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_ReadChronoStream (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the statistics of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in,out] arg (str_APCI1710_ChronoStatistics) : b_ModulNbr and b_Reset
+ *                                           select the module, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The statistics are not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_GetChronoStatistics (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
 /** Initialize the master and the slave(s) for single cycle read / write.
  * @param[in] deviceData				Pointer to the device
  * @param[in] moduleIndex				Index of the slave (0->3)
@@ -1538,6 +1755,31 @@ int do_CMD_APCI1710_BissMasterSingleCycleRegisterWrite(struct pci_dev *pdev, uns
  * */
 int do_CMD_APCI1710_BissMasterReleaseSingleCycle(struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
 
+/** Do several register reads and writes on the slaves of a module in one operation
+ * @param[in] deviceData				Pointer to the device
+ * @param[in,out] arg (str_APCI1710_BissRegisterTransfers)	The transfers
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid number of transfers
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval 5 : A transfer failed, see its i_Error. The following transfers are not done (i_Error -1)
+ * */
+int do_CMD_APCI1710_BissMasterRegisterTransfer(struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+/** Declare the static registers of a slave
+ * @param[in] deviceData				Pointer to the device
+ * @param[in] arg[0] (moduleIndex)		Index of the slave (0->3)
+ * @param[in] arg[1] (slaveIndex)		index of the slave(sensor) (depend of the index by the initialisation)
+ * @param[in] arg[2-5] (staticMask)		bit n of arg[2 + n / 32] set: the register n is static
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * */
+int do_CMD_APCI1710_BissMasterSetStaticRegisters(struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
 //------------------------------------------------------------------------------
 /** Initialise the EnDat sensor.
  * @param[in] pdev : Pointer to the device
@@ -1879,6 +2121,44 @@ int do_CMD_APCI1711_EndatSelectAdditionalData(struct pci_dev *pdev, unsigned int
  * @retval 20 transmission error
  */
 int do_CMD_APCI1711_EndatSensorSendPositionValueWithAdditionalData(struct pci_dev *pdev, unsigned int cmd, unsigned long arg); 
+
+/**
+ * Read the parameters 0x0 - 0xF of a memory area once and keep them in the parameter cache.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] arg[0] (moduleIndex) : Index of the slave (0->3)
+ * @param [in] arg[1] (channel) : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mrsCode) : The MRS-code of the memory area (0xA1, 0xA3, 0xA5, 0xA7, 0xA9, 0xAB, 0xAD, 0xAF)
+ * @param [out] arg[3] (cachedMask) : Bit n set: the parameter at address n is cached
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 mrsCode is incorrect
+ * @retval 4 the component is not programmed as EnDat
+ * @retval 5 the sensor is not initialised (initialise it and recall this function)
+ * @retval 6 Error while selecting the memory area
+ * @retval 7 timeout while reading a parameter
+ */
+int do_CMD_APCI1711_EndatReadParameterArea(struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+/**
+ * Start or stop the position stream of an EnDat channel.
+ * @param [in] pdev : Pointer to the device
+ * @param [in] arg[0] (moduleIndex) : Index of the slave (0->3)
+ * @param [in] arg[1] (channel) : Index of the EnDat channel (0,1)
+ * @param [in] arg[2] (mode) : APCI1711_ENDAT_STREAM_POSITION or APCI1711_ENDAT_STREAM_ADDITIONAL_DATA
+ * @param [in] arg[3] (period) : Acquisition period in us (min APCI1711_ENDAT_STREAM_MIN_PERIOD), 0: stop the stream
+ * @retval 0 success
+ * @retval 1 moduleIndex is incorrect
+ * @retval 2 channel is incorrect
+ * @retval 3 the component is not programmed as EnDat
+ * @retval 4 mode is incorrect
+ * @retval 5 period is incorrect
+ * @retval 6 the sensor is not initialised (initialise it and recall this function)
+ * @retval 7 the sensor is not compatible with EnDat 2.2 commands
+ * @retval 8 the stream can not be allocated
+ * @retval 9 the acquisition thread can not be started
+ */
+int do_CMD_APCI1711_EndatSetPositionStream(struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
 //------------------------------------------------------------------------------
 //SSI---------------------------------------------------------------------------
 
@@ -2210,6 +2490,332 @@ int do_CMD_APCI1710_READ (struct pci_dev *pdev, unsigned int cmd, unsigned long
 
 //------------------------------------------------------------------------------
 
+/** Return the latest values of the board.
+ *
+ * The board is not locked: the values are read from the value cache.
+ *
+ * @param [in] pdev                : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ValueCache) : The latest values.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadValueCache (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the kernel sampler of the value cache.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)    : Modules to sample (bit n set: module n).
+ * @param [in] arg[1] (ul_Period)       : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not an incremental counter, digital I/O or TTL I/O module.
+ * @retval 4: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetValueCacheSampler (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Select the input edges to detect on a digital I/O or TTL I/O module.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)      : Module number (0 to 3).
+ * @param [in] arg[1] (ul_RisingMask)   : Channels generating a rising edge event.
+ * @param [in] arg[2] (ul_FallingMask)  : Channels generating a falling edge event.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a digital I/O or TTL I/O module.
+ * @retval 4: The module is not initialised.
+ * @retval 5: A mask selects a channel which is not an input.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_InitEdgeDetection (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the edge detection sampler.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (ul_Period)       : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetEdgeDetectionPeriod (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the interrupts of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)      : Module number (0 to 3).
+ * @param [in] arg[1] (b_ETMNbr)        : ETM selection (0 or 1).
+ * @param [in] arg[2] (b_Flags)         : Combination of APCI1710_ETM_CAPTURE_RING,
+ *                                        APCI1710_ETM_CAPTURE_STATISTICS and
+ *                                        APCI1710_ETM_CAPTURE_NO_EVENT.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: ETM not initialised.
+ * @retval 6: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetETMCapture (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the records stored in the capture ring of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCapture) : b_ModulNbr, b_ETMNbr and ul_Count
+ *                                        select the ETM, ul_Count, ul_Lost and s_Record
+ *                                        are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The capture ring is not enabled.
+ * @retval 6: ul_Count is wrong.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadETMCapture (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Read the aggregates of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCaptureStatistics) : b_ModulNbr, b_ETMNbr and
+ *                                        b_Reset select the ETM, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The aggregates are not enabled.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_GetETMCaptureStatistics (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Load a scan program and run it periodically.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_ScanProgram) : The program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The number of instructions is wrong.
+ * @retval 4: An instruction has a wrong opcode, register or condition.
+ * @retval 5: An instruction reads or writes a module which does not support it.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_LoadScanProgram (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Return the state and the registers of the scan program.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ScanStatus) : State of the program.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_GetScanStatus (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Configure the software position compare of an absolute encoder axis.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_PositionCompare) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 5: The number of windows is wrong.
+ * @retval 6: A window is wrong (limits or output module).
+ * @retval 7: The sampling thread can not be started.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_SetPositionCompare (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the trigger log of the position compare.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PositionTriggers) : The logged triggers.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadPositionTriggers (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Queue output changes at absolute times.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_TimedOutputs) : The outputs.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of outputs is wrong.
+ * @retval 3: An output module is wrong or has no output.
+ * @retval 4: Not enough room in the schedule.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_QueueTimedOutputs (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the execution reports of the timed outputs.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_TimedOutputReports) : The reports.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadTimedOutputReports (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Remove all the pending timed outputs.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int do_CMD_APCI1710_ClearTimedOutputs (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Set the CPUs serving the interrupt and the kernel threads of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_Affinity) : The masks to set.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Flags is wrong.
+ * @retval 3: A mask selects no online CPU.
+ * @retval 4: The interrupt affinity can not be set.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_SetBoardAffinity (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Return the NUMA node and the CPU affinity of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_Affinity) : The affinity.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_GetBoardAffinity (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Validate and apply the configuration of a whole board in one call.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ * @retval 4: An initialisation step failed.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ */
+int do_CMD_APCI1710_ApplyBoardConfig (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Return the current configuration of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadBoardConfig (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Feed recorded events back to the board event delivery.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_EventReplay) : The events.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The module of an event is wrong.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReplayEvents (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
+/** Set the coalescing of the event notifications of the board.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (ul_MaxEvents)    : Events per notification (0 or 1: notify each event).
+ * @param [in] arg[1] (ul_Delay)        : Maximal delay of a notification in us.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The delay is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetNotificationCoalescing (struct pci_dev *pdev, unsigned int cmd, unsigned long arg);
+
+//------------------------------------------------------------------------------
+
 #ifdef WITH_BALISE_OPTION	
 
 /** Switch the balise off/on.
@@ -232,3 +232,68 @@ int do_CMD_APCI1710_BissMasterReleaseSingleCycle(struct pci_dev *pdev, unsigned
 		return i_APCI1711_BissMasterReleaseSingleCycle(pdev, moduleIndex);
 	return -ENOSYS;	// BiSS for APCI-1710 is not yet implemented
 }
+
+/** Do several register reads and writes on the slaves of a module in one operation
+ * @param[in] deviceData		Pointer to the device
+ * @param[in,out] arg (str_APCI1710_BissRegisterTransfers)	The transfers
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid number of transfers
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval 5 : A transfer failed, see its i_Error. The following transfers are not done (i_Error -1)
+ * @retval -EFAULT : Fail to retrieve or write user data
+ * @retval -ENOMEM : Not enough memory
+ * */
+int do_CMD_APCI1710_BissMasterRegisterTransfer(struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int returnValue;
+	str_APCI1710_BissRegisterTransfers * transfers = NULL;
+
+	if (pdev->device != apcie1711_BOARD_DEVICE_ID)
+		return -ENOSYS;	// BiSS for APCI-1710 is not yet implemented
+
+	transfers = kmalloc(sizeof(str_APCI1710_BissRegisterTransfers), GFP_KERNEL);
+	if (!transfers)
+		return -ENOMEM;
+
+	if (copy_from_user(transfers, (str_APCI1710_BissRegisterTransfers __user *)arg, sizeof(str_APCI1710_BissRegisterTransfers)))
+	{
+		kfree(transfers);
+		return -EFAULT;
+	}
+
+	returnValue = i_APCI1711_BissMasterRegisterTransfer(pdev, transfers);
+
+	/* the results of the transfers done are returned even if one failed */
+	if (copy_to_user((str_APCI1710_BissRegisterTransfers __user *)arg, transfers, sizeof(str_APCI1710_BissRegisterTransfers)))
+		returnValue = -EFAULT;
+
+	kfree(transfers);
+
+	return returnValue;
+}
+
+/** Declare the static registers of a slave
+ * @param[in] deviceData		Pointer to the device
+ * @param[in] arg[0] (moduleIndex)	Index of the slave (0->3)
+ * @param[in] arg[1] (slaveIndex)	index of the slave(sensor) (depend of the index by the initialisation)
+ * @param[in] arg[2-5] (staticMask)	bit n of arg[2 + n / 32] set: the register n is static
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * */
+int do_CMD_APCI1710_BissMasterSetStaticRegisters(struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	uint32_t argArray[6];
+	if (copy_from_user(argArray, (uint32_t __user *)arg, sizeof(argArray)))
+		return -EFAULT;
+	if (pdev->device == apcie1711_BOARD_DEVICE_ID)
+		return i_APCI1711_BissMasterSetStaticRegisters(pdev,
+		                                               (uint8_t)argArray[0],  // moduleIndex
+		                                               (uint8_t)argArray[1],  // slaveIndex
+		                                               &argArray[2]);         // staticMask[4]
+	return -ENOSYS;	// BiSS for APCI-1710 is not yet implemented
+}
@@ -45,6 +45,7 @@
  */
 
 #include "apci1710-private.h"
+#include "apci1710-trace.h"
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,11)
 	static spinlock_t spinlock_biss = SPIN_LOCK_UNLOCKED;
@@ -64,6 +65,8 @@ EXPORT_SYMBOL(i_APCI1711_BissMasterSingleCycleDataRead);
 EXPORT_SYMBOL(i_APCI1711_BissMasterSingleCycleRegisterRead);
 EXPORT_SYMBOL(i_APCI1711_BissMasterSingleCycleRegisterWrite);
 EXPORT_SYMBOL(i_APCI1711_BissMasterReleaseSingleCycle);
+EXPORT_SYMBOL(i_APCI1711_BissMasterRegisterTransfer);
+EXPORT_SYMBOL(i_APCI1711_BissMasterSetStaticRegisters);
 
 EXPORT_NO_SYMBOLS;
 
@@ -80,11 +83,260 @@ static int WaitMemReadyBit(void *address, uint32_t bit, uint32_t bitValue, uint3
     }
 }
 
+/* Write a command in the command register */
+static __inline__ void SendCommand(struct pci_dev *pdev, uint32_t command)
+{
+    trace_apci1710_biss_submit(pdev, command);
+    writel(command, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
+}
+
+/* Wait until a bit of the status register is set (EOT or TIMEOUT) */
+static __inline__ int WaitEndOfTransmission(struct pci_dev *pdev, uint32_t bit)
+{
+    int ret = WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, bit, 1, 500);
+    trace_apci1710_biss_eot(pdev, bit, ret);
+    return ret;
+}
+
 static int BreakCommand(struct pci_dev *pdev)
 {
     /* Send the break command and wait for acknowledgment */
-    writel(0x80, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
-    return WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 0, 1, 500) != 0 ? 1 : 0;
+    SendCommand(pdev, 0x80);
+    return WaitEndOfTransmission(pdev, 0) != 0 ? 1 : 0;
+}
+
+/* Registers of the slave identification, that never change:
+ * profile ID and serial number (0x42 - 0x47), device ID and manufacturer ID (0x78 - 0x7F) */
+static const uint32_t defaultStaticMask[4] = {0x00000000, 0x00000000, 0x000000FC, 0xFF000000};
+
+/* Test a register in a 128-bit register mask */
+#define BISS_REGISTER_IN_MASK(mask, address)	(((mask)[(address) / 32] >> ((address) % 32)) & 1)
+
+/** Check the parameters of a register access
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : Invalid address
+ * @retval 4 : Invalid size
+ * @retval 5 : the component is not programmed as Biss
+ * @retval 6 : Cycle acquisition not started
+ * @retval 7 : Slave (sensor) is not configured as Biss but as SSI
+ */
+static int CheckRegisterAccess(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, uint8_t address, uint8_t size)
+{
+	/* check the parameters */
+	if (moduleIndex > 3)
+		return 1;
+
+	if (slaveIndex >= APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount)
+		return 2;
+
+	if (address > 127)
+		return 3;
+
+	if (size < 1 || size > 64)
+		return 4;
+
+    /* confirm that the slave is configured for BiSS */
+    if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != APCI1710_BISS_MASTER)
+        return 5;
+
+	/* test if the single cycle acquisition is initialized */
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus == 0)
+		return 6;
+
+	/* test if the channel is configured as BiSS */
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelMode != 0 )
+		return 7;
+
+	return 0;
+}
+
+/** Read or write registers of a slave on the bus.
+ * spinlock_biss is held by the caller.
+ * @retval 0: success
+ * @retval 8 : Error while reading or writing the data
+ */
+static int SlaveRegisterTransfer(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, uint8_t address, uint8_t size, int write, uint8_t data[64])
+{
+	uint32_t registerContent = 0;
+	uint8_t  cpt = 0;
+
+	if (write)
+	{
+		/*
+		 * write the data that we will send
+		 * since we have 32 bits registers, we have to write them at the correct place
+		 * */
+		for (cpt = 0; cpt < size; cpt++)
+		{
+			registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
+			switch (cpt % 4)
+			{
+				case 0:
+					registerContent = (registerContent & 0xFFFFFF00) | data[cpt];
+					break;
+				case 1:
+					registerContent = (registerContent & 0xFFFF00FF) | (data[cpt] << 8);
+					break;
+				case 2:
+					registerContent = (registerContent & 0xFF00FFFF) | (data[cpt] << 16);
+					break;
+				case 3:
+					registerContent = (registerContent & 0x00FFFFFF) | (data[cpt] << 24);
+					break;
+			}
+			writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
+		}
+	}
+
+	/* select the address, the size and the direction */
+	writel((((size-1) & 0x3F) << 24) | (write ? 0x00800000 : 0) | ((address & 0x7F) << 16), APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 224);
+
+	/* command communication configuration. HOLDCMD = 0, MSEL = 1 */
+	registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
+	registerContent = (registerContent & 0xFFFF0000)
+		| (1 << 15)
+		| (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode << 14)
+		| ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].registerSlaveID & 0x7) << 11)
+		| (1 << APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channel);
+	writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
+
+	/* mode A/B ? */
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode == 0)
+	{
+		/* Command register access */
+		SendCommand(pdev, 0x8);
+
+		/* Wait EOT or TIMEOUT */
+		if (WaitEndOfTransmission(pdev, 2) != 0)
+		{
+			/* stop communication */
+			BreakCommand(pdev);
+			return 8;
+		}
+
+		registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
+	}
+	/* mode C */
+	else
+	{
+		unsigned long timeout = jiffies + msecs_to_jiffies(500);
+		for (;;)
+		{
+			/* Command register access */
+			SendCommand(pdev, 0x8);
+
+			/* Wait EOT or TIMEOUT */
+			if (WaitEndOfTransmission(pdev, 0) != 0)
+			{
+				/* stop communication */
+				BreakCommand(pdev);
+				return 8;
+			}
+
+			registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
+			if ((registerContent & 5) == 5)
+				break;
+			if (jiffies > timeout)
+			{
+				/* stop communication */
+				BreakCommand(pdev);
+				return 8;
+			}
+		}
+	}
+
+	/* check error bit */
+	if ((registerContent & 0x80) == 0)
+	{
+		/* stop communication */
+		BreakCommand(pdev);
+		return 8;
+	}
+
+	if (!write)
+	{
+		/* read the answer */
+		for (cpt = 0; cpt < size; cpt++)
+		{
+			if ((cpt % 4) == 0)
+				registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
+			data[cpt] = (uint8_t)(registerContent & 0xFF);
+			registerContent = registerContent >> 8;
+		}
+	}
+
+	return 0;
+}
+
+/** Return registers of a slave from the register cache.
+ * spinlock_biss is held by the caller.
+ * @retval 0: at least one register is not cached, data is not changed
+ * @retval 1: all the registers are cached and copied in data
+ */
+static int RegisterCacheRead(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, uint8_t address, uint8_t size, uint8_t data[64])
+{
+	const uint32_t *cachedMask = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].cachedMask;
+	uint8_t cpt = 0;
+
+	if ((address + size) > 128)
+		return 0;
+
+	for (cpt = 0; cpt < size; cpt++)
+	{
+		if (!BISS_REGISTER_IN_MASK(cachedMask, address + cpt))
+			return 0;
+	}
+
+	memcpy(data, &APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].registerCache[address], size);
+	return 1;
+}
+
+/** Update the register cache of a slave after a transfer.
+ * The static registers read are cached, the registers written are removed from the cache.
+ * Writing the bank select register (0x40) removes the bank registers (0x00 - 0x3F).
+ * spinlock_biss is held by the caller.
+ */
+static void RegisterCacheUpdate(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, uint8_t address, uint8_t size, int write, const uint8_t data[64])
+{
+	uint32_t *staticMask = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].staticMask;
+	uint32_t *cachedMask = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].cachedMask;
+	uint8_t *registerCache = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].registerCache;
+	uint32_t reg = 0;
+
+	for (reg = address; (reg < (uint32_t)(address + size)) && (reg < 128); reg++)
+	{
+		if (write)
+		{
+			cachedMask[reg / 32] &= ~(1 << (reg % 32));
+			if (reg == 0x40)
+			{
+				cachedMask[0] = 0;
+				cachedMask[1] = 0;
+			}
+		}
+		else if (BISS_REGISTER_IN_MASK(staticMask, reg))
+		{
+			registerCache[reg] = data[reg - address];
+			cachedMask[reg / 32] |= (1 << (reg % 32));
+		}
+	}
+}
+
+/** Empty the register cache of the slaves of a module and restore the default static registers.
+ * spinlock_biss is held by the caller.
+ */
+static void RegisterCacheReset(struct pci_dev *pdev, uint8_t moduleIndex)
+{
+	uint8_t cpt = 0;
+
+	for (cpt = 0; cpt < 6; cpt++)
+	{
+		memcpy(APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[cpt].staticMask, defaultStaticMask, sizeof(defaultStaticMask));
+		memset(APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[cpt].cachedMask, 0,
+		       sizeof(APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[cpt].cachedMask));
+	}
 }
 
 /** Initialise the master and the slave(s) for single cycle read / write.
@@ -252,10 +504,10 @@ int i_APCI1711_BissMasterInitSingleCycle(struct   pci_dev *pdev,
 		writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
 
 		/* initialise master - init command */
-		writel(0x10, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
+		SendCommand(pdev, 0x10);
 
 		/* wait */
-		if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 0, 1, 500) != 0)
+		if (WaitEndOfTransmission(pdev, 0) != 0)
 		{
 			/* timeout */
 			BreakCommand(pdev);
@@ -275,6 +527,9 @@ int i_APCI1711_BissMasterInitSingleCycle(struct   pci_dev *pdev,
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus = 1;
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount = nbrOfSlave;
 
+		/* the slaves may have changed */
+		RegisterCacheReset(pdev, moduleIndex);
+
 		/*Save the slaves information*/
 		for (cpt = 0; cpt < nbrOfSlave; cpt ++)
 		{
@@ -348,10 +603,10 @@ int i_APCI1711_BissMasterSingleCycleDataRead(struct  pci_dev *pdev,
 		uint8_t dataLength = APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].dataLength;
 
         /* command register COMMAND_GETSENS0 */
-        writel(0x4, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
+        SendCommand(pdev, 0x4);
 
         /* Wait EOT or TIMEOUT */
-        if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 0, 1, 500) != 0)
+        if (WaitEndOfTransmission(pdev, 0) != 0)
         {
             /* stop communication */
             BreakCommand(pdev);
@@ -386,6 +641,8 @@ int i_APCI1711_BissMasterSingleCycleDataRead(struct  pci_dev *pdev,
 }
 
 /** Do a single cycle read on the register of a slave
+ * The static registers (see i_APCI1711_BissMasterSetStaticRegisters) are read
+ * on the bus once, then they are returned from the register cache.
  * @param[in] deviceData		Pointer to the device
  * @param[in] moduleIndex		Index of the slave (0->3)
  * @param[in] slaveIndex		index of the slave(sensor) (depend of the index by the initialisation)
@@ -410,119 +667,24 @@ int i_APCI1711_BissMasterSingleCycleRegisterRead(struct  pci_dev *pdev,
                                                  uint8_t data[64])
 {
 	unsigned long flags;
+	int returnValue = CheckRegisterAccess(pdev, moduleIndex, slaveIndex, address, size);
 
-	/* check the parameters */
-	if (moduleIndex > 3)
-		return 1;
-
-	if (slaveIndex >= APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount)
-		return 2;
-
-	if (address > 127)
-		return 3;
-
-	if (size < 1 || size > 64)
-		return 4;
-
-    /* confirm that the slave is configured for BiSS */
-    if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != APCI1710_BISS_MASTER)
-        return 5;
-
-	/* test if the single cycle acquisition is initialized */
-	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus == 0)
-		return 6;
-
-	/* test if the channel is configured as BiSS */
-	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelMode != 0 )
-		return 7;
+	if (returnValue != 0)
+		return returnValue;
 
 	/* interrupt lock */
     spin_lock_irqsave(&spinlock_biss, flags);
 	{
-		uint32_t registerContent = 0;
-		uint8_t  cpt = 0;
-
-		/* select the address and the size that we want to read */
-		writel((((size-1) & 0x3F) << 24) | ((address & 0x7F) << 16), APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 224);
-
-		/* command communication configuration. HOLDCMD = 0, MSEL = 1 */
-		registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
-		registerContent = (registerContent & 0xFFFF0000)
-			| (1 << 15)
-			| (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode << 14)
-			| ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].registerSlaveID & 0x7) << 11)
-			| (1 << APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channel);
-		writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
-
-		/* mode A/B ? */
-		if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode == 0)
+		if (RegisterCacheRead(pdev, moduleIndex, slaveIndex, address, size, data) == 0)
 		{
-			/* Command register access */
-			writel(0x8, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
-
-			/* Wait EOT or TIMEOUT */
-			if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 2, 1, 500) != 0)
-			{
-				/* stop communication */
-				BreakCommand(pdev);
-				spin_unlock_irqrestore(&spinlock_biss, flags);
-				return 8;
-			}
-
-			registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
-		}
-		/* mode C */
-		else
-		{
-			unsigned long timeout = jiffies + msecs_to_jiffies(500);
-			for (;;)
-			{
-				/* Command register access */
-				writel(0x8, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
-
-				/* Wait EOT or TIMEOUT */
-				if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 0, 1, 500) != 0)
-				{
-					/* stop communication */
-					BreakCommand(pdev);
-					spin_unlock_irqrestore(&spinlock_biss, flags);
-					return 8;
-				}
-
-				registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
-				if ((registerContent & 5) == 5)
-					break;
-				if (jiffies > timeout)
-				{
-					/* stop communication */
-					BreakCommand(pdev);
-					spin_unlock_irqrestore(&spinlock_biss, flags);
-					return 8;
-				}
-			}
-		}
-
-		/* check error bit */
-		if ((registerContent & 0x80) == 0)
-		{
-			/* stop communication */
-			BreakCommand(pdev);
-			spin_unlock_irqrestore(&spinlock_biss, flags);
-			return 8;
-		}
-
-		/* read the answer */
-		for (cpt = 0; cpt < size; cpt++)
-		{
-			if ((cpt % 4) == 0)
-				registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
-			data[cpt] = (uint8_t)(registerContent & 0xFF);
-			registerContent = registerContent >> 8;
+			returnValue = SlaveRegisterTransfer(pdev, moduleIndex, slaveIndex, address, size, 0, data);
+			if (returnValue == 0)
+				RegisterCacheUpdate(pdev, moduleIndex, slaveIndex, address, size, 0, data);
 		}
 	}
     spin_unlock_irqrestore(&spinlock_biss, flags);
 
-	return 0;
+	return returnValue;
 }
 
 /** Do a single cycle write on the register of a slave
@@ -550,129 +712,143 @@ int i_APCI1711_BissMasterSingleCycleRegisterWrite(struct  pci_dev *pdev,
                                                   uint8_t data[64])
 {
 	unsigned long flags;
+	int returnValue = CheckRegisterAccess(pdev, moduleIndex, slaveIndex, address, size);
+
+	if (returnValue != 0)
+		return returnValue;
+
+	/* interrupt lock */
+	spin_lock_irqsave(&spinlock_biss, flags);
+	{
+		/* even a failed write may have changed the registers */
+		RegisterCacheUpdate(pdev, moduleIndex, slaveIndex, address, size, 1, data);
+		returnValue = SlaveRegisterTransfer(pdev, moduleIndex, slaveIndex, address, size, 1, data);
+	}
+	spin_unlock_irqrestore(&spinlock_biss, flags);
+
+	return returnValue;
+}
+
+/** Do several register reads and writes on the slaves of a module in one operation
+ * The transfers are done in the order of the list. The lock is released between
+ * two transfers, so that the data cycles of the other users are not delayed by
+ * the whole list. The static registers are returned from the register cache.
+ * The first failing transfer stops the operation.
+ * @param[in] deviceData		Pointer to the device
+ * @param[in,out] transfers		The transfers; i_Error, b_Data (reads), ul_Done and ul_CacheHits are returned
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid number of transfers
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * @retval 5 : A transfer failed, see its i_Error. The following transfers are not done (i_Error -1)
+ * */
+int i_APCI1711_BissMasterRegisterTransfer(struct pci_dev *pdev, str_APCI1710_BissRegisterTransfers *transfers)
+{
+	uint8_t moduleIndex = transfers->b_ModulNbr;
+	uint32_t cpt = 0;
+
+	transfers->ul_Done = 0;
+	transfers->ul_CacheHits = 0;
 
 	/* check the parameters */
 	if (moduleIndex > 3)
 		return 1;
 
-	if (slaveIndex >= APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount)
+	if ((transfers->ul_NumberOfTransfers < 1) || (transfers->ul_NumberOfTransfers > APCI1710_BISS_MAX_TRANSFERS))
 		return 2;
 
-	if (address > 127)
-		return 3;
-
-	if (size < 1 || size > 64)
-		return 4;
-
     /* confirm that the slave is configured for BiSS */
     if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != APCI1710_BISS_MASTER)
-        return 5;
+        return 3;
 
 	/* test if the single cycle acquisition is initialized */
 	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus == 0)
-		return 6;
+		return 4;
 
-	/* test if the channel is configured as biss */
-	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelMode != 0)
-		return 7;
+	for (cpt = 0; cpt < transfers->ul_NumberOfTransfers; cpt++)
+		transfers->s_Transfer[cpt].i_Error = -1;
 
-	/* interrupt lock */
-	spin_lock_irqsave(&spinlock_biss, flags);
+	for (cpt = 0; cpt < transfers->ul_NumberOfTransfers; cpt++)
 	{
-		uint32_t registerContent = 0;
-		uint8_t  cpt = 0;
-
-		/*
-		 * write the data that we will send
-		 * since we have 32 bits registers, we have to write them at the correct place
-		 * */
-		for (cpt = 0; cpt < size; cpt++)
-		{
-			registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
-			switch (cpt % 4)
-			{
-				case 0:
-					registerContent = (registerContent & 0xFFFFFF00) | data[cpt];
-					break;
-				case 1:
-					registerContent = (registerContent & 0xFFFF00FF) | (data[cpt] << 8);
-					break;
-				case 2:
-					registerContent = (registerContent & 0xFF00FFFF) | (data[cpt] << 16);
-					break;
-				case 3:
-					registerContent = (registerContent & 0x00FFFFFF) | (data[cpt] << 24);
-					break;
-			}
-			writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 128 + cpt);
-	   }
+		str_APCI1710_BissRegisterTransfer *transfer = &transfers->s_Transfer[cpt];
+		int write = (transfer->b_Write != 0);
+		unsigned long flags;
 
-		/* select the address and the size */
-		writel((((size-1) & 0x3F) << 24) | 0x00800000 | ((address & 0x7F) << 16), APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 224);
-		/* command communication configuration. HOLDCMD = 0, MSEL = 1*/
-		registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
-		registerContent = (registerContent & 0xFFFF0000)
-			| (1 << 15)
-			| (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode << 14)
-			| ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].registerSlaveID & 0x7) << 11)
-			| (1 << APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channel);
-		writel(registerContent, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 228);
+		transfer->i_Error = CheckRegisterAccess(pdev, moduleIndex, transfer->b_SlaveIndex, transfer->b_Address, transfer->b_Size);
+		if (transfer->i_Error != 0)
+			return 5;
 
-		/* mode A/B ? */
-		if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].channelBISSMode == 0)
+		/* interrupt lock, for one transfer */
+		spin_lock_irqsave(&spinlock_biss, flags);
 		{
-			/* Command register access */
-			writel(0x8, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
-
-			/* Wait EOT or TIMEOUT */
-			if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 2, 1, 500) != 0)
+			if (!write && RegisterCacheRead(pdev, moduleIndex, transfer->b_SlaveIndex, transfer->b_Address, transfer->b_Size, transfer->b_Data))
 			{
-				/* stop communication */
-				BreakCommand(pdev);
-				spin_unlock_irqrestore(&spinlock_biss, flags);
-				return 8;
+				transfers->ul_CacheHits++;
 			}
-
-			registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
-		}
-		/* mode C */
-		else
-		{
-			unsigned long timeout = jiffies + msecs_to_jiffies(500);
-			for (;;)
+			else
 			{
-				/* Command register access */
-				writel(0x8, APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 244);
-
-				/* Wait EOT or TIMEOUT */
-				if (WaitMemReadyBit(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240, 0, 1, 500) != 0)
-				{
-					/* stop communication */
-					BreakCommand(pdev);
-					spin_unlock_irqrestore(&spinlock_biss, flags);
-					return 8;
-				}
-
-				registerContent = readl(APCI1710_PRIVDATA(pdev)->memBaseAddress3 + 240);
-				if ((registerContent & 5) == 5)
-					break;
-				if (jiffies > timeout)
-				{
-					/* stop communication */
-					BreakCommand(pdev);
-					spin_unlock_irqrestore(&spinlock_biss, flags);
-					return 8;
-				}
+				if (write)
+					RegisterCacheUpdate(pdev, moduleIndex, transfer->b_SlaveIndex, transfer->b_Address, transfer->b_Size, 1, transfer->b_Data);
+
+				transfer->i_Error = SlaveRegisterTransfer(pdev, moduleIndex, transfer->b_SlaveIndex, transfer->b_Address, transfer->b_Size, write, transfer->b_Data);
+
+				if (!write && (transfer->i_Error == 0))
+					RegisterCacheUpdate(pdev, moduleIndex, transfer->b_SlaveIndex, transfer->b_Address, transfer->b_Size, 0, transfer->b_Data);
 			}
 		}
+		spin_unlock_irqrestore(&spinlock_biss, flags);
 
-		/* check error bit */
-		if ((registerContent & 0x80) == 0)
+		if (transfer->i_Error != 0)
+			return 5;
+
+		transfers->ul_Done++;
+	}
+
+	return 0;
+}
+
+/** Declare the static registers of a slave
+ * The static registers are read on the bus once, then they are returned from the
+ * register cache. The cached registers that are no longer static are removed from the cache.
+ * After the initialisation, the identification registers are static: profile ID and
+ * serial number (0x42 - 0x47), device ID and manufacturer ID (0x78 - 0x7F).
+ * @param[in] deviceData		Pointer to the device
+ * @param[in] moduleIndex		Index of the slave (0->3)
+ * @param[in] slaveIndex		index of the slave(sensor) (depend of the index by the initialisation)
+ * @param[in] staticMask		bit n (staticMask[n / 32], bit n % 32) set: the register n is static
+ * @retval 0: success
+ * @retval 1 : Invalid moduleIndex
+ * @retval 2 : Invalid slaveIndex
+ * @retval 3 : the component is not programmed as Biss
+ * @retval 4 : Cycle acquisition not started
+ * */
+int i_APCI1711_BissMasterSetStaticRegisters(struct pci_dev *pdev, uint8_t moduleIndex, uint8_t slaveIndex, const uint32_t staticMask[4])
+{
+	unsigned long flags;
+	uint8_t cpt = 0;
+
+	/* check the parameters */
+	if (moduleIndex > 3)
+		return 1;
+
+	if (slaveIndex >= APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount)
+		return 2;
+
+    /* confirm that the slave is configured for BiSS */
+    if (APCI1710_MODULE_FUNCTIONALITY(pdev, moduleIndex) != APCI1710_BISS_MASTER)
+        return 3;
+
+	/* test if the single cycle acquisition is initialized */
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus == 0)
+		return 4;
+
+	spin_lock_irqsave(&spinlock_biss, flags);
+	{
+		for (cpt = 0; cpt < 4; cpt++)
 		{
-			/* stop communication */
-			BreakCommand(pdev);
-			spin_unlock_irqrestore(&spinlock_biss, flags);
-			return 8;
+			APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].staticMask[cpt] = staticMask[cpt];
+			APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.slaveInfo[slaveIndex].cachedMask[cpt] &= staticMask[cpt];
 		}
 	}
 	spin_unlock_irqrestore(&spinlock_biss, flags);
@@ -704,6 +880,7 @@ int i_APCI1711_BissMasterReleaseSingleCycle(struct pci_dev *pdev, uint8_t module
 		/* save the initialization data in the structure */
         APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.singleCycleInitStatus = 0;
 		APCI1710_PRIVDATA(pdev)->s_ModuleInfo[moduleIndex].s_BissModuleInfo.initialisedSlaveCount = 0;
+		RegisterCacheReset(pdev, moduleIndex);
 	}
 	spin_unlock_irqrestore(&spinlock_biss, flags);
 
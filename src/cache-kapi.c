@@ -0,0 +1,269 @@
+/** @file cache-kapi.c
+ 
+   Contains the latest value cache kernel functions.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include "cache-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_ReadValueCache);
+EXPORT_SYMBOL(i_APCI1710_SetValueCacheSampler);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Read one module for the value cache sampler.
+ *
+ * The board lock is held. Modules that are not initialised are skipped,
+ * like the counters whose latch register 0 is used by the application.
+ * The read functions publish the value themselves.
+ */
+static void v_APCI1710_SampleModule (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+		{
+		case APCI1710_INCREMENTAL_COUNTER:
+			{
+			uint32_t ul_CounterValue = 0;
+
+			if (!apci1710_inc_cpt_latch0_in_use (pdev, b_ModulNbr))
+				i_APCI1710_Read32BitCounterValue (pdev, b_ModulNbr, &ul_CounterValue);
+			}
+			break;
+
+		case APCI1710_DIGITAL_IO:
+			{
+			uint8_t b_PortValue = 0;
+
+			i_APCI1710_ReadDigitalIOPortValue (pdev, b_ModulNbr, &b_PortValue);
+			}
+			break;
+
+		case APCI1710_TTL_IO:
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_TTLInit == 1)
+				{
+				uint32_t dw_StatusReg = 0;
+
+				INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
+
+				v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, dw_StatusReg & 0x03FFFFFFUL);
+				}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Value cache sampler, hrtimer callback. */
+static enum hrtimer_restart v_APCI1710_ValueCacheSampler (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_ValueCache.s_Timer);
+	struct pci_dev * pdev = ps_Board->pdev;
+	uint8_t b_ModulNbr = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr++)
+				if (ps_Board->s_ValueCache.b_ModuleMask & (1 << b_ModulNbr))
+					v_APCI1710_SampleModule (pdev, b_ModulNbr);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	hrtimer_forward_now (ps_Timer, ps_Board->s_ValueCache.kt_Period);
+
+	return HRTIMER_RESTART;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Allocate the value cache of a new board.
+ *
+ * @retval 0: No error.
+ * @retval -ENOMEM : Fail to allocate the cache page.
+ */
+int apci1710_value_cache_init (struct pci_dev *pdev)
+	{
+	str_ValueCacheInfos * ps_ValueCache = &(APCI1710_PRIVDATA(pdev)->s_ValueCache);
+
+	/* A whole page, so that it can be mapped in user space, on the node of the board */
+	{
+		struct page * ps_Page = alloc_pages_node (APCI1710_NODE(pdev), GFP_KERNEL | __GFP_ZERO, 0);
+		if (ps_Page == NULL)
+			return -ENOMEM;
+		ps_ValueCache->ps_Cache = (str_APCI1710_ValueCache *) page_address (ps_Page);
+	}
+
+	hrtimer_init (&ps_ValueCache->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ps_ValueCache->s_Timer.function = v_APCI1710_ValueCacheSampler;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Stop the sampler and free the value cache of a removed board.
+ *
+ * The page is only freed once the last user mapping is gone:
+ * apci1710_mmap_lookup maps it with vm_insert_page, which holds a reference.
+ */
+void apci1710_value_cache_release (struct pci_dev *pdev)
+	{
+	str_ValueCacheInfos * ps_ValueCache = &(APCI1710_PRIVDATA(pdev)->s_ValueCache);
+
+	if (ps_ValueCache->ps_Cache == NULL)
+		return;
+
+	hrtimer_cancel (&ps_ValueCache->s_Timer);
+
+	free_page ((unsigned long) ps_ValueCache->ps_Cache);
+	ps_ValueCache->ps_Cache = NULL;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return the latest values of the board.
+ *
+ * Lock free: this function does not lock the board and does not access
+ * the hardware. It can be called with or without the board lock.
+ *
+ * @param [in] pdev                : The device to use.
+ *
+ * @param [out] ps_Values          : Coherent copy of the value cache.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadValueCache (struct pci_dev *pdev, str_APCI1710_ValueCache * ps_Values)
+	{
+	str_APCI1710_ValueCache * ps_Cache = NULL;
+	uint32_t ul_Sequence = 0;
+
+	if (!pdev) return 1;
+
+	ps_Cache = APCI1710_PRIVDATA(pdev)->s_ValueCache.ps_Cache;
+
+	do
+		{
+		ul_Sequence = READ_ONCE (ps_Cache->ul_Sequence);
+		smp_rmb ();
+
+		*ps_Values = *ps_Cache;
+
+		smp_rmb ();
+		}
+	while ((ul_Sequence & 1) || (ul_Sequence != READ_ONCE (ps_Cache->ul_Sequence)));
+
+	ps_Values->ul_Sequence = ul_Sequence;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the kernel sampler of the value cache.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running sampler callback.
+ *
+ * @param [in] pdev                : The device to use.
+ * @param [in] b_ModuleMask        : Modules to sample (bit n set: module n).
+ * @param [in] ul_Period           : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not an incremental counter, digital I/O or TTL I/O module.
+ * @retval 4: The period is wrong.
+ */
+int i_APCI1710_SetValueCacheSampler (struct pci_dev *pdev, uint8_t b_ModuleMask, uint32_t ul_Period)
+	{
+	str_ValueCacheInfos * ps_ValueCache = NULL;
+	uint8_t b_ModulNbr = 0;
+
+	if (!pdev) return 1;
+
+	ps_ValueCache = &(APCI1710_PRIVDATA(pdev)->s_ValueCache);
+
+	/*************************/
+	/* Test the module mask  */
+	/*************************/
+
+	if ((b_ModuleMask >= (1 << NUMBER_OF_MODULE(pdev))) || ((b_ModuleMask == 0) && (ul_Period != 0)))
+		return 2;
+
+	for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr++)
+		{
+		if ((b_ModuleMask & (1 << b_ModulNbr)) == 0)
+			continue;
+
+		if ((APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_INCREMENTAL_COUNTER) &&
+		    (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_DIGITAL_IO) &&
+		    (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_TTL_IO))
+			return 3;
+		}
+
+	/*********************/
+	/* Test the period   */
+	/*********************/
+
+	if ((ul_Period != 0) && (ul_Period < APCI1710_VALUE_CACHE_MIN_PERIOD))
+		return 4;
+
+	/* Stop the running sampler */
+	hrtimer_cancel (&ps_ValueCache->s_Timer);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ps_ValueCache->b_ModuleMask = b_ModuleMask;
+			ps_ValueCache->kt_Period    = ns_to_ktime ((uint64_t) ul_Period * NSEC_PER_USEC);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if (ul_Period != 0)
+		hrtimer_start (&ps_ValueCache->s_Timer, ps_ValueCache->kt_Period, HRTIMER_MODE_REL);
+
+	return 0;
+	}
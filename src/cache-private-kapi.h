@@ -0,0 +1,38 @@
+#ifndef APCI1710_CACHE_PRIVATE_H_
+#define APCI1710_CACHE_PRIVATE_H_
+
+//------------------------------------------------------------------------------
+
+/** Publish the latest value of a module in the value cache.
+ *
+ * Must be called with the board lock held, that serialises the writers.
+ * The readers (lock free ioctl or read only mapping) retry while the
+ * sequence counter is odd or has changed during their copy.
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ * @param [in] ul_Value            : Value read from the module.
+ */
+static __inline__ void v_APCI1710_UpdateValueCache (struct pci_dev *pdev,
+                                                   uint8_t b_ModulNbr,
+                                                   uint32_t ul_Value)
+	{
+	str_APCI1710_ValueCache * ps_Cache = APCI1710_PRIVDATA(pdev)->s_ValueCache.ps_Cache;
+
+	if (ps_Cache == NULL)
+		return;
+
+	WRITE_ONCE (ps_Cache->ul_Sequence, ps_Cache->ul_Sequence + 1);
+	smp_wmb ();
+
+	ps_Cache->ul_Value[b_ModulNbr]      = ul_Value;
+	ps_Cache->ull_TimeStamp[b_ModulNbr] = APCI1710_TIMESTAMP();
+	ps_Cache->ul_ValidMask             |= (1 << b_ModulNbr);
+
+	smp_wmb ();
+	WRITE_ONCE (ps_Cache->ul_Sequence, ps_Cache->ul_Sequence + 1);
+	}
+
+//------------------------------------------------------------------------------
+
+#endif /*APCI1710_CACHE_PRIVATE_H_*/
@@ -0,0 +1,113 @@
+/** @file cache.c
+ 
+   Contains the latest value cache ioctl functions.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Return the latest values of the board.
+ *
+ * The board is not locked: the values are read from the value cache.
+ *
+ * @param [in] pdev                : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ValueCache) : The latest values.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadValueCache (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_ValueCache s_Values;
+
+	i_ErrorCode = i_APCI1710_ReadValueCache (pdev, &s_Values);
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (str_APCI1710_ValueCache __user *)arg, &s_Values, sizeof(s_Values) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the kernel sampler of the value cache.
+ *
+ * The board is locked by i_APCI1710_SetValueCacheSampler itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)    : Modules to sample (bit n set: module n).
+ * @param [in] arg[1] (ul_Period)       : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not an incremental counter, digital I/O or TTL I/O module.
+ * @retval 4: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetValueCacheSampler (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[2];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	if (dw_ArgArray[0] > 0xFF)
+		return 2;
+
+	i_ErrorCode = i_APCI1710_SetValueCacheSampler (pdev,
+	                                               (uint8_t) dw_ArgArray[0], // b_ModuleMask
+	                                               dw_ArgArray[1]);          // ul_Period
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
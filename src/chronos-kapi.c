@@ -46,6 +46,7 @@
 
 
 #include "apci1710-private.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitChrono);
 EXPORT_SYMBOL(i_APCI1710_EnableChrono);
@@ -56,11 +57,38 @@ EXPORT_SYMBOL(i_APCI1710_SetChronoChlOn);
 EXPORT_SYMBOL(i_APCI1710_SetChronoChlOff);
 EXPORT_SYMBOL(i_APCI1710_ReadChronoChlValue);
 EXPORT_SYMBOL(i_APCI1710_ReadChronoPortValue);
+EXPORT_SYMBOL(i_APCI1710_SetChronoStream);
+EXPORT_SYMBOL(i_APCI1710_ReadChronoStream);
+EXPORT_SYMBOL(i_APCI1710_GetChronoStatistics);
 
 EXPORT_NO_SYMBOLS;
 
 //------------------------------------------------------------------------------
 
+/* empties the stream and restarts the statistics of a chronometer, the flags are kept */
+static void v_APCI1710_ResetChronoStream (struct pci_dev *pdev, uint8_t b_ModulNbr)
+{
+	str_ChronoStreamInfos * ps_Stream = &APCI1710_PRIVDATA(pdev)->s_ChronoStream [b_ModulNbr];
+	uint8_t b_Flags = ps_Stream->b_Flags;
+
+	memset (ps_Stream, 0, sizeof (*ps_Stream));
+	ps_Stream->b_Flags = b_Flags;
+}
+
+/* returns the error code of the stream functions for this module, 0 if usable */
+static int i_APCI1710_TestChronoStream (struct pci_dev *pdev, uint8_t b_ModulNbr)
+{
+	if (b_ModulNbr >= APCI1710_PRIVDATA(pdev)->s_BoardInfos.b_NumberOfModule)
+		return 2;
+
+	if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_CHRONOMETER)
+		return 3;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
 /** Initialize chronos functionality.
  *
  * Configure the chronometer operating mode (b_ChronoMode)
@@ -234,6 +262,18 @@ int i_APCI1710_InitChrono (struct pci_dev *pdev,
 								s_ChronoModuleInfo.
 								b_TimingUnit = b_TimingUnit;
 
+								/******************************/
+								/* Save the base timing value */
+								/******************************/
+
+								APCI1710_PRIVDATA(pdev)->
+								s_ModuleInfo [(int)b_ModulNbr].
+								s_ChronoModuleInfo.
+								ul_TimingInterval = ul_TimingInterval;
+
+								/* New timing base: restart the stream and the statistics */
+								v_APCI1710_ResetChronoStream (pdev, b_ModulNbr);
+
 								/****************************/
 								/* Set the chronometer mode */
 								/****************************/
@@ -336,6 +376,15 @@ int i_APCI1710_InitChrono (struct pci_dev *pdev,
 			i_ReturnValue = 3;
 		}
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		ps_Config->u.s_Chrono.b_ChronoMode      = b_ChronoMode;
+		ps_Config->u.s_Chrono.b_PCIInputClock   = b_PCIInputClock;
+		ps_Config->u.s_Chrono.b_TimingUnit      = b_TimingUnit;
+		ps_Config->u.s_Chrono.ul_TimingInterval = ul_TimingInterval;
+		}
+
 	return (i_ReturnValue);
 }
 
@@ -548,6 +597,8 @@ int i_APCI1710_EnableChrono (struct pci_dev *pdev,
 		i_ReturnValue = 3;
 	}
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 }
 
@@ -669,6 +720,8 @@ int i_APCI1710_DisableChrono (struct pci_dev *pdev,
 		i_ReturnValue = 3;
 	}
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 }
 
@@ -1490,4 +1543,247 @@ int i_APCI1710_ReadChronoPortValue (struct pci_dev *pdev,
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the measurements of a chronometer.
+ *
+ * The stream and the statistics of the module are restarted.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] b_Flags                : Combination of APCI1710_CHRONO_STREAM,
+ *                                      APCI1710_CHRONO_STATISTICS and
+ *                                      APCI1710_CHRONO_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: Chronometer not initialised see function "i_APCI1710_InitChrono".
+ * @retval 5: The flags are wrong.
+ */
+int i_APCI1710_SetChronoStream (struct pci_dev *pdev,
+								uint8_t b_ModulNbr,
+								uint8_t b_Flags)
+{
+	int i_ReturnValue = 0;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestChronoStream (pdev, b_ModulNbr);
+	if (i_ReturnValue)
+		return i_ReturnValue;
+
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_ChronoModuleInfo.b_ChronoInit != 1)
+		return 4;
+
+	if (b_Flags & ~(APCI1710_CHRONO_STREAM | APCI1710_CHRONO_STATISTICS | APCI1710_CHRONO_NO_EVENT))
+		return 5;
+
+	APCI1710_PRIVDATA(pdev)->s_ChronoStream [b_ModulNbr].b_Flags = b_Flags;
+	v_APCI1710_ResetChronoStream (pdev, b_ModulNbr);
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the measured values stored in the stream of a chronometer.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] ul_MaxCount            : Size of pul_Values (1 to APCI1710_CHRONO_STREAM_SIZE).
+ *
+ * @param [out] pul_Count             : Number of values read.
+ * @param [out] pul_Lost              : Values dropped since the last read.
+ * @param [out] pul_Values            : Raw measured values, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The stream is not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval 5: ul_MaxCount is wrong.
+ */
+int i_APCI1710_ReadChronoStream (struct pci_dev *pdev,
+								 uint8_t b_ModulNbr,
+								 uint32_t ul_MaxCount,
+								 uint32_t *pul_Count,
+								 uint32_t *pul_Lost,
+								 uint32_t *pul_Values)
+{
+	int i_ReturnValue = 0;
+	str_ChronoStreamInfos * ps_Stream = NULL;
+
+	*pul_Count = 0;
+	*pul_Lost = 0;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestChronoStream (pdev, b_ModulNbr);
+	if (i_ReturnValue)
+		return i_ReturnValue;
+
+	ps_Stream = &APCI1710_PRIVDATA(pdev)->s_ChronoStream [b_ModulNbr];
 
+	if (!(ps_Stream->b_Flags & APCI1710_CHRONO_STREAM))
+		return 4;
+
+	if ((ul_MaxCount == 0) || (ul_MaxCount > APCI1710_CHRONO_STREAM_SIZE))
+		return 5;
+
+	while ((*pul_Count < ul_MaxCount) && (ps_Stream->ul_Read != ps_Stream->ul_Write))
+	{
+		pul_Values [*pul_Count] = ps_Stream->ul_Value [ps_Stream->ul_Read % APCI1710_CHRONO_STREAM_SIZE];
+		ps_Stream->ul_Read ++;
+		(*pul_Count) ++;
+	}
+
+	*pul_Lost = ps_Stream->ul_Lost;
+	ps_Stream->ul_Lost = 0;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the statistics of a chronometer.
+ *
+ * @param [in] pdev                   : The device to use.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] b_Reset                : 1: restart the statistics after the read.
+ *
+ * @param [out] ps_Statistics         : The statistics, in the timing unit of
+ *                                      "i_APCI1710_InitChrono".
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The statistics are not enabled see function "i_APCI1710_SetChronoStream".
+ */
+int i_APCI1710_GetChronoStatistics (struct pci_dev *pdev,
+									uint8_t b_ModulNbr,
+									uint8_t b_Reset,
+									str_APCI1710_ChronoStatistics *ps_Statistics)
+{
+	int i_ReturnValue = 0;
+	str_ChronoStreamInfos * ps_Stream = NULL;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestChronoStream (pdev, b_ModulNbr);
+	if (i_ReturnValue)
+		return i_ReturnValue;
+
+	ps_Stream = &APCI1710_PRIVDATA(pdev)->s_ChronoStream [b_ModulNbr];
+
+	if (!(ps_Stream->b_Flags & APCI1710_CHRONO_STATISTICS))
+		return 4;
+
+	*ps_Statistics = ps_Stream->s_Statistics;
+	ps_Statistics->b_ModulNbr = b_ModulNbr;
+	ps_Statistics->b_Reset = b_Reset;
+	ps_Statistics->ull_Mean = ps_Stream->ull_Mean;
+	if (ps_Statistics->ull_Count > 1)
+		ps_Statistics->ull_Variance = div64_u64 (ps_Stream->ull_M2, ps_Statistics->ull_Count - 1);
+
+	if (b_Reset)
+	{
+		memset (&ps_Stream->s_Statistics, 0, sizeof (ps_Stream->s_Statistics));
+		ps_Stream->ull_Mean = 0;
+		ps_Stream->ull_M2 = 0;
+	}
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Absolute difference of two values of the statistics. */
+static __inline__ uint64_t ull_APCI1710_ChronoDistance (uint64_t ull_A, uint64_t ull_B)
+{
+	return (ull_A >= ull_B) ? (ull_A - ull_B) : (ull_B - ull_A);
+}
+
+//------------------------------------------------------------------------------
+
+/** Account a chronometer measurement in the stream and the statistics of the module.
+ *
+ * Called by the interrupt function of the chronometer with the board lock held.
+ *
+ * @param [in] pdev                   : The device.
+ * @param [in] b_ModulNbr             : Module number (0 to 3).
+ * @param [in] ul_Value               : Raw measured value.
+ *
+ * @return 1 if the measurement must also be delivered as interrupt event, else 0.
+ */
+int i_APCI1710_ChronoStreamAdd (struct pci_dev *pdev,
+								uint8_t b_ModulNbr,
+								uint32_t ul_Value)
+{
+	str_ChronoStreamInfos * ps_Stream = &APCI1710_PRIVDATA(pdev)->s_ChronoStream [b_ModulNbr];
+	str_APCI1710_ChronoStatistics * ps_Statistics = &ps_Stream->s_Statistics;
+	uint64_t ull_Value = 0;
+	uint64_t ull_Delta = 0;
+	uint64_t ull_Delta2 = 0;
+	uint64_t ull_Square = 0;
+	int i_Bucket = 0;
+
+	if (ps_Stream->b_Flags & APCI1710_CHRONO_STREAM)
+	{
+		/* Full: drop the oldest value */
+		if ((ps_Stream->ul_Write - ps_Stream->ul_Read) >= APCI1710_CHRONO_STREAM_SIZE)
+		{
+			ps_Stream->ul_Read ++;
+			ps_Stream->ul_Lost ++;
+		}
+
+		ps_Stream->ul_Value [ps_Stream->ul_Write % APCI1710_CHRONO_STREAM_SIZE] = ul_Value;
+		ps_Stream->ul_Write ++;
+	}
+
+	if (ps_Stream->b_Flags & APCI1710_CHRONO_STATISTICS)
+	{
+		/* Value in the timing unit */
+		ull_Value = (uint64_t) ul_Value *
+		            APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_ChronoModuleInfo.ul_TimingInterval;
+
+		if ((ps_Statistics->ull_Count == 0) || (ull_Value < ps_Statistics->ull_Min))
+			ps_Statistics->ull_Min = ull_Value;
+		if (ull_Value > ps_Statistics->ull_Max)
+			ps_Statistics->ull_Max = ull_Value;
+
+		/* Welford's running mean and sum of squared deviations.
+		 * A value can use the 64 bits (32-bit measure * 32-bit timing value):
+		 * the mean moves by unsigned steps toward the value, so both
+		 * deviations have the same sign and only their magnitudes are used.
+		 */
+		ps_Statistics->ull_Count ++;
+		ull_Delta = ull_APCI1710_ChronoDistance (ull_Value, ps_Stream->ull_Mean);
+		if (ull_Value >= ps_Stream->ull_Mean)
+			ps_Stream->ull_Mean += div64_u64 (ull_Delta, ps_Statistics->ull_Count);
+		else
+			ps_Stream->ull_Mean -= div64_u64 (ull_Delta, ps_Statistics->ull_Count);
+		ull_Delta2 = ull_APCI1710_ChronoDistance (ull_Value, ps_Stream->ull_Mean);
+
+		/* The product and the sum saturate at 2^64 - 1 instead of wrapping */
+		if ((((ull_Delta | ull_Delta2) >> 32) != 0) &&
+		    (ull_Delta2 != 0) && (ull_Delta > div64_u64 (~0ULL, ull_Delta2)))
+			ull_Square = ~0ULL;
+		else
+			ull_Square = ull_Delta * ull_Delta2;
+
+		if (ull_Square > ~0ULL - ps_Stream->ull_M2)
+			ps_Stream->ull_M2 = ~0ULL;
+		else
+			ps_Stream->ull_M2 += ull_Square;
+
+		i_Bucket = fls64 (ull_Value);
+		if (i_Bucket >= APCI1710_CHRONO_HISTOGRAM_SIZE)
+			i_Bucket = APCI1710_CHRONO_HISTOGRAM_SIZE - 1;
+		ps_Statistics->ul_Histogram [i_Bucket] ++;
+	}
+
+	return !(ps_Stream->b_Flags & APCI1710_CHRONO_NO_EVENT);
+}
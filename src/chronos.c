@@ -535,6 +535,140 @@ int do_CMD_APCI1710_ReadChronoPortValue (struct pci_dev *pdev, unsigned int cmd,
 	return (i_ErrorCode);
 }
 
+/** Select what the interrupt routine does with the measurements of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (b_Flags)            : Combination of APCI1710_CHRONO_STREAM,
+ *                                           APCI1710_CHRONO_STATISTICS and
+ *                                           APCI1710_CHRONO_NO_EVENT.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: Chronometer not initialised see function "i_APCI1710_InitChrono".
+ * @retval 5: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetChronoStream (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[2];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_SetChronoStream (pdev,
+													  (uint8_t) dw_ArgArray[0],  // b_ModuleNbr
+													  (uint8_t) dw_ArgArray[1]); // b_Flags
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the measured values stored in the stream of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)         : Module number (0 to 3).
+ * @param [in] arg[1] (ul_MaxCount)        : Size of arg[2 ...] (1 to APCI1710_CHRONO_STREAM_SIZE).
+ *
+ * @param [out] arg[0] (ul_Count)          : Number of values read.
+ * @param [out] arg[1] (ul_Lost)           : Values dropped since the last read.
+ * @param [out] arg[2 + n] (ul_Value)      : Measured values, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The stream is not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval 5: ul_MaxCount is wrong.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_ReadChronoStream (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[2 + APCI1710_CHRONO_STREAM_SIZE];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, 2 * sizeof(uint32_t) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ReadChronoStream (pdev,
+													   (uint8_t) dw_ArgArray[0], // b_ModuleNbr
+													   dw_ArgArray[1],           // ul_MaxCount
+													   &dw_ArgArray[0],          // pul_Count
+													   &dw_ArgArray[1],          // pul_Lost
+													   &dw_ArgArray[2]);         // pul_Values
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (uint32_t __user *)arg , dw_ArgArray, (2 + dw_ArgArray[0]) * sizeof(uint32_t) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the statistics of a chronometer.
+ *
+ * @param [in] pdev                        : The device to use.
+ * @param [in,out] arg (str_APCI1710_ChronoStatistics) : b_ModulNbr and b_Reset
+ *                                           select the module, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The selected module is wrong.
+ * @retval 3: The module is not a chronos module.
+ * @retval 4: The statistics are not enabled see function "i_APCI1710_SetChronoStream".
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_GetChronoStatistics (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_ChronoStatistics s_Statistics;
+
+	if ( copy_from_user(&s_Statistics, (str_APCI1710_ChronoStatistics __user *)arg, sizeof(s_Statistics) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_GetChronoStatistics (pdev,
+														  s_Statistics.b_ModulNbr,
+														  s_Statistics.b_Reset,
+														  &s_Statistics);
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (str_APCI1710_ChronoStatistics __user *)arg , &s_Statistics, sizeof(s_Statistics) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
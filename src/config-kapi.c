@@ -0,0 +1,349 @@
+/** @file config-kapi.c
+ 
+   Whole board configuration (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_ApplyBoardConfig);
+EXPORT_SYMBOL(i_APCI1710_ReadBoardConfig);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Return the initialisation steps a functionality accepts. */
+static uint32_t ul_APCI1710_ConfigSteps (uint32_t ul_Functionality)
+	{
+	switch (ul_Functionality)
+		{
+		case APCI1710_INCREMENTAL_COUNTER:
+			return APCI1710_CONFIG_INIT | APCI1710_CONFIG_INPUT_FILTER | APCI1710_CONFIG_COMPARE_LOGIC |
+			       APCI1710_CONFIG_INDEX | APCI1710_CONFIG_REFERENCE;
+
+		case APCI1710_DIGITAL_IO:
+			return APCI1710_CONFIG_INIT | APCI1710_CONFIG_OUTPUT_MEMORY;
+
+		case APCI1710_SSI_COUNTER:
+		case APCI1710_TTL_IO:
+		case APCI1710_CHRONOMETER:
+		case APCI1710_ETM:
+		case APCI1710_PULSE_ENCODER:
+			return APCI1710_CONFIG_INIT;
+
+		default:
+			return 0;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Check a board configuration without touching the board.
+ *
+ * @retval 0: No error.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ */
+static int i_APCI1710_CheckBoardConfig (struct pci_dev *pdev,
+                                        const str_APCI1710_BoardConfig * ps_Config)
+	{
+	uint8_t b_ModulNbr = 0;
+
+	if (ps_Config->ul_Version != APCI1710_BOARD_CONFIG_VERSION)
+		return 2;
+
+	if (ps_Config->ul_Flags & ~APCI1710_CONFIG_INTERRUPT_ROUTINE)
+		return 2;
+
+	for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr ++)
+		{
+		const str_APCI1710_ModuleConfig * ps_Module = &ps_Config->s_Module[b_ModulNbr];
+
+		if (ps_Module->ul_Functionality == 0)
+			continue;
+
+		if ((b_ModulNbr >= NUMBER_OF_MODULE(pdev)) ||
+		    (ps_Module->ul_Functionality != APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr)))
+			return 3;
+
+		if (ps_Module->ul_Flags & ~ul_APCI1710_ConfigSteps (ps_Module->ul_Functionality))
+			return 3;
+
+		if ((ps_Module->ul_Functionality == APCI1710_PULSE_ENCODER) &&
+		    (ps_Module->ul_Flags & APCI1710_CONFIG_INIT) &&
+		    ((ps_Module->u.s_PulseEncoder.b_EncoderMask == 0) || (ps_Module->u.s_PulseEncoder.b_EncoderMask & ~0xF)))
+			return 3;
+		}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Apply the initialisation steps of one module.
+ *
+ * The board lock is held.
+ *
+ * @param [out] pul_Step             : The failing step.
+ *
+ * @return The error of the failing initialisation function, 0 if no error.
+ */
+static int i_APCI1710_ApplyModuleConfig (struct pci_dev *pdev,
+                                         uint8_t b_ModulNbr,
+                                         const str_APCI1710_ModuleConfig * ps_Module,
+                                         uint32_t * pul_Step)
+	{
+	int i_ReturnValue = 0;
+	uint8_t b_PulseEncoderNbr = 0;
+
+	switch (ps_Module->ul_Functionality)
+		{
+		case APCI1710_INCREMENTAL_COUNTER:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_INIT) &&
+			    ((i_ReturnValue = i_APCI1710_InitCounter (pdev, b_ModulNbr,
+			                                              ps_Module->u.s_Counter.b_CounterRange,
+			                                              ps_Module->u.s_Counter.b_FirstCounterModus,
+			                                              ps_Module->u.s_Counter.b_FirstCounterOption,
+			                                              ps_Module->u.s_Counter.b_SecondCounterModus,
+			                                              ps_Module->u.s_Counter.b_SecondCounterOption)) != 0))
+				return i_ReturnValue;
+
+			*pul_Step = APCI1710_CONFIG_INPUT_FILTER;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_INPUT_FILTER) &&
+			    ((i_ReturnValue = i_APCI1710_SetInputFilter (pdev, b_ModulNbr,
+			                                                 ps_Module->u.s_Counter.b_PCIInputClock,
+			                                                 ps_Module->u.s_Counter.b_Filter)) != 0))
+				return i_ReturnValue;
+
+			*pul_Step = APCI1710_CONFIG_COMPARE_LOGIC;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_COMPARE_LOGIC) &&
+			    ((i_ReturnValue = i_APCI1710_InitCompareLogic (pdev, b_ModulNbr,
+			                                                   ps_Module->u.s_Counter.ul_CompareValue)) != 0))
+				return i_ReturnValue;
+
+			*pul_Step = APCI1710_CONFIG_INDEX;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_INDEX) &&
+			    ((i_ReturnValue = i_APCI1710_InitIndex (pdev, b_ModulNbr,
+			                                            ps_Module->u.s_Counter.b_ReferenceAction,
+			                                            ps_Module->u.s_Counter.b_IndexOperation,
+			                                            ps_Module->u.s_Counter.b_AutoMode,
+			                                            ps_Module->u.s_Counter.b_InterruptEnable)) != 0))
+				return i_ReturnValue;
+
+			*pul_Step = APCI1710_CONFIG_REFERENCE;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_REFERENCE) &&
+			    ((i_ReturnValue = i_APCI1710_InitReference (pdev, b_ModulNbr,
+			                                                ps_Module->u.s_Counter.b_ReferenceLevel)) != 0))
+				return i_ReturnValue;
+			break;
+
+		case APCI1710_SSI_COUNTER:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_INIT)
+				i_ReturnValue = i_APCI1710_InitSSI (pdev, b_ModulNbr,
+				                                    ps_Module->u.s_SSI.b_SSIProfile,
+				                                    ps_Module->u.s_SSI.b_PositionTurnLength,
+				                                    ps_Module->u.s_SSI.b_TurnCptLength,
+				                                    ps_Module->u.s_SSI.b_PCIInputClock,
+				                                    ps_Module->u.s_SSI.ul_SSIOutputClock,
+				                                    ps_Module->u.s_SSI.b_SSICountingMode);
+			break;
+
+		case APCI1710_DIGITAL_IO:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if ((ps_Module->ul_Flags & APCI1710_CONFIG_INIT) &&
+			    ((i_ReturnValue = i_APCI1710_InitDigitalIO (pdev, b_ModulNbr,
+			                                                ps_Module->u.s_DigitalIO.b_ChannelAMode,
+			                                                ps_Module->u.s_DigitalIO.b_ChannelBMode)) != 0))
+				return i_ReturnValue;
+
+			*pul_Step = APCI1710_CONFIG_OUTPUT_MEMORY;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_OUTPUT_MEMORY)
+				i_ReturnValue = i_APCI1710_SetDigitalIOMemoryOn (pdev, b_ModulNbr);
+			break;
+
+		case APCI1710_TTL_IO:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_INIT)
+				i_ReturnValue = i_APCI1710_InitTTLIODirection (pdev, b_ModulNbr,
+				                                               ps_Module->u.s_TTLIO.b_PortMode[0],
+				                                               ps_Module->u.s_TTLIO.b_PortMode[1],
+				                                               ps_Module->u.s_TTLIO.b_PortMode[2],
+				                                               ps_Module->u.s_TTLIO.b_PortMode[3]);
+			break;
+
+		case APCI1710_CHRONOMETER:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_INIT)
+				i_ReturnValue = i_APCI1710_InitChrono (pdev, b_ModulNbr,
+				                                       ps_Module->u.s_Chrono.b_ChronoMode,
+				                                       ps_Module->u.s_Chrono.b_PCIInputClock,
+				                                       ps_Module->u.s_Chrono.b_TimingUnit,
+				                                       ps_Module->u.s_Chrono.ul_TimingInterval);
+			break;
+
+		case APCI1710_ETM:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_INIT)
+				i_ReturnValue = i_APCI1710_InitETM (pdev, b_ModulNbr,
+				                                    ps_Module->u.s_ETM.b_ClockSelection,
+				                                    ps_Module->u.s_ETM.b_TimingUnit,
+				                                    ps_Module->u.s_ETM.ul_Timing);
+			break;
+
+		case APCI1710_PULSE_ENCODER:
+			*pul_Step = APCI1710_CONFIG_INIT;
+			if (ps_Module->ul_Flags & APCI1710_CONFIG_INIT)
+				for (b_PulseEncoderNbr = 0; (b_PulseEncoderNbr < 4) && (i_ReturnValue == 0); b_PulseEncoderNbr ++)
+					if (ps_Module->u.s_PulseEncoder.b_EncoderMask & (1 << b_PulseEncoderNbr))
+						i_ReturnValue = i_APCI1710_InitPulseEncoder (pdev, b_ModulNbr, b_PulseEncoderNbr,
+						                                             ps_Module->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].b_InputLevelSelection,
+						                                             ps_Module->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].b_TriggerOutputAction,
+						                                             ps_Module->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].ul_StartValue);
+			break;
+		}
+
+	return i_ReturnValue;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Validate and apply the configuration of a whole board in one call.
+ *
+ * See CMD_APCI1710_ApplyBoardConfig.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in,out] ps_Config         : The configuration,
+ *                                     ul_ErrorModule, ul_ErrorStep and i_ErrorCode are set on error 4.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ * @retval 4: An initialisation step failed.
+ */
+int i_APCI1710_ApplyBoardConfig (struct pci_dev *pdev,
+                                 str_APCI1710_BoardConfig * ps_Config)
+	{
+	int i_ReturnValue = 0;
+	uint8_t b_ModulNbr = 0;
+	uint32_t ul_Step = 0;
+
+	if (!pdev)
+		return 1;
+
+	ps_Config->ul_ErrorModule = 0;
+	ps_Config->ul_ErrorStep   = 0;
+	ps_Config->i_ErrorCode    = 0;
+
+	i_ReturnValue = i_APCI1710_CheckBoardConfig (pdev, ps_Config);
+	if (i_ReturnValue)
+		return i_ReturnValue;
+
+	/* First, the index interrupt needs it */
+	if (ps_Config->ul_Flags & APCI1710_CONFIG_INTERRUPT_ROUTINE)
+		{
+		i_ReturnValue = i_APCI1710_SetBoardIntRoutine (pdev, NULL);
+		if (i_ReturnValue)
+			{
+			ps_Config->ul_ErrorStep = APCI1710_CONFIG_INTERRUPT_ROUTINE;
+			ps_Config->i_ErrorCode  = i_ReturnValue;
+			return 4;
+			}
+		}
+
+	for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr ++)
+		{
+		if (ps_Config->s_Module[b_ModulNbr].ul_Functionality == 0)
+			continue;
+
+		i_ReturnValue = i_APCI1710_ApplyModuleConfig (pdev, b_ModulNbr, &ps_Config->s_Module[b_ModulNbr], &ul_Step);
+		if (i_ReturnValue)
+			{
+			ps_Config->ul_ErrorModule = b_ModulNbr;
+			ps_Config->ul_ErrorStep   = ul_Step;
+			ps_Config->i_ErrorCode    = i_ReturnValue;
+			return 4;
+			}
+		}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return the current configuration of a board.
+ *
+ * See CMD_APCI1710_ReadBoardConfig.
+ * The initialisation functions of the modules record their parameters
+ * when they succeed (ps_APCI1710_RecordModuleInit and
+ * ps_APCI1710_RecordModuleStep), so the configuration returned here can
+ * be applied again with i_APCI1710_ApplyBoardConfig.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Config            : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadBoardConfig (struct pci_dev *pdev,
+                                str_APCI1710_BoardConfig * ps_Config)
+	{
+	uint8_t b_ModulNbr = 0;
+
+	if (!pdev)
+		return 1;
+
+	memset (ps_Config, 0, sizeof (str_APCI1710_BoardConfig));
+
+	ps_Config->ul_Version = APCI1710_BOARD_CONFIG_VERSION;
+
+	for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr ++)
+		{
+		memcpy (&ps_Config->s_Module[b_ModulNbr],
+		        &(APCI1710_PRIVDATA(pdev)->s_ModuleConfig[b_ModulNbr]),
+		        sizeof (str_APCI1710_ModuleConfig));
+
+		/* Set by i_APCI1710_SetBoardIntRoutine on the modules using interrupts */
+		if (APCI1710_PRIVDATA(pdev)->s_InterruptFunctionality[b_ModulNbr].v_InterruptFunction != NULL)
+			ps_Config->ul_Flags |= APCI1710_CONFIG_INTERRUPT_ROUTINE;
+		}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+#ifndef APCI1710_CONFIG_PRIVATE_H_
+#define APCI1710_CONFIG_PRIVATE_H_
+
+//------------------------------------------------------------------------------
+
+/* Recording of the module configurations, see i_APCI1710_ReadBoardConfig.
+ * All these functions are called with the board lock held.
+ */
+
+//------------------------------------------------------------------------------
+
+/** Start the recorded configuration of a module again after its main initialisation.
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ *
+ * @return The recorded configuration of the module.
+ */
+static __inline__ str_APCI1710_ModuleConfig * ps_APCI1710_RecordModuleInit (struct pci_dev *pdev,
+                                                                            uint8_t b_ModulNbr)
+	{
+	str_APCI1710_ModuleConfig * ps_Config = &(APCI1710_PRIVDATA(pdev)->s_ModuleConfig[b_ModulNbr]);
+
+	memset (ps_Config, 0, sizeof (str_APCI1710_ModuleConfig));
+	ps_Config->ul_Functionality = APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr);
+	ps_Config->ul_Flags         = APCI1710_CONFIG_INIT;
+
+	return ps_Config;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Add an initialisation step to the recorded configuration of a module.
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ * @param [in] ul_Step             : APCI1710_CONFIG_* step.
+ *
+ * @return The recorded configuration of the module.
+ */
+static __inline__ str_APCI1710_ModuleConfig * ps_APCI1710_RecordModuleStep (struct pci_dev *pdev,
+                                                                            uint8_t b_ModulNbr,
+                                                                            uint32_t ul_Step)
+	{
+	str_APCI1710_ModuleConfig * ps_Config = &(APCI1710_PRIVDATA(pdev)->s_ModuleConfig[b_ModulNbr]);
+
+	ps_Config->ul_Functionality = APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr);
+	ps_Config->ul_Flags        |= ul_Step;
+
+	return ps_Config;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Forget the recorded configuration of a module initialised in a mode
+ * the board configuration does not describe (e.g. raw SSI data).
+ */
+static __inline__ void v_APCI1710_ForgetModuleConfig (struct pci_dev *pdev,
+                                                      uint8_t b_ModulNbr)
+	{
+	memset (&(APCI1710_PRIVDATA(pdev)->s_ModuleConfig[b_ModulNbr]), 0, sizeof (str_APCI1710_ModuleConfig));
+	}
+
+//------------------------------------------------------------------------------
+
+#endif /*APCI1710_CONFIG_PRIVATE_H_*/
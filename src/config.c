@@ -0,0 +1,117 @@
+/** @file config.c
+ 
+   Whole board configuration (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Validate and apply the configuration of a whole board in one call.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: ul_Version or ul_Flags is wrong.
+ * @retval 3: A module functionality or flag does not match the board.
+ * @retval 4: An initialisation step failed.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ */
+int do_CMD_APCI1710_ApplyBoardConfig (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_BoardConfig s_Config;
+
+	if ( copy_from_user(&s_Config, (str_APCI1710_BoardConfig __user *)arg, sizeof(str_APCI1710_BoardConfig) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ApplyBoardConfig (pdev, &s_Config);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	/* Return the failing step */
+	if ( copy_to_user( (str_APCI1710_BoardConfig __user *)arg, &s_Config, sizeof(str_APCI1710_BoardConfig) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the current configuration of a board.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_BoardConfig) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadBoardConfig (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_BoardConfig s_Config;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_APCI1710_ReadBoardConfig (pdev, &s_Config);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if ( copy_to_user( (str_APCI1710_BoardConfig __user *)arg, &s_Config, sizeof(str_APCI1710_BoardConfig) ) )
+		return -EFAULT;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+/** @file counter64-kapi.c
+ 
+   64-bit extended position of the 32-bit incremental counters (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include "counter64-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_Read64BitCounterValue);
+EXPORT_SYMBOL(i_APCI1710_SetCounterExtensionPeriod);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Test if a module is an initialised incremental counter in 32-bit mode. */
+static int i_APCI1710_Is32BitCounter (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	return (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) == APCI1710_INCREMENTAL_COUNTER) &&
+	       (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_CounterInit == 1) &&
+	       ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister1 & APCI1710_16BIT_COUNTER) == 0);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Counter extension sampler, hrtimer callback.
+ *
+ * Reads every 32-bit counter of the board often enough to never miss
+ * a wraparound between two reads of the users. The counters whose latch
+ * register 0 is used by the application are left to the reads of the users.
+ */
+static enum hrtimer_restart v_APCI1710_CounterExtensionSampler (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_CounterExtension.s_Timer);
+	struct pci_dev * pdev = ps_Board->pdev;
+	uint8_t b_ModulNbr = 0;
+	uint32_t ul_CounterValue = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr++)
+				if (i_APCI1710_Is32BitCounter (pdev, b_ModulNbr) &&
+				    !apci1710_inc_cpt_latch0_in_use (pdev, b_ModulNbr))
+					i_APCI1710_Read32BitCounterValue (pdev, b_ModulNbr, &ul_CounterValue);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	hrtimer_forward_now (ps_Timer, ps_Board->s_CounterExtension.kt_Period);
+
+	return HRTIMER_RESTART;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the counter extension sampler of a new board. */
+void apci1710_counter_extension_init (struct pci_dev *pdev)
+	{
+	str_CounterExtensionInfos * ps_Extension = &(APCI1710_PRIVDATA(pdev)->s_CounterExtension);
+
+	hrtimer_init (&ps_Extension->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ps_Extension->s_Timer.function = v_APCI1710_CounterExtensionSampler;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Latch the 32-bit counter and return its 64-bit extended position.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ *
+ * @param [out] pll_Position     : 64-bit extended position.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No counter module found.
+ * @retval 3: Counter not initialised see function "i_APCI1710_InitCounter".
+ * @retval 4: The counter is not in 32-bit mode.
+ */
+int i_APCI1710_Read64BitCounterValue (struct pci_dev *pdev,
+                                      uint8_t b_ModulNbr,
+                                      int64_t * pll_Position)
+	{
+	uint32_t ul_CounterValue = 0;
+	int i_ReturnValue = 0;
+
+	if (!pdev) return 1;
+
+	if ((b_ModulNbr >= NUMBER_OF_MODULE(pdev)) ||
+	    (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_INCREMENTAL_COUNTER))
+		return 2;
+
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_CounterInit != 1)
+		return 3;
+
+	/* A 16-bit counter is not latched at all */
+	if (!i_APCI1710_Is32BitCounter (pdev, b_ModulNbr))
+		return 4;
+
+	i_ReturnValue = i_APCI1710_Read32BitCounterValue (pdev, b_ModulNbr, &ul_CounterValue);
+	if (i_ReturnValue != 0)
+		return i_ReturnValue;
+
+	*pll_Position = APCI1710_PRIVDATA(pdev)->s_CounterExtension.ll_Position [b_ModulNbr];
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the counter extension sampler.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running sampler callback.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ul_Period             : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ */
+int i_APCI1710_SetCounterExtensionPeriod (struct pci_dev *pdev, uint32_t ul_Period)
+	{
+	str_CounterExtensionInfos * ps_Extension = NULL;
+
+	if (!pdev) return 1;
+
+	if ((ul_Period != 0) && (ul_Period < APCI1710_COUNTER_EXTENSION_MIN_PERIOD))
+		return 2;
+
+	ps_Extension = &(APCI1710_PRIVDATA(pdev)->s_CounterExtension);
+
+	/* Stop the running sampler */
+	hrtimer_cancel (&ps_Extension->s_Timer);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ps_Extension->kt_Period = ns_to_ktime ((uint64_t) ul_Period * NSEC_PER_USEC);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if (ul_Period != 0)
+		hrtimer_start (&ps_Extension->s_Timer, ps_Extension->kt_Period, HRTIMER_MODE_REL);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
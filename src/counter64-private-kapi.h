@@ -0,0 +1,75 @@
+#ifndef APCI1710_COUNTER64_PRIVATE_H_
+#define APCI1710_COUNTER64_PRIVATE_H_
+
+//------------------------------------------------------------------------------
+
+/** Extend a raw 32-bit counter value to the 64-bit position of the module.
+ *
+ * Must be called with the board lock held on every read of the counter.
+ * The difference with the previous raw value is taken as a signed 32-bit
+ * step, so the counter must not move by more than 2^31 between two reads;
+ * the background sampler (i_APCI1710_SetCounterExtensionPeriod) guarantees
+ * it when the users read seldom. The first value after an initialisation,
+ * a clear or a write of the counter starts the position.
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ * @param [in] ul_Value            : Raw 32-bit counter value.
+ */
+static __inline__ void v_APCI1710_ExtendCounterValue (struct pci_dev *pdev,
+                                                      uint8_t b_ModulNbr,
+                                                      uint32_t ul_Value)
+	{
+	str_CounterExtensionInfos * ps_Extension = &(APCI1710_PRIVDATA(pdev)->s_CounterExtension);
+
+	if (ps_Extension->b_ValidMask & (1 << b_ModulNbr))
+		ps_Extension->ll_Position[b_ModulNbr] += (int32_t) (ul_Value - ps_Extension->ul_LastValue[b_ModulNbr]);
+	else
+		ps_Extension->ll_Position[b_ModulNbr] = ul_Value;
+
+	ps_Extension->ul_LastValue[b_ModulNbr] = ul_Value;
+	ps_Extension->b_ValidMask |= (1 << b_ModulNbr);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Restart the 64-bit position of a module at its next read.
+ *
+ * Must be called with the board lock held when the counter is
+ * initialised, cleared or written.
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ */
+static __inline__ void v_APCI1710_ResetCounterExtension (struct pci_dev *pdev,
+                                                         uint8_t b_ModulNbr)
+	{
+	APCI1710_PRIVDATA(pdev)->s_CounterExtension.b_ValidMask &= ~(1 << b_ModulNbr);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Restart the 64-bit position of a module when its index occurred.
+ *
+ * Must be called with the board lock held when an index is reported
+ * (index interrupt or i_APCI1710_GetIndexStatus). The position restarts
+ * only if the index clears the counter (see i_APCI1710_InitIndex).
+ *
+ * @param [in] pdev                : The device.
+ * @param [in] b_ModulNbr          : Module number (0 to 3).
+ */
+static __inline__ void v_APCI1710_IndexCounterExtension (struct pci_dev *pdev,
+                                                         uint8_t b_ModulNbr)
+	{
+	uint8_t b_ModeRegister2 = APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister2;
+	uint8_t b_ModeRegister4 = APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister4;
+
+	/* Clear only, or latch and clear */
+	if (((b_ModeRegister2 & APCI1710_INDEX_LATCH_COUNTER) == 0) ||
+	    (b_ModeRegister4 & APCI1710_ENABLE_LATCH_AND_CLEAR))
+		v_APCI1710_ResetCounterExtension (pdev, b_ModulNbr);
+	}
+
+//------------------------------------------------------------------------------
+
+#endif /*APCI1710_COUNTER64_PRIVATE_H_*/
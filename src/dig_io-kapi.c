@@ -46,6 +46,8 @@
  
 
 #include "apci1710-private.h"
+#include "cache-private-kapi.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitDigitalIO);
 EXPORT_SYMBOL(i_APCI1710_ReadDigitalIOChlValue);
@@ -56,6 +58,7 @@ EXPORT_SYMBOL(i_APCI1710_SetDigitalIOChlOn);
 EXPORT_SYMBOL(i_APCI1710_SetDigitalIOChlOff);
 EXPORT_SYMBOL(i_APCI1710_SetDigitalIOPortOn);
 EXPORT_SYMBOL(i_APCI1710_SetDigitalIOPortOff);
+EXPORT_SYMBOL(i_APCI1710_SetDigitalOutputsMasked);
 		
 EXPORT_NO_SYMBOLS;
 //------------------------------------------------------------------------------
@@ -189,6 +192,13 @@ int   i_APCI1710_InitDigitalIO (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		ps_Config->u.s_DigitalIO.b_ChannelAMode = b_ChannelAMode;
+		ps_Config->u.s_DigitalIO.b_ChannelBMode = b_ChannelBMode;
+		}
+
 	return (i_ReturnValue);
 	}
 	
@@ -320,6 +330,8 @@ int   i_APCI1710_ReadDigitalIOChlValue (struct pci_dev *pdev,
 			      &dw_StatusReg);
 
 		       *pb_ChannelStatus = (uint8_t) ((dw_StatusReg ^ 0x1C) >> b_InputChannel) & 1;
+
+		       v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, (dw_StatusReg ^ 0x1C) & 0xFF);
 		       } // if (i_ReturnValue == 0)
 		    }
 		 else
@@ -418,6 +430,8 @@ int   i_APCI1710_ReadDigitalIOPortValue  (struct pci_dev *pdev,
 			&dw_StatusReg);
 
 		 *pb_PortValue = (uint8_t) (dw_StatusReg ^ 0x1C);
+
+		 v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, *pb_PortValue);
 		 }
 	      else
 		 {
@@ -538,6 +552,9 @@ int   i_APCI1710_SetDigitalIOMemoryOn (struct pci_dev *pdev, uint8_t b_ModulNbr)
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_OUTPUT_MEMORY);
+
 	return (i_ReturnValue);
 	}
 
@@ -617,6 +634,9 @@ int   i_APCI1710_SetDigitalIOMemoryOff (struct pci_dev *pdev, uint8_t b_ModulNbr
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		APCI1710_PRIVDATA(pdev)->s_ModuleConfig[b_ModulNbr].ul_Flags &= ~APCI1710_CONFIG_OUTPUT_MEMORY;
+
 	return (i_ReturnValue);
 	}
 
@@ -1325,3 +1345,217 @@ int   i_APCI1710_SetDigitalIOPortOff (struct pci_dev *pdev,
 
 	return (i_ReturnValue);
 	}
+
+//------------------------------------------------------------------------------
+
+/** Test one module of a masked output write.
+ *
+ * @see i_APCI1710_SetDigitalOutputsMasked for the parameters and return values.
+ */
+static int i_APCI1710_TestDigitalOutputsMasked (struct pci_dev *pdev,
+                                                uint8_t b_ModulNbr,
+                                                uint32_t ul_SetMask,
+                                                uint32_t ul_ClearMask)
+	{
+	uint32_t ul_Mask = ul_SetMask | ul_ClearMask;
+	uint8_t * pb_PortConfiguration = NULL;
+
+	/************************************/
+	/* A channel can't be set and reset */
+	/************************************/
+
+	if (ul_SetMask & ul_ClearMask)
+	   return 4;
+
+	switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+	   {
+	   case APCI1710_DIGITAL_IO:
+	      if (ul_Mask & ~0x7UL)
+		 return 4;
+
+	      if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.b_DigitalInit != 1)
+		 return 5;
+
+	      /*************************************/
+	      /* Test if channel A/B used as input */
+	      /*************************************/
+
+	      if (((ul_Mask & 2) && (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.b_ChannelAMode != 1)) ||
+		  ((ul_Mask & 4) && (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.b_ChannelBMode != 1)))
+		 return 6;
+
+	      /*********************************************/
+	      /* Resetting needs the digital output memory */
+	      /*********************************************/
+
+	      if (ul_ClearMask && (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.b_OutputMemoryEnabled != 1))
+		 return 7;
+	      break;
+
+	   case APCI1710_TTL_IO:
+	      if ((APCI1710_PRIVDATA(pdev)->s_BoardInfos.dw_MolduleConfiguration [b_ModulNbr] & 0xFFFF) >= 0x3230)
+		 {
+		 if (ul_Mask & ~(APCI1710_TTL_PORT_A_MASK | APCI1710_TTL_PORT_B_MASK | APCI1710_TTL_PORT_C_MASK | APCI1710_TTL_PORT_D_MASK))
+		    return 4;
+		 }
+	      else
+		 {
+		 if (ul_Mask & ~APCI1710_TTL_PORT_D_MASK)
+		    return 4;
+		 }
+
+	      if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_TTLInit != 1)
+		 return 5;
+
+	      /*****************************************************/
+	      /* Test if the selected channels are output channels */
+	      /* PD: port 3, PA: port 0, PB: port 1, PC: port 2    */
+	      /*****************************************************/
+
+	      pb_PortConfiguration = APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_PortConfiguration;
+
+	      if (((ul_Mask & APCI1710_TTL_PORT_A_MASK) && (pb_PortConfiguration [0] != 1)) ||
+		  ((ul_Mask & APCI1710_TTL_PORT_B_MASK) && (pb_PortConfiguration [1] != 1)) ||
+		  ((ul_Mask & APCI1710_TTL_PORT_C_MASK) && (pb_PortConfiguration [2] != 1)) ||
+		  ((ul_Mask & APCI1710_TTL_PORT_D_MASK) && (pb_PortConfiguration [3] != 1)))
+		 return 6;
+	      break;
+
+	   default:
+	      /*************************************************/
+	      /* The module is not a digital I/O or TTL module */
+	      /*************************************************/
+
+	      return 3;
+	   }
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Set and reset outputs of several digital I/O and TTL I/O modules at once.
+ *
+ * For each selected module, the outputs of ul_SetMask are set high and the
+ * outputs of ul_ClearMask are set low, the other outputs keep their state.
+ * All modules are tested before the first write, so on error no output
+ * is changed. The writes are done back to back, one register write per
+ * digital I/O module and per TTL port.
+ *
+ * The digital I/O channels are the bits of the port value
+ * (bit 0: H, bit 1: A, bit 2: B). If the digital output memory is off,
+ * the other outputs are set to "0" like with "i_APCI1710_SetDigitalIOPortOn".
+ * The TTL I/O channels are the bits of the port register, see
+ * APCI1710_TTL_PORT_A_MASK (bits 0-7: PA, bits 8-15: PB, bits 16-23: PC,
+ * bits 24-25: PD0-PD1).
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModuleMask          : Modules to write (bit n set: module n).
+ * @param [in] ul_SetMask            : Outputs to set, for each module.
+ * @param [in] ul_ClearMask          : Outputs to reset, for each module.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not a digital I/O or TTL I/O module.
+ * @retval 4: A mask is wrong (channel not available or set and reset at once).
+ * @retval 5: A selected module is not initialised.
+ * @retval 6: A selected channel is used for input.
+ * @retval 7: Digital Output Memory OFF and outputs to reset. Use previously the function "i_APCI1710_SetDigitalIOMemoryOn".
+ */
+int   i_APCI1710_SetDigitalOutputsMasked (struct pci_dev *pdev,
+                                          uint8_t b_ModuleMask,
+                                          const uint32_t ul_SetMask[4],
+                                          const uint32_t ul_ClearMask[4])
+	{
+	int    i_ReturnValue = 0;
+	uint8_t  b_ModulNbr = 0;
+	uint8_t  b_Port = 0;
+	uint32_t dw_WriteValue = 0;
+	uint32_t dw_StatusReg = 0;
+	uint32_t ul_PortSet = 0;
+	uint32_t ul_PortClear = 0;
+
+	if (!pdev) return 1;
+
+	/************************/
+	/* Test the module mask */
+	/************************/
+
+	if ((b_ModuleMask == 0) || (b_ModuleMask >> NUMBER_OF_MODULE(pdev)))
+	   return 2;
+
+	/***********************************************/
+	/* Test all modules before changing any output */
+	/***********************************************/
+
+	for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr ++)
+	   if (b_ModuleMask & (1 << b_ModulNbr))
+	      {
+	      i_ReturnValue = i_APCI1710_TestDigitalOutputsMasked (pdev, b_ModulNbr, ul_SetMask[b_ModulNbr], ul_ClearMask[b_ModulNbr]);
+	      if (i_ReturnValue)
+		 return i_ReturnValue;
+	      }
+
+	/*********************/
+	/* Write the outputs */
+	/*********************/
+
+	for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr ++)
+	   {
+	   if ((b_ModuleMask & (1 << b_ModulNbr)) == 0)
+	      continue;
+
+	   if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) == APCI1710_DIGITAL_IO)
+	      {
+	      if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.b_OutputMemoryEnabled == 1)
+		 {
+		 dw_WriteValue = (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.dw_OutputMemory | ul_SetMask[b_ModulNbr]) & ~ul_ClearMask[b_ModulNbr];
+
+		 APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_DigitalIOInfo.dw_OutputMemory = dw_WriteValue;
+		 }
+	      else
+		 {
+		 dw_WriteValue = ul_SetMask[b_ModulNbr];
+		 }
+
+	      OUTPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), dw_WriteValue);
+	      }
+	   else
+	      {
+	      /***************/
+	      /* PD0 and PD1 */
+	      /***************/
+
+	      if ((ul_SetMask[b_ModulNbr] | ul_ClearMask[b_ModulNbr]) & (1UL << 24))
+		 OUTPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), (ul_SetMask[b_ModulNbr] >> 24) & 1);
+
+	      if ((ul_SetMask[b_ModulNbr] | ul_ClearMask[b_ModulNbr]) & (1UL << 25))
+		 OUTPDW (GET_BAR2(pdev), 4 + MODULE_OFFSET(b_ModulNbr), (ul_SetMask[b_ModulNbr] >> 25) & 1);
+
+	      /*****************************************/
+	      /* PA, PB and PC: read all channels once */
+	      /*****************************************/
+
+	      if (((ul_SetMask[b_ModulNbr] | ul_ClearMask[b_ModulNbr]) & ~APCI1710_TTL_PORT_D_MASK) == 0)
+		 continue;
+
+	      INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
+
+	      for (b_Port = 0; b_Port < 3; b_Port ++)
+		 {
+		 ul_PortSet   = (ul_SetMask[b_ModulNbr]   >> (b_Port * 8)) & 0xFF;
+		 ul_PortClear = (ul_ClearMask[b_ModulNbr] >> (b_Port * 8)) & 0xFF;
+
+		 if ((ul_PortSet | ul_PortClear) == 0)
+		    continue;
+
+		 dw_WriteValue = (((dw_StatusReg >> (b_Port * 8)) & 0xFF) | ul_PortSet) & ~ul_PortClear;
+
+		 OUTPDW (GET_BAR2(pdev), 8 + (b_Port * 4) + MODULE_OFFSET(b_ModulNbr), dw_WriteValue);
+		 }
+	      }
+	   }
+
+	return 0;
+	}
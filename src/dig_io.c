@@ -440,3 +440,56 @@ int do_CMD_APCI1710_SetDigitalIOPortOff (struct pci_dev *pdev, unsigned int cmd,
 																								
 //------------------------------------------------------------------------------
 
+
+/** Set and reset outputs of several digital I/O and TTL I/O modules at once.
+ *
+ * @param [in] pdev                          : The device to use.
+ * @param [in] arg[0] (b_ModuleMask)         : Modules to write (bit n set: module n).
+ * @param [in] arg[1 + 2n] (ul_SetMask)      : Outputs to set on module n (n = 0 to 3).
+ * @param [in] arg[2 + 2n] (ul_ClearMask)    : Outputs to reset on module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: A selected module is not a digital I/O or TTL I/O module.
+ * @retval 4: A mask is wrong (channel not available or set and reset at once).
+ * @retval 5: A selected module is not initialised.
+ * @retval 6: A selected channel is used for input.
+ * @retval 7: Digital Output Memory OFF and outputs to reset. Use previously the function "i_APCI1710_SetDigitalIOMemoryOn".
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetDigitalOutputsMasked (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t ul_ArgArray[9];
+	uint32_t ul_SetMask[4];
+	uint32_t ul_ClearMask[4];
+	uint8_t b_ModulNbr = 0;
+
+	if ( copy_from_user( ul_ArgArray, (uint32_t __user *)arg, sizeof(ul_ArgArray) ) )
+		return -EFAULT;
+
+	if (ul_ArgArray[0] > 0xFF)
+		return 2;
+
+	for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr++)
+	{
+		ul_SetMask[b_ModulNbr]   = ul_ArgArray[1 + (2 * b_ModulNbr)];
+		ul_ClearMask[b_ModulNbr] = ul_ArgArray[2 + (2 * b_ModulNbr)];
+	}
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_SetDigitalOutputsMasked (pdev,
+													(uint8_t) ul_ArgArray[0],   // b_ModuleMask
+													ul_SetMask,
+													ul_ClearMask);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
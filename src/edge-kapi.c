@@ -0,0 +1,263 @@
+/** @file edge-kapi.c
+ 
+   Contains the input edge detection kernel functions.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include "irq-private-kapi.h"
+#include "cache-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_InitEdgeDetection);
+EXPORT_SYMBOL(i_APCI1710_SetEdgeDetectionPeriod);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Return the input channels of a digital I/O or TTL I/O module.
+ *
+ * Digital I/O: bits 0-4 are always inputs, channel A (bit 5) and
+ * channel B (bit 6) only when configured as input.
+ * TTL I/O: the input mask saved at initialisation.
+ *
+ * @return The input channels, 0 if the module is not initialised.
+ */
+static uint32_t ul_APCI1710_EdgeInputMask (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	uint32_t ul_InputMask = 0;
+
+	switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+		{
+		case APCI1710_DIGITAL_IO:
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_DigitalIOInfo.b_DigitalInit != 1)
+				break;
+
+			ul_InputMask = 0x1F;
+
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_DigitalIOInfo.b_ChannelAMode == 0)
+				ul_InputMask |= 0x20;
+
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_DigitalIOInfo.b_ChannelBMode == 0)
+				ul_InputMask |= 0x40;
+			break;
+
+		case APCI1710_TTL_IO:
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_TTLInit == 1)
+				ul_InputMask = APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.dw_InputMask;
+			break;
+
+		default:
+			break;
+		}
+
+	return ul_InputMask;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Edge detection sampler, hrtimer callback.
+ *
+ * Reads the port of every module with edges to detect, compares it with
+ * the previous sample and delivers the rising and falling edges like an
+ * interrupt of the module (legacy FIFO, subscribed files, user callback).
+ */
+static enum hrtimer_restart v_APCI1710_EdgeDetectionSampler (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_EdgeDetection.s_Timer);
+	str_EdgeDetectionInfos * ps_Edge = &ps_Board->s_EdgeDetection;
+	struct pci_dev * pdev = ps_Board->pdev;
+	uint8_t  b_ModulNbr = 0;
+	uint32_t dw_StatusReg = 0;
+	uint32_t ul_Value = 0;
+	uint32_t ul_Edges = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr++)
+				{
+				if ((ps_Edge->b_ModuleMask & (1 << b_ModulNbr)) == 0)
+					continue;
+
+				INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
+
+				if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) == APCI1710_DIGITAL_IO)
+					ul_Value = (dw_StatusReg ^ 0x1C) & 0xFF;
+				else
+					ul_Value = dw_StatusReg & 0x03FFFFFFUL;
+
+				v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, ul_Value);
+
+				/* The first sample is only the reference */
+				if (ps_Edge->b_ValidMask & (1 << b_ModulNbr))
+					{
+					ul_Edges = (ul_Value ^ ps_Edge->ul_LastValue [b_ModulNbr]) & ul_Value & ps_Edge->ul_RisingMask [b_ModulNbr];
+					if (ul_Edges)
+						v_APCI1710_UserInterruptManagement (pdev, b_ModulNbr, APCI1710_EDGE_RISING_INTERRUPT, &ul_Edges);
+
+					ul_Edges = (ul_Value ^ ps_Edge->ul_LastValue [b_ModulNbr]) & ~ul_Value & ps_Edge->ul_FallingMask [b_ModulNbr];
+					if (ul_Edges)
+						v_APCI1710_UserInterruptManagement (pdev, b_ModulNbr, APCI1710_EDGE_FALLING_INTERRUPT, &ul_Edges);
+					}
+
+				ps_Edge->ul_LastValue [b_ModulNbr] = ul_Value;
+				ps_Edge->b_ValidMask |= (1 << b_ModulNbr);
+				}
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	hrtimer_forward_now (ps_Timer, ps_Edge->kt_Period);
+
+	return HRTIMER_RESTART;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the edge detection sampler of a new board. */
+void apci1710_edge_detection_init (struct pci_dev *pdev)
+	{
+	str_EdgeDetectionInfos * ps_Edge = &(APCI1710_PRIVDATA(pdev)->s_EdgeDetection);
+
+	hrtimer_init (&ps_Edge->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ps_Edge->s_Timer.function = v_APCI1710_EdgeDetectionSampler;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Select the input edges to detect on a digital I/O or TTL I/O module.
+ *
+ * The channels are the bits of the port value returned by
+ * "i_APCI1710_ReadDigitalIOPortValue" for a digital I/O module
+ * (bits 0-6) and of the port register for a TTL I/O module
+ * (bits 0-7: port A, 8-15: port B, 16-23: port C, 24-25: port D).
+ * Both masks at 0 stop the detection on the module. The next sample of
+ * the module is taken as reference, without event.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] ul_RisingMask         : Channels generating an APCI1710_EDGE_RISING_INTERRUPT event.
+ * @param [in] ul_FallingMask        : Channels generating an APCI1710_EDGE_FALLING_INTERRUPT event.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a digital I/O or TTL I/O module.
+ * @retval 4: The module is not initialised.
+ * @retval 5: A mask selects a channel which is not an input.
+ */
+int i_APCI1710_InitEdgeDetection (struct pci_dev *pdev,
+                                  uint8_t b_ModulNbr,
+                                  uint32_t ul_RisingMask,
+                                  uint32_t ul_FallingMask)
+	{
+	str_EdgeDetectionInfos * ps_Edge = NULL;
+	uint32_t ul_InputMask = 0;
+
+	if (!pdev) return 1;
+
+	if (b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+		return 2;
+
+	if ((APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_DIGITAL_IO) &&
+	    (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_TTL_IO))
+		return 3;
+
+	ul_InputMask = ul_APCI1710_EdgeInputMask (pdev, b_ModulNbr);
+	if (ul_InputMask == 0)
+		return 4;
+
+	if ((ul_RisingMask | ul_FallingMask) & ~ul_InputMask)
+		return 5;
+
+	ps_Edge = &(APCI1710_PRIVDATA(pdev)->s_EdgeDetection);
+
+	ps_Edge->ul_RisingMask [b_ModulNbr]  = ul_RisingMask;
+	ps_Edge->ul_FallingMask [b_ModulNbr] = ul_FallingMask;
+	ps_Edge->b_ValidMask &= ~(1 << b_ModulNbr);
+
+	if (ul_RisingMask | ul_FallingMask)
+		ps_Edge->b_ModuleMask |= (1 << b_ModulNbr);
+	else
+		ps_Edge->b_ModuleMask &= ~(1 << b_ModulNbr);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the edge detection sampler.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running sampler callback.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ul_Period             : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ */
+int i_APCI1710_SetEdgeDetectionPeriod (struct pci_dev *pdev, uint32_t ul_Period)
+	{
+	str_EdgeDetectionInfos * ps_Edge = NULL;
+
+	if (!pdev) return 1;
+
+	if ((ul_Period != 0) && (ul_Period < APCI1710_EDGE_DETECTION_MIN_PERIOD))
+		return 2;
+
+	ps_Edge = &(APCI1710_PRIVDATA(pdev)->s_EdgeDetection);
+
+	/* Stop the running sampler */
+	hrtimer_cancel (&ps_Edge->s_Timer);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ps_Edge->kt_Period   = ns_to_ktime ((uint64_t) ul_Period * NSEC_PER_USEC);
+			ps_Edge->b_ValidMask = 0;
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if (ul_Period != 0)
+		hrtimer_start (&ps_Edge->s_Timer, ps_Edge->kt_Period, HRTIMER_MODE_REL);
+
+	return 0;
+	}
@@ -0,0 +1,115 @@
+/** @file edge.c
+ 
+   Contains the input edge detection ioctl functions.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Select the input edges to detect on a digital I/O or TTL I/O module.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)      : Module number (0 to 3).
+ * @param [in] arg[1] (ul_RisingMask)   : Channels generating a rising edge event.
+ * @param [in] arg[2] (ul_FallingMask)  : Channels generating a falling edge event.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a digital I/O or TTL I/O module.
+ * @retval 4: The module is not initialised.
+ * @retval 5: A mask selects a channel which is not an input.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_InitEdgeDetection (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[3];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	if (dw_ArgArray[0] > 0xFF)
+		return 2;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_InitEdgeDetection (pdev,
+			                                            (uint8_t) dw_ArgArray[0], // b_ModulNbr
+			                                            dw_ArgArray[1],           // ul_RisingMask
+			                                            dw_ArgArray[2]);          // ul_FallingMask
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the edge detection sampler.
+ *
+ * The board is locked by i_APCI1710_SetEdgeDetectionPeriod itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (ul_Period)       : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetEdgeDetectionPeriod (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	uint32_t ul_Period = 0;
+
+	if ( copy_from_user(&ul_Period, (uint32_t __user *)arg, sizeof(ul_Period) ) )
+		return -EFAULT;
+
+	return i_APCI1710_SetEdgeDetectionPeriod (pdev, ul_Period);
+}
+
+//------------------------------------------------------------------------------
@@ -46,6 +46,7 @@
 
 
 #include "apci1710-private.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitETM);
 EXPORT_SYMBOL(i_APCI1710_EnableETM);
@@ -53,11 +54,29 @@ EXPORT_SYMBOL(i_APCI1710_DisableETM);
 EXPORT_SYMBOL(i_APCI1710_GetETMProgressStatus);
 EXPORT_SYMBOL(i_APCI1710_ReadETMValue);
 EXPORT_SYMBOL(i_APCI1710_ReadETMTotalTime);
+EXPORT_SYMBOL(i_APCI1710_SetETMCapture);
+EXPORT_SYMBOL(i_APCI1710_ReadETMCapture);
+EXPORT_SYMBOL(i_APCI1710_GetETMCaptureStatistics);
+
+//------------------------------------------------------------------------------
+
+/* empties the capture ring and restarts the aggregates of an ETM, the flags are kept */
+static void v_APCI1710_ResetETMCapture (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_ETM)
+	{
+	str_ETMCaptureInfos * ps_Capture = &APCI1710_PRIVDATA(pdev)->s_ETMCapture [b_ModulNbr][b_ETM];
+	uint8_t b_Flags = ps_Capture->b_Flags;
+
+	memset (ps_Capture, 0, sizeof (*ps_Capture));
+	ps_Capture->b_Flags = b_Flags;
+	}
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
 /* Initialize ETM functionality.
+ *
+ * The capture rings and the aggregates of both ETMs are restarted,
+ * see function "i_APCI1710_SetETMCapture".
  *
  * @param [in] pdev                  : The device to use.
  * @param [in] b_ModulNbr            : Module number to configure (0 to 3).
@@ -159,6 +178,10 @@ int i_APCI1710_InitETM (struct pci_dev *pdev,
 						s_ETMModuleInfo.
 						ul_Timing = ul_Timing;
 
+						/* New timing base: restart the capture rings and the aggregates */
+						v_APCI1710_ResetETMCapture (pdev, b_ModulNbr, 0);
+						v_APCI1710_ResetETMCapture (pdev, b_ModulNbr, 1);
+
 						OUTPDW (GET_BAR2(pdev),
 						4 + MODULE_OFFSET(b_ModulNbr),
 						0x10);
@@ -220,6 +243,14 @@ int i_APCI1710_InitETM (struct pci_dev *pdev,
 		i_ReturnValue = 2;
 	}
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		ps_Config->u.s_ETM.b_ClockSelection = b_ClockSelection;
+		ps_Config->u.s_ETM.b_TimingUnit     = b_TimingUnit;
+		ps_Config->u.s_ETM.ul_Timing        = ul_Timing;
+		}
+
 return (i_ReturnValue);
 }
 
@@ -416,6 +447,8 @@ int	i_APCI1710_EnableETM	(struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   } // if (b_ModulNbr < ps_APCI1710Variable->s_Board [b_BoardHandle].s_BoardInfos.b_NumberOfModule)
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 
@@ -501,6 +534,8 @@ int i_APCI1710_DisableETM	(struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   } // if (b_ModulNbr < ps_APCI1710Variable->s_Board [b_BoardHandle].s_BoardInfos.b_NumberOfModule)
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 
@@ -992,6 +1027,263 @@ int	i_APCI1710_ReadETMTotalTime	(struct pci_dev *pdev,
 	return (i_ReturnValue);
 	}
 
+//------------------------------------------------------------------------------
+
+/* returns the error code of the capture functions for this ETM, 0 if usable */
+static int i_APCI1710_TestETMCapture (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_ETM)
+	{
+	/* Module selection wrong */
+	if (b_ModulNbr >= APCI1710_PRIVDATA(pdev)->s_BoardInfos.b_NumberOfModule)
+	   return 2;
+
+	/* The module is not a ETM module */
+	if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_ETM)
+	   return 3;
+
+	/* ETM selection is wrong */
+	if (b_ETM > 1)
+	   return 4;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the interrupts of an ETM.
+ *
+ * The capture ring and the aggregates of the ETM are restarted.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] b_Flags               : Combination of APCI1710_ETM_CAPTURE_RING,
+ *                                     APCI1710_ETM_CAPTURE_STATISTICS and
+ *                                     APCI1710_ETM_CAPTURE_NO_EVENT. 0: default behaviour.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: ETM not initialised, see function "i_APCI1710_InitETM"
+ * @retval 6: The flags are wrong
+ */
+int	i_APCI1710_SetETMCapture	(struct pci_dev *pdev,
+					 uint8_t b_ModulNbr,
+					 uint8_t b_ETM,
+					 uint8_t b_Flags)
+	{
+	int i_ReturnValue = 0;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestETMCapture (pdev, b_ModulNbr, b_ETM);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_ETMModuleInfo.b_ETMInit != APCI1710_ENABLE)
+	   return 5;
+
+	if (b_Flags & ~(APCI1710_ETM_CAPTURE_RING | APCI1710_ETM_CAPTURE_STATISTICS | APCI1710_ETM_CAPTURE_NO_EVENT))
+	   return 6;
+
+	APCI1710_PRIVDATA(pdev)->s_ETMCapture [b_ModulNbr][b_ETM].b_Flags = b_Flags;
+	v_APCI1710_ResetETMCapture (pdev, b_ModulNbr, b_ETM);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the records stored in the capture ring of an ETM.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] ul_MaxCount           : Size of ps_Records (1 to APCI1710_ETM_CAPTURE_SIZE).
+ *
+ * @param [out] pul_Count            : Number of records read.
+ * @param [out] pul_Lost             : Records dropped since the last read.
+ * @param [out] ps_Records           : Records, oldest first.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: The capture ring is not enabled, see function "i_APCI1710_SetETMCapture"
+ * @retval 6: ul_MaxCount is wrong
+ */
+int	i_APCI1710_ReadETMCapture	(struct pci_dev *pdev,
+					 uint8_t b_ModulNbr,
+					 uint8_t b_ETM,
+					 uint32_t ul_MaxCount,
+					 uint32_t *pul_Count,
+					 uint32_t *pul_Lost,
+					 str_APCI1710_ETMCaptureRecord *ps_Records)
+	{
+	int i_ReturnValue = 0;
+	str_ETMCaptureInfos * ps_Capture = NULL;
+
+	*pul_Count = 0;
+	*pul_Lost = 0;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestETMCapture (pdev, b_ModulNbr, b_ETM);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	ps_Capture = &APCI1710_PRIVDATA(pdev)->s_ETMCapture [b_ModulNbr][b_ETM];
+
+	if (!(ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_RING))
+	   return 5;
+
+	if ((ul_MaxCount == 0) || (ul_MaxCount > APCI1710_ETM_CAPTURE_SIZE))
+	   return 6;
+
+	while ((*pul_Count < ul_MaxCount) && (ps_Capture->ul_Read != ps_Capture->ul_Write))
+	   {
+	   ps_Records [*pul_Count] = ps_Capture->s_Record [ps_Capture->ul_Read % APCI1710_ETM_CAPTURE_SIZE];
+	   ps_Capture->ul_Read ++;
+	   (*pul_Count) ++;
+	   }
+
+	*pul_Lost = ps_Capture->ul_Lost;
+	ps_Capture->ul_Lost = 0;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the aggregates of an ETM.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] b_Reset               : 1: restart the aggregates after the read.
+ *
+ * @param [out] ps_Statistics        : The aggregates.
+ *
+ * @retval 0: No error
+ * @retval 1: The handle parameter of the board is wrong
+ * @retval 2: Module selection wrong
+ * @retval 3: The module is not a ETM module
+ * @retval 4: ETM selection is wrong
+ * @retval 5: The aggregates are not enabled, see function "i_APCI1710_SetETMCapture"
+ */
+int	i_APCI1710_GetETMCaptureStatistics	(struct pci_dev *pdev,
+						 uint8_t b_ModulNbr,
+						 uint8_t b_ETM,
+						 uint8_t b_Reset,
+						 str_APCI1710_ETMCaptureStatistics *ps_Statistics)
+	{
+	int i_ReturnValue = 0;
+	str_ETMCaptureInfos * ps_Capture = NULL;
+
+	if (!pdev) return 1;
+
+	i_ReturnValue = i_APCI1710_TestETMCapture (pdev, b_ModulNbr, b_ETM);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	ps_Capture = &APCI1710_PRIVDATA(pdev)->s_ETMCapture [b_ModulNbr][b_ETM];
+
+	if (!(ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_STATISTICS))
+	   return 5;
+
+	*ps_Statistics = ps_Capture->s_Statistics;
+	ps_Statistics->b_ModulNbr = b_ModulNbr;
+	ps_Statistics->b_ETMNbr = b_ETM;
+	ps_Statistics->b_Reset = b_Reset;
+	if (ps_Statistics->ull_Count)
+	   {
+	   ps_Statistics->ul_MeanTotalTime = (uint32_t) div64_u64 (ps_Capture->ull_TotalTimeSum, ps_Statistics->ull_Count);
+	   ps_Statistics->ul_MeanDutyCycle = (uint32_t) div64_u64 (ps_Capture->ull_DutyCycleSum, ps_Statistics->ull_Count);
+	   }
+
+	if (b_Reset)
+	   {
+	   memset (&ps_Capture->s_Statistics, 0, sizeof (ps_Capture->s_Statistics));
+	   ps_Capture->ull_TotalTimeSum = 0;
+	   ps_Capture->ull_DutyCycleSum = 0;
+	   }
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Account an ETM interrupt in the capture ring and the aggregates of the ETM.
+ *
+ * Called by the interrupt function of the ETM module with the board lock held.
+ *
+ * @param [in] pdev                  : The device.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_ETM                 : ETM selection (0 or 1).
+ * @param [in] pul_Value             : [0] ETM value, [1] ETM total time.
+ *
+ * @return 1 if the interrupt must also be delivered as interrupt event, else 0.
+ */
+int	i_APCI1710_ETMCaptureAdd	(struct pci_dev *pdev,
+					 uint8_t b_ModulNbr,
+					 uint8_t b_ETM,
+					 uint32_t *pul_Value)
+	{
+	str_ETMCaptureInfos * ps_Capture = &APCI1710_PRIVDATA(pdev)->s_ETMCapture [b_ModulNbr][b_ETM];
+	str_APCI1710_ETMCaptureStatistics * ps_Statistics = &ps_Capture->s_Statistics;
+	str_APCI1710_ETMCaptureRecord * ps_Record = NULL;
+	uint32_t ul_DutyCycle = 0;
+
+	if (!(ps_Capture->b_Flags & (APCI1710_ETM_CAPTURE_RING | APCI1710_ETM_CAPTURE_STATISTICS)))
+	   return !(ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_NO_EVENT);
+
+	/* Duty cycle in 0.01 % */
+	if (pul_Value[1] != 0)
+	   {
+	   ul_DutyCycle = (uint32_t) div_u64 ((uint64_t) pul_Value[0] * 10000, pul_Value[1]);
+	   if (ul_DutyCycle > 10000)
+	      ul_DutyCycle = 10000;
+	   }
+
+	if (ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_RING)
+	   {
+	   /* Full: drop the oldest record */
+	   if ((ps_Capture->ul_Write - ps_Capture->ul_Read) >= APCI1710_ETM_CAPTURE_SIZE)
+	      {
+	      ps_Capture->ul_Read ++;
+	      ps_Capture->ul_Lost ++;
+	      }
+
+	   ps_Record = &ps_Capture->s_Record [ps_Capture->ul_Write % APCI1710_ETM_CAPTURE_SIZE];
+	   ps_Record->ull_TimeStamp = APCI1710_TIMESTAMP();
+	   ps_Record->ul_EdgeTime = pul_Value[0];
+	   ps_Record->ul_TotalTime = pul_Value[1];
+	   ps_Record->ul_DutyCycle = ul_DutyCycle;
+	   ps_Record->ul_Reserved = 0;
+	   ps_Capture->ul_Write ++;
+	   }
+
+	if (ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_STATISTICS)
+	   {
+	   if ((ps_Statistics->ull_Count == 0) || (pul_Value[1] < ps_Statistics->ul_MinTotalTime))
+	      ps_Statistics->ul_MinTotalTime = pul_Value[1];
+	   if (pul_Value[1] > ps_Statistics->ul_MaxTotalTime)
+	      ps_Statistics->ul_MaxTotalTime = pul_Value[1];
+	   if ((ps_Statistics->ull_Count == 0) || (ul_DutyCycle < ps_Statistics->ul_MinDutyCycle))
+	      ps_Statistics->ul_MinDutyCycle = ul_DutyCycle;
+	   if (ul_DutyCycle > ps_Statistics->ul_MaxDutyCycle)
+	      ps_Statistics->ul_MaxDutyCycle = ul_DutyCycle;
+
+	   ps_Statistics->ull_Count ++;
+	   ps_Capture->ull_TotalTimeSum += pul_Value[1];
+	   ps_Capture->ull_DutyCycleSum += ul_DutyCycle;
+	   }
+
+	return !(ps_Capture->b_Flags & APCI1710_ETM_CAPTURE_NO_EVENT);
+	}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
@@ -0,0 +1,198 @@
+/** @file etm.c
+ 
+   Contains the ETM capture ioctl functions.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Select what the interrupt routine does with the interrupts of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)      : Module number (0 to 3).
+ * @param [in] arg[1] (b_ETMNbr)        : ETM selection (0 or 1).
+ * @param [in] arg[2] (b_Flags)         : Combination of APCI1710_ETM_CAPTURE_RING,
+ *                                        APCI1710_ETM_CAPTURE_STATISTICS and
+ *                                        APCI1710_ETM_CAPTURE_NO_EVENT.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: ETM not initialised.
+ * @retval 6: The flags are wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetETMCapture (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[3];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_SetETMCapture (pdev,
+			                                        (uint8_t) dw_ArgArray[0],  // b_ModulNbr
+			                                        (uint8_t) dw_ArgArray[1],  // b_ETMNbr
+			                                        (uint8_t) dw_ArgArray[2]); // b_Flags
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the records stored in the capture ring of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCapture) : b_ModulNbr, b_ETMNbr and ul_Count
+ *                                        select the ETM, ul_Count, ul_Lost and s_Record
+ *                                        are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The capture ring is not enabled.
+ * @retval 6: ul_Count is wrong.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadETMCapture (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_ETMCapture * ps_Capture = NULL;
+
+	/* Too large for the kernel stack */
+	ps_Capture = kmalloc (sizeof (*ps_Capture), GFP_KERNEL);
+	if (!ps_Capture)
+		return -ENOMEM;
+
+	if ( copy_from_user(ps_Capture, (str_APCI1710_ETMCapture __user *)arg, offsetof(str_APCI1710_ETMCapture, s_Record) ) )
+	{
+		kfree (ps_Capture);
+		return -EFAULT;
+	}
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ReadETMCapture (pdev,
+			                                         ps_Capture->b_ModulNbr,
+			                                         ps_Capture->b_ETMNbr,
+			                                         ps_Capture->ul_Count,   // ul_MaxCount
+			                                         &ps_Capture->ul_Count,
+			                                         &ps_Capture->ul_Lost,
+			                                         ps_Capture->s_Record);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if ((i_ErrorCode == 0) &&
+	    copy_to_user( (str_APCI1710_ETMCapture __user *)arg, ps_Capture,
+	                  offsetof(str_APCI1710_ETMCapture, s_Record) + ps_Capture->ul_Count * sizeof(str_APCI1710_ETMCaptureRecord) ) )
+		i_ErrorCode = -EFAULT;
+
+	kfree (ps_Capture);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the aggregates of an ETM.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_ETMCaptureStatistics) : b_ModulNbr, b_ETMNbr and
+ *                                        b_Reset select the ETM, the others fields are returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection wrong.
+ * @retval 3: The module is not a ETM module.
+ * @retval 4: ETM selection is wrong.
+ * @retval 5: The aggregates are not enabled.
+ * @retval -EFAULT : Fail to retrieve / return user data.
+ */
+int do_CMD_APCI1710_GetETMCaptureStatistics (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_ETMCaptureStatistics s_Statistics;
+
+	if ( copy_from_user(&s_Statistics, (str_APCI1710_ETMCaptureStatistics __user *)arg, sizeof(s_Statistics) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_GetETMCaptureStatistics (pdev,
+			                                                  s_Statistics.b_ModulNbr,
+			                                                  s_Statistics.b_ETMNbr,
+			                                                  s_Statistics.b_Reset,
+			                                                  &s_Statistics);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (str_APCI1710_ETMCaptureStatistics __user *)arg, &s_Statistics, sizeof(s_Statistics) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
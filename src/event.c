@@ -0,0 +1,478 @@
+/** @file event.c
+*
+* @author agent
+*
+* Per open file event subscriptions.
+*
+* Each subscribed file owns a ring of str_APCI1710_Event. The ring is
+* filled in interrupt context (board lock held) by apci1710_event_dispatch()
+* and emptied by the owner of the file only, so that several processes
+* can listen to the same board without stealing each other's events.
+*/
+
+/** @par LICENCE
+* @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You shoud find the complete GPL in the COPYING file accompanying
+    this source code.
+* @endverbatim
+*/
+
+#include "apci1710-private.h"
+
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Deliver an event to all the matching subscriptions of a board.
+ *
+ * Called from v_APCI1710_UserInterruptManagement, the board lock is held.
+ * The ring index of the reader is only read here, a full ring drops the
+ * new event and increments the lost event counter of the subscription.
+ */
+void apci1710_event_dispatch (struct pci_dev * pdev,
+                              uint8_t b_Module,
+                              uint32_t ul_InterruptMask,
+                              uint32_t * ul_Value)
+{
+	str_EventSubscription * ps_Subscription = NULL;
+	uint64_t ull_TimeStamp = 0;
+
+	if (list_empty (&(APCI1710_PRIVDATA(pdev)->subscriptions)))
+		return;
+
+	ull_TimeStamp = APCI1710_TIMESTAMP();
+
+	list_for_each_entry (ps_Subscription, &(APCI1710_PRIVDATA(pdev)->subscriptions), list)
+	{
+		str_APCI1710_Event * ps_Event = NULL;
+		uint32_t ul_Write = ps_Subscription->ul_Write;
+
+		/* Module filter */
+		if ((ps_Subscription->b_ModuleMask & (1 << b_Module)) == 0)
+			continue;
+
+		/* Interrupt mask filter */
+		if ((ps_Subscription->ul_InterruptMask != 0) && ((ps_Subscription->ul_InterruptMask & ul_InterruptMask) == 0))
+			continue;
+
+		/* Ring full */
+		if ((ul_Write - smp_load_acquire (&ps_Subscription->ul_Read)) >= ps_Subscription->ul_Size)
+		{
+			ps_Subscription->ul_LostEvents ++;
+			continue;
+		}
+
+		ps_Event = &ps_Subscription->ps_Ring[ul_Write & (ps_Subscription->ul_Size - 1)];
+		ps_Event->ull_TimeStamp    = ull_TimeStamp;
+		ps_Event->ul_InterruptMask = ul_InterruptMask;
+		ps_Event->ul_Value[0]      = ul_Value[0];
+		ps_Event->ul_Value[1]      = 0;
+		ps_Event->b_ModuleNbr      = b_Module;
+
+		// If ETM interrupt informations
+		if ((0x60000UL & ul_InterruptMask) != 0)
+			ps_Event->ul_Value[1] = ul_Value[1];
+
+		/* Publish the event to the reader */
+		smp_store_release (&ps_Subscription->ul_Write, ul_Write + 1);
+
+		/* Woken up by the notification, see notify-kapi.c */
+		ps_Subscription->b_WakeUp = 1;
+	}
+}
+
+//------------------------------------------------------------------------------
+
+/** Wake up the readers of the subscriptions that received an event.
+ *
+ * Called from v_APCI1710_Notify, the board lock is held.
+ */
+void apci1710_event_wake_up (struct pci_dev * pdev)
+{
+	str_EventSubscription * ps_Subscription = NULL;
+
+	list_for_each_entry (ps_Subscription, &(APCI1710_PRIVDATA(pdev)->subscriptions), list)
+	{
+		if (ps_Subscription->b_WakeUp == 0)
+			continue;
+
+		ps_Subscription->b_WakeUp = 0;
+		wake_up_interruptible (&ps_Subscription->wq);
+	}
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the number of pending events of the file subscription.
+ *
+ * Lock free, the result is only a hint if called without the read_lock.
+ */
+int apci1710_event_pending (struct apci1710_str_FileInformations * ps_File)
+{
+	str_EventSubscription * ps_Subscription = &ps_File->s_Subscription;
+
+	return (int) (smp_load_acquire (&ps_Subscription->ul_Write) - ps_Subscription->ul_Read);
+}
+
+//------------------------------------------------------------------------------
+
+/** Remove the oldest event from the file subscription.
+ *
+ * Must be called with the read_lock of the file held.
+ *
+ * @retval 0: No error, the event is returned.
+ * @retval 1: No event pending.
+ * @retval 2: The file has no subscription.
+ */
+int apci1710_event_pop (struct apci1710_str_FileInformations * ps_File, str_APCI1710_Event * ps_Event)
+{
+	str_EventSubscription * ps_Subscription = &ps_File->s_Subscription;
+	uint32_t ul_Read = ps_Subscription->ul_Read;
+
+	if (ps_Subscription->ps_Ring == NULL)
+		return 2;
+
+	if (smp_load_acquire (&ps_Subscription->ul_Write) == ul_Read)
+		return 1;
+
+	*ps_Event = ps_Subscription->ps_Ring[ul_Read & (ps_Subscription->ul_Size - 1)];
+
+	/* Give the slot back to the interrupt routine */
+	smp_store_release (&ps_Subscription->ul_Read, ul_Read + 1);
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Cancel the subscription of a file.
+ *
+ * Must be called with the read_lock of the file held.
+ *
+ * @retval 0: No error.
+ * @retval 2: The file has no subscription.
+ */
+static int apci1710_event_unsubscribe (struct apci1710_str_FileInformations * ps_File)
+{
+	str_EventSubscription * ps_Subscription = &ps_File->s_Subscription;
+	str_APCI1710_Event * ps_Ring = ps_Subscription->ps_Ring;
+
+	if (ps_Ring == NULL)
+		return 2;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(ps_File->pdev,&irqstate);
+		{
+			list_del (&ps_Subscription->list);
+			ps_Subscription->ps_Ring = NULL;
+		}
+		APCI1710_UNLOCK(ps_File->pdev, irqstate);
+	}
+
+	/* The interrupt routine does not see the ring anymore */
+	vfree (ps_Ring);
+
+	/* Wake up the readers, they will return */
+	wake_up_interruptible (&ps_Subscription->wq);
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Subscribe a file to the board events.
+ *
+ * Must be called with the read_lock of the file held.
+ *
+ * @retval 0: No error.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: The ring size is wrong.
+ * @retval -ENOMEM : Fail to allocate the ring.
+ *
+ * The ring is virtually contiguous: the largest one takes 1.5 MB.
+ */
+static int apci1710_event_subscribe (struct apci1710_str_FileInformations * ps_File,
+                                     uint8_t b_ModuleMask,
+                                     uint32_t ul_InterruptMask,
+                                     uint32_t ul_RingSize)
+{
+	str_EventSubscription * ps_Subscription = &ps_File->s_Subscription;
+	str_APCI1710_Event * ps_Ring = NULL;
+
+	if ((b_ModuleMask == 0) || (b_ModuleMask >= (1 << NUMBER_OF_MODULE(ps_File->pdev))))
+		return 2;
+
+	if (ul_RingSize > APCI1710_SUBSCRIPTION_MAX_SIZE)
+		return 3;
+
+	if (ul_RingSize == 0)
+		ul_RingSize = APCI1710_SUBSCRIPTION_DEFAULT_SIZE;
+
+	ul_RingSize = roundup_pow_of_two (ul_RingSize);
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,20)
+	ps_Ring = vmalloc (ul_RingSize * sizeof (str_APCI1710_Event));
+#else
+	ps_Ring = vmalloc_node (ul_RingSize * sizeof (str_APCI1710_Event), APCI1710_NODE(ps_File->pdev));
+#endif
+	if (ps_Ring == NULL)
+		return -ENOMEM;
+
+	/* Replace a previous subscription */
+	apci1710_event_unsubscribe (ps_File);
+
+	ps_Subscription->b_ModuleMask     = b_ModuleMask;
+	ps_Subscription->ul_InterruptMask = ul_InterruptMask;
+	ps_Subscription->ul_Size          = ul_RingSize;
+	ps_Subscription->ul_Write         = 0;
+	ps_Subscription->ul_Read          = 0;
+	ps_Subscription->ul_LostEvents    = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(ps_File->pdev,&irqstate);
+		{
+			ps_Subscription->ps_Ring = ps_Ring;
+			list_add_tail (&ps_Subscription->list, &(APCI1710_PRIVDATA(ps_File->pdev)->subscriptions));
+		}
+		APCI1710_UNLOCK(ps_File->pdev, irqstate);
+	}
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Detach the subscriptions of a board being removed.
+ *
+ * Called by apci1710_known_dev_remove with the remove_sem of the board held
+ * for writing: no file operation runs. The rings are freed and the readers
+ * woken up, they see the board removed.
+ * The subscriptions leave the board list under the lock, the rings are
+ * freed out of it (vfree may not run with the interrupts disabled).
+ */
+void apci1710_event_detach_all (struct pci_dev * pdev)
+{
+	str_EventSubscription * ps_Subscription = NULL;
+	str_EventSubscription * ps_Next = NULL;
+	LIST_HEAD(s_Detached);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			list_splice_init (&(APCI1710_PRIVDATA(pdev)->subscriptions), &s_Detached);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	list_for_each_entry_safe (ps_Subscription, ps_Next, &s_Detached, list)
+	{
+		str_APCI1710_Event * ps_Ring = NULL;
+		unsigned long irqstate;
+
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			list_del_init (&ps_Subscription->list);
+			ps_Ring = ps_Subscription->ps_Ring;
+			ps_Subscription->ps_Ring = NULL;
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+
+		vfree (ps_Ring);
+		wake_up_interruptible (&ps_Subscription->wq);
+	}
+}
+
+//------------------------------------------------------------------------------
+
+/** Release the subscription of a file being closed. */
+void apci1710_event_release (struct apci1710_str_FileInformations * ps_File)
+{
+	mutex_lock (&ps_File->read_lock);
+	apci1710_event_unsubscribe (ps_File);
+	mutex_unlock (&ps_File->read_lock);
+}
+
+//------------------------------------------------------------------------------
+
+/** Subscribe the file to the board events.
+ *
+ * @param [in] filp                        : The file to subscribe.
+ * @param [in] arg[0] (b_ModuleMask)       : Modules to listen (bit n set: module n).
+ * @param [in] arg[1] (ul_InterruptMask)   : Interrupt mask filter, 0: all the events.
+ * @param [in] arg[2] (ul_RingSize)        : Number of events of the ring (0: default).
+ *
+ * @retval 0: No error.
+ * @retval 2: The module mask is wrong.
+ * @retval 3: The ring size is wrong.
+ * @retval -ENOMEM : Fail to allocate the ring.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+static int do_CMD_APCI1710_SubscribeEvents (struct file *filp, unsigned int cmd, unsigned long arg)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[3];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	if (dw_ArgArray[0] > 0xFF)
+		return 2;
+
+	mutex_lock (&ps_File->read_lock);
+	{
+		i_ErrorCode = apci1710_event_subscribe (ps_File,
+		                                        (uint8_t) dw_ArgArray[0], // b_ModuleMask
+		                                        dw_ArgArray[1],           // ul_InterruptMask
+		                                        dw_ArgArray[2]);          // ul_RingSize
+	}
+	mutex_unlock (&ps_File->read_lock);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Cancel the subscription of the file.
+ *
+ * @retval 0: No error.
+ * @retval 2: The file has no subscription.
+ */
+static int do_CMD_APCI1710_UnsubscribeEvents (struct file *filp, unsigned int cmd, unsigned long arg)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	int i_ErrorCode = 0;
+
+	mutex_lock (&ps_File->read_lock);
+	{
+		i_ErrorCode = apci1710_event_unsubscribe (ps_File);
+	}
+	mutex_unlock (&ps_File->read_lock);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the oldest pending event of the file subscription.
+ *
+ * @param [out] arg (str_APCI1710_Event) : The event.
+ *
+ * @retval 0: No error, the event is returned.
+ * @retval 1: No event pending.
+ * @retval 2: The file has no subscription.
+ * @retval -EFAULT : Fail to write user data.
+ */
+static int do_CMD_APCI1710_TestSubscribedEvent (struct file *filp, unsigned int cmd, unsigned long arg)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	int i_ErrorCode = 0;
+	str_APCI1710_Event s_Event;
+
+	mutex_lock (&ps_File->read_lock);
+	{
+		i_ErrorCode = apci1710_event_pop (ps_File, &s_Event);
+	}
+	mutex_unlock (&ps_File->read_lock);
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (str_APCI1710_Event __user *)arg, &s_Event, sizeof(s_Event) ) )
+		return -EFAULT;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the status of the file subscription.
+ *
+ * @param [out] arg[0] (ul_PendingEvents) : Number of events not read yet.
+ * @param [out] arg[1] (ul_LostEvents)    : Number of events lost since the last call.
+ * @param [out] arg[2] (ul_RingSize)      : Number of events of the ring.
+ *
+ * @retval 0: No error.
+ * @retval 2: The file has no subscription.
+ * @retval -EFAULT : Fail to write user data.
+ */
+static int do_CMD_APCI1710_GetSubscriptionStatus (struct file *filp, unsigned int cmd, unsigned long arg)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	str_EventSubscription * ps_Subscription = &ps_File->s_Subscription;
+	int i_ErrorCode = 0;
+	uint32_t dw_ArgArray[3] = {0, 0, 0};
+
+	mutex_lock (&ps_File->read_lock);
+	if (ps_Subscription->ps_Ring == NULL)
+	{
+		i_ErrorCode = 2;
+	}
+	else
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(ps_File->pdev,&irqstate);
+		{
+			dw_ArgArray[0] = ps_Subscription->ul_Write - ps_Subscription->ul_Read;
+			dw_ArgArray[1] = ps_Subscription->ul_LostEvents;
+			dw_ArgArray[2] = ps_Subscription->ul_Size;
+			ps_Subscription->ul_LostEvents = 0;
+		}
+		APCI1710_UNLOCK(ps_File->pdev, irqstate);
+	}
+	mutex_unlock (&ps_File->read_lock);
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (uint32_t __user *)arg, dw_ArgArray, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Handle the ioctl commands that work on the open file instead of the board.
+ *
+ * @retval -ENOIOCTLCMD : Not a file command, use apci1710_do_ioctl().
+ */
+int apci1710_do_file_ioctl (struct file *filp, unsigned int cmd, unsigned long arg)
+{
+	switch (cmd)
+	{
+		case CMD_APCI1710_SubscribeEvents:
+			return do_CMD_APCI1710_SubscribeEvents (filp, cmd, arg);
+
+		case CMD_APCI1710_UnsubscribeEvents:
+			return do_CMD_APCI1710_UnsubscribeEvents (filp, cmd, arg);
+
+		case CMD_APCI1710_TestSubscribedEvent:
+			return do_CMD_APCI1710_TestSubscribedEvent (filp, cmd, arg);
+
+		case CMD_APCI1710_GetSubscriptionStatus:
+			return do_CMD_APCI1710_GetSubscriptionStatus (filp, cmd, arg);
+
+		default:
+			return -ENOIOCTLCMD;
+	}
+}
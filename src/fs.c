@@ -35,17 +35,55 @@
 */
 
 #include "apci1710-private.h"
+#include "knowndev.h"
 
 EXPORT_NO_SYMBOLS;
 
 //------------------------------------------------------------------------------
 
+/** Begin a file operation on the board of the file.
+ *
+ * The board can not be removed until apci1710_file_end() is called.
+ *
+ * @retval 0: No error.
+ * @retval -ENODEV : The board has been removed.
+ */
+static int apci1710_file_begin(struct apci1710_str_FileInformations * ps_File)
+{
+	down_read(&ps_File->ps_Board->remove_sem);
+	if (ps_File->ps_Board->b_Removed)
+	{
+		up_read(&ps_File->ps_Board->remove_sem);
+		return -ENODEV;
+	}
+	return 0;
+}
+
+/** End a file operation started by apci1710_file_begin(). */
+static void apci1710_file_end(struct apci1710_str_FileInformations * ps_File)
+{
+	up_read(&ps_File->ps_Board->remove_sem);
+}
+
+//------------------------------------------------------------------------------
+
 /** Asynchronous signal.
  *
  */
 int apci1710_fasync_lookup(int fd, struct file *filp, int mode)
 {
-	return fasync_helper(fd, filp, mode, & (APCI1710_PRIVDATA(filp->private_data)->async_queue) );
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	int ret = 0;
+
+	down_read(&ps_File->ps_Board->remove_sem);
+	/* the file can still leave the queue of a removed board (close), not join it */
+	if (ps_File->ps_Board->b_Removed && mode)
+		ret = -ENODEV;
+	else
+		ret = fasync_helper(fd, filp, mode, & (ps_File->ps_Board->async_queue) );
+	up_read(&ps_File->ps_Board->remove_sem);
+
+	return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -55,18 +93,39 @@ int apci1710_fasync_lookup(int fd, struct file *filp, int mode)
 *
 * When opening, the pci_dev associated to the minor number is looked up
 * and associated with the file structure. It avoid further lookup when calling ioctl()
-* 
+* The file also gets its own data to hold its event subscription.
 *
+* The file holds a reference on the board until it is released: a board removed
+* meanwhile is never replaced by the board which gets the same minor number.
 */
 int apci1710_open_lookup (struct inode *inode, struct file *filp)
 {
-   if ( apci1710_INDEX_NOT_VALID(&apci1710_count, MINOR(inode->i_rdev) ) )
+   struct apci1710_str_FileInformations * ps_File = NULL;
+   struct apci1710_str_BoardInformations * ps_Board = NULL;
+
+   /* minor numbers of removed boards are free */
+   ps_Board = apci1710_get_board_by_index(MINOR(inode->i_rdev) );
+   if (!ps_Board)
    {
    	return -ENODEV;
    }
-      
-   filp->private_data = apci1710_lookup_board_by_index(MINOR(inode->i_rdev) );  
-   
+
+   ps_File = kzalloc(sizeof(struct apci1710_str_FileInformations), GFP_KERNEL);
+   if (!ps_File)
+   {
+   	pci_dev_put(ps_Board->pdev);
+   	apci1710_put_board(ps_Board);
+   	return -ENOMEM;
+   }
+
+   ps_File->pdev = ps_Board->pdev;
+   ps_File->ps_Board = ps_Board;
+   mutex_init(&ps_File->read_lock);
+   INIT_LIST_HEAD(&ps_File->s_Subscription.list);
+   init_waitqueue_head(&ps_File->s_Subscription.wq);
+
+   filp->private_data = ps_File;
+
    MOD_INC_USE_COUNT;
    return 0;   
 }
@@ -76,10 +135,24 @@ int apci1710_open_lookup (struct inode *inode, struct file *filp)
 */
 int apci1710_release_lookup (struct inode *inode,struct file *filp)
 {
+   struct apci1710_str_FileInformations * ps_File = filp->private_data;
 
-   if ( apci1710_INDEX_NOT_VALID(&apci1710_count, MINOR(inode->i_rdev) ) )
+   /* the file data is released even if the board was removed meanwhile */
+   if (ps_File)
    {
-   	return -ENODEV;
+   	struct apci1710_str_BoardInformations * ps_Board = ps_File->ps_Board;
+   	struct pci_dev * pdev = ps_File->pdev;
+
+   	/* the subscription of a removed board is already detached */
+   	down_read(&ps_Board->remove_sem);
+   	apci1710_event_release(ps_File);
+   	up_read(&ps_Board->remove_sem);
+
+   	kfree(ps_File);
+   	filp->private_data = NULL;
+
+   	pci_dev_put(pdev);
+   	apci1710_put_board(ps_Board);
    }
 
    MOD_DEC_USE_COUNT;
@@ -111,27 +184,164 @@ int apci1710_release_lookup (struct inode *inode,struct file *filp)
 	#endif
 #endif
 
-   if ( apci1710_INDEX_NOT_VALID(&apci1710_count, MINOR(inode->i_rdev) ) )
-   {
-   	return -ENODEV;
-   }  
-     
    if (!filp->private_data) // private data is initialised to NULL
    {
    	printk(KERN_CRIT "%s: %s: board data should be affected but is not (did you call open() before ioctl() ?) \n",__DRIVER_NAME, __FUNCTION__);
 	return -EBADFD;
    }
 
+   /* the board of the file, not the one which may have its minor number now */
+   ret = apci1710_file_begin(filp->private_data);
+   if (ret)
+   	return ret;
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,36) && LINUX_VERSION_CODE < KERNEL_VERSION(2,6,39)
    lock_kernel();
 #endif
 
-	   ret = apci1710_do_ioctl( (struct pci_dev*) filp->private_data, cmd, arg);
+	   ret = apci1710_do_file_ioctl(filp, cmd, arg);
+	   if (ret == -ENOIOCTLCMD)
+		   ret = apci1710_do_ioctl( APCI1710_FILE_PDEV(filp), cmd, arg);
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,36) && LINUX_VERSION_CODE < KERNEL_VERSION(2,6,39)
    unlock_kernel();
 #endif
 
+   apci1710_file_end(filp->private_data);
+
    return ret;
 }
 
+//------------------------------------------------------------------------------
+/** read() function of the module for the APCI-XXXX.
+*
+* Returns the pending events of the file subscription as an array of str_APCI1710_Event
+* (see CMD_APCI1710_SubscribeEvents). Blocks until at least one event is available
+* unless the file is opened with O_NONBLOCK.
+*/
+ssize_t apci1710_read_lookup (struct file *filp, char __user *buf, size_t count, loff_t *ppos)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+	str_APCI1710_Event s_Event;
+	ssize_t ret = 0;
+
+	if (count < sizeof(str_APCI1710_Event))
+		return -EINVAL;
+
+	while (1)
+	{
+		int i_ErrorCode = 0;
+
+		i_ErrorCode = apci1710_file_begin(ps_File);
+		if (i_ErrorCode)
+			return (ret ? ret : i_ErrorCode);
+
+		if (mutex_lock_interruptible(&ps_File->read_lock))
+		{
+			apci1710_file_end(ps_File);
+			return -ERESTARTSYS;
+		}
+
+		while ( (count - ret) >= sizeof(str_APCI1710_Event) )
+		{
+			i_ErrorCode = apci1710_event_pop(ps_File, &s_Event);
+			if (i_ErrorCode != 0)
+				break;
+
+			if ( copy_to_user(buf + ret, &s_Event, sizeof(s_Event) ) )
+			{
+				/* the event is lost */
+				mutex_unlock(&ps_File->read_lock);
+				apci1710_file_end(ps_File);
+				return -EFAULT;
+			}
+			ret += sizeof(str_APCI1710_Event);
+		}
+
+		mutex_unlock(&ps_File->read_lock);
+		apci1710_file_end(ps_File);
+
+		/* no subscription */
+		if (i_ErrorCode == 2)
+			return (ret ? ret : -EINVAL);
+
+		if (ret)
+			return ret;
+
+		if (filp->f_flags & O_NONBLOCK)
+			return -EAGAIN;
+
+		if (wait_event_interruptible(ps_File->s_Subscription.wq,
+		                             (apci1710_event_pending(ps_File) != 0) || (ps_File->s_Subscription.ps_Ring == NULL) ))
+			return -ERESTARTSYS;
+	}
+}
+
+//------------------------------------------------------------------------------
+/** poll() function of the module for the APCI-XXXX.
+*
+* The file is readable when its subscription holds pending events.
+*/
+unsigned int apci1710_poll_lookup (struct file *filp, poll_table *wait)
+{
+	struct apci1710_str_FileInformations * ps_File = filp->private_data;
+
+	poll_wait(filp, &ps_File->s_Subscription.wq, wait);
+
+	/* the subscription has been detached */
+	if (ps_File->ps_Board->b_Removed)
+		return POLLERR | POLLHUP;
+
+	if (ps_File->s_Subscription.ps_Ring == NULL)
+		return POLLERR;
+
+	if (apci1710_event_pending(ps_File) != 0)
+		return POLLIN | POLLRDNORM;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+/** mmap() function of the module for the APCI-XXXX.
+*
+* Maps the latest value cache of the board (page APCI1710_MMAP_VALUE_CACHE) or
+* the position stream of an EnDat channel (page APCI1710_MMAP_ENDAT_STREAM) read only.
+*/
+int apci1710_mmap_lookup (struct file *filp, struct vm_area_struct *vma)
+{
+	struct pci_dev * pdev = APCI1710_FILE_PDEV(filp);
+	unsigned long size = vma->vm_end - vma->vm_start;
+	unsigned long area_size = PAGE_SIZE;
+	void * area = NULL;
+	int ret = 0;
+
+	/* the user can only read */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	ret = apci1710_file_begin(filp->private_data);
+	if (ret)
+		return ret;
+
+	if (vma->vm_pgoff == APCI1710_MMAP_VALUE_CACHE)
+		area = APCI1710_PRIVDATA(pdev)->s_ValueCache.ps_Cache;
+	else
+		area = apci1710_endat_stream_area(pdev, vma->vm_pgoff, &area_size);
+
+	if ( (area == NULL) || (size > area_size) )
+		ret = -EINVAL;
+	else
+	{
+		unsigned long offset = 0;
+
+		/* the mapping holds a reference on the pages, it can outlive the board */
+		for (offset = 0; (offset < size) && (ret == 0); offset += PAGE_SIZE)
+			ret = vm_insert_page(vma, vma->vm_start + offset, virt_to_page((char *) area + offset));
+	}
+
+	apci1710_file_end(filp->private_data);
+
+	return ret;
+}
@@ -0,0 +1,166 @@
+/** @file handle-kapi.c
+ 
+   Prepared handles for the hot paths of other kernel modules (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include "cache-private-kapi.h"
+#include "counter64-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_PrepareHandle);
+EXPORT_SYMBOL(i_APCI1710_ExecuteHandle);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Test if the module of a handle is initialised for its operation. */
+static __inline__ int i_APCI1710_HandleModuleInitialised (struct pci_dev *pdev,
+                                                          uint8_t b_ModulNbr,
+                                                          uint8_t b_Operation)
+	{
+	switch (b_Operation)
+		{
+		case APCI1710_HANDLE_READ_COUNTER32:
+			return APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_CounterInit == 1;
+
+		case APCI1710_HANDLE_READ_DIGITAL_PORT:
+			return APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_DigitalIOInfo.b_DigitalInit == 1;
+
+		case APCI1710_HANDLE_READ_TTL_PORT:
+			return APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_TTLInit == 1;
+
+		default:
+			return 0;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Validate an access to a module once and prepare it in a handle.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ * @param [in] b_Operation           : APCI1710_HANDLE_xxx.
+ *
+ * @param [out] ps_Handle            : The prepared handle.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module does not support the operation.
+ * @retval 4: The module is not initialised.
+ */
+int i_APCI1710_PrepareHandle (struct pci_dev *pdev,
+                              uint8_t b_ModulNbr,
+                              uint8_t b_Operation,
+                              str_APCI1710_PreparedHandle * ps_Handle)
+	{
+	uint32_t ul_Functionality = 0;
+
+	if (!pdev || !ps_Handle) return 1;
+
+	if (b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+		return 2;
+
+	switch (b_Operation)
+		{
+		case APCI1710_HANDLE_READ_COUNTER32:    ul_Functionality = APCI1710_INCREMENTAL_COUNTER; break;
+		case APCI1710_HANDLE_READ_DIGITAL_PORT: ul_Functionality = APCI1710_DIGITAL_IO;          break;
+		case APCI1710_HANDLE_READ_TTL_PORT:     ul_Functionality = APCI1710_TTL_IO;              break;
+		default:
+			return 3;
+		}
+
+	if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != ul_Functionality)
+		return 3;
+
+	if (!i_APCI1710_HandleModuleInitialised (pdev, b_ModulNbr, b_Operation))
+		return 4;
+
+	ps_Handle->pdev        = pdev;
+	ps_Handle->ui_Address  = GET_BAR2(pdev) + MODULE_OFFSET(b_ModulNbr);
+	ps_Handle->b_ModulNbr  = b_ModulNbr;
+	ps_Handle->b_Operation = b_Operation;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Execute the operation of a prepared handle.
+ *
+ * The board lock is held by the caller.
+ *
+ * @param [in] ps_Handle             : Handle prepared by i_APCI1710_PrepareHandle.
+ *
+ * @param [out] pul_Value            : Value read.
+ *
+ * @retval 0: No error.
+ * @retval 4: The module is not initialised anymore.
+ */
+int i_APCI1710_ExecuteHandle (const str_APCI1710_PreparedHandle * ps_Handle,
+                              uint32_t * pul_Value)
+	{
+	if (unlikely (!i_APCI1710_HandleModuleInitialised (ps_Handle->pdev, ps_Handle->b_ModulNbr, ps_Handle->b_Operation)))
+		return 4;
+
+	switch (ps_Handle->b_Operation)
+		{
+		case APCI1710_HANDLE_READ_COUNTER32:
+			/* Latch the counter in the first latch register and read it */
+			OUTPDW (ps_Handle->ui_Address, 0, 1);
+			INPDW (ps_Handle->ui_Address, 4, pul_Value);
+			/* Same hooks as i_APCI1710_Read32BitCounterValue */
+			v_APCI1710_ExtendCounterValue (ps_Handle->pdev, ps_Handle->b_ModulNbr, *pul_Value);
+			break;
+
+		case APCI1710_HANDLE_READ_DIGITAL_PORT:
+			INPDW (ps_Handle->ui_Address, 0, pul_Value);
+			*pul_Value = (*pul_Value ^ 0x1C) & 0xFF;
+			break;
+
+		case APCI1710_HANDLE_READ_TTL_PORT:
+			INPDW (ps_Handle->ui_Address, 0, pul_Value);
+			*pul_Value &= 0x03FFFFFFUL;
+			break;
+		}
+
+	/* The value read is the latest value of the module, like the read functions publish it */
+	v_APCI1710_UpdateValueCache (ps_Handle->pdev, ps_Handle->b_ModulNbr, *pul_Value);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -46,6 +46,7 @@
  
 
 #include "apci1710-private.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitPulseEncoder);
 EXPORT_SYMBOL(i_APCI1710_EnablePulseEncoder);
@@ -53,6 +54,10 @@ EXPORT_SYMBOL(i_APCI1710_DisablePulseEncoder);
 EXPORT_SYMBOL(i_APCI1710_ReadPulseEncoderStatus);
 EXPORT_SYMBOL(i_APCI1710_ReadPulseEncoderValue);
 EXPORT_SYMBOL(i_APCI1710_WritePulseEncoderValue);
+EXPORT_SYMBOL(i_APCI1710_QueuePulseEncoderValues);
+EXPORT_SYMBOL(i_APCI1710_GetPulseEncoderQueueStatus);
+EXPORT_SYMBOL(i_APCI1710_ClearPulseEncoderQueue);
+EXPORT_SYMBOL(i_APCI1710_ReadAllPulseEncoderValues);
 
 EXPORT_NO_SYMBOLS;
 
@@ -67,6 +72,12 @@ static __inline__ int IMP_COUNTER_NOT_INITIALISED(struct pci_dev * pdev, uint8_t
 	return ( APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_PulseEncoderModuleInfo.s_PulseEncoderInfo [(int)b_PulseEncoderNbr].b_PulseEncoderInit != 1 );
 }
 
+/* empties the reload queue of a pulse encoder */
+static __inline__ void v_APCI1710_ResetPulseEncoderQueue(struct pci_dev * pdev, uint8_t b_ModulNbr, uint8_t b_PulseEncoderNbr)
+{
+	memset (&APCI1710_PRIVDATA(pdev)->s_PulseEncoderQueue [b_ModulNbr][b_PulseEncoderNbr], 0, sizeof (str_PulseEncoderQueue));
+}
+
 //------------------------------------------------------------------------------
        	
 /** Initialize the impuls counter.
@@ -236,6 +247,8 @@ int   i_APCI1710_InitPulseEncoder     (struct pci_dev *pdev,
 			  s_PulseEncoderModuleInfo.
 			  s_PulseEncoderInfo [b_PulseEncoderNbr].
 			  b_PulseEncoderInit = 1;
+
+			  v_APCI1710_ResetPulseEncoderQueue (pdev, b_ModulNbr, b_PulseEncoderNbr);
 			  }
 		       else
 			  {
@@ -291,6 +304,17 @@ int   i_APCI1710_InitPulseEncoder     (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_INIT);
+		ps_Config->u.s_PulseEncoder.b_EncoderMask |= (1 << b_PulseEncoderNbr);
+		ps_Config->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].b_InputLevelSelection = b_InputLevelSelection;
+		ps_Config->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].b_TriggerOutputAction = b_TriggerOutputAction;
+		ps_Config->u.s_PulseEncoder.s_Encoder[b_PulseEncoderNbr].ul_StartValue         = ul_StartValue;
+		}
+
 	return (i_ReturnValue);
 	}
 
@@ -519,6 +543,8 @@ int   i_APCI1710_EnablePulseEncoder   (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 	
@@ -617,6 +643,8 @@ int   i_APCI1710_DisablePulseEncoder  (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 
@@ -1094,3 +1122,326 @@ int   i_APCI1710_PulseEncoderSetDigitalOutputOff (struct pci_dev *pdev, uint8_t
 
 	return (i_ReturnValue);
 	}
+
+//------------------------------------------------------------------------------
+
+/* returns the error code of the queue functions for this pulse encoder, 0 if usable */
+static int i_APCI1710_TestPulseEncoderQueue (struct pci_dev *pdev, uint8_t b_ModulNbr, uint8_t b_PulseEncoderNbr)
+	{
+	if ((b_ModulNbr >= NUMBER_OF_MODULE(pdev)) ||
+	    (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_PULSE_ENCODER))
+	   {
+	   /*****************************/
+	   /* Module selection is wrong */
+	   /*****************************/
+
+	   return 2;
+	   }
+
+	if (b_PulseEncoderNbr > 3)
+	   {
+	   /************************************/
+	   /* Pulse encoder selection is wrong */
+	   /************************************/
+
+	   return 3;
+	   }
+
+	if (IMP_COUNTER_NOT_INITIALISED (pdev, b_ModulNbr, b_PulseEncoderNbr))
+	   {
+	   /*********************************/
+	   /* Pulse encoder not initialised */
+	   /*********************************/
+
+	   return 4;
+	   }
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Queue start values for a pulse encoder.
+ *
+ * Each underflow interrupt of the pulse encoder writes the next queued value
+ * as new start value, see v_APCI1710_ReloadPulseEncoder.
+ * The pulse encoder must be enabled in APCI1710_CONTINUOUS mode with its
+ * interrupt, the hardware then loads the written value on the next pulse.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ * @param [in] pul_Values        : Start values to queue (> 1).
+ * @param [in] ul_Count          : Number of values (1 to APCI1710_PULSE_ENCODER_QUEUE_SIZE).
+ *
+ * @param [out] pul_Queued       : Number of values queued, less than ul_Count
+ *                                 if the queue is full.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval 5: The number of values or a value is wrong.
+ */
+int   i_APCI1710_QueuePulseEncoderValues (struct pci_dev *pdev,
+                                          uint8_t        b_ModulNbr,
+                                          uint8_t        b_PulseEncoderNbr,
+                                          const uint32_t * pul_Values,
+                                          uint32_t       ul_Count,
+                                          uint32_t     * pul_Queued)
+	{
+	int i_ReturnValue = 0;
+	uint32_t ul_Cpt = 0;
+	str_PulseEncoderQueue * ps_Queue = NULL;
+
+	*pul_Queued = 0;
+
+	/***************************/
+	/* Test if board handle OK */
+	/***************************/
+
+	if (!pdev)
+	   {
+	   return 1;
+	   }
+
+	i_ReturnValue = i_APCI1710_TestPulseEncoderQueue (pdev, b_ModulNbr, b_PulseEncoderNbr);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	if ((ul_Count == 0) || (ul_Count > APCI1710_PULSE_ENCODER_QUEUE_SIZE))
+	   return 5;
+
+	for (ul_Cpt = 0; ul_Cpt < ul_Count; ul_Cpt ++)
+	   {
+	   /* Same limit as the start value of i_APCI1710_InitPulseEncoder */
+	   if (pul_Values [ul_Cpt] <= 1)
+	      return 5;
+	   }
+
+	ps_Queue = &APCI1710_PRIVDATA(pdev)->s_PulseEncoderQueue [b_ModulNbr][b_PulseEncoderNbr];
+
+	for (ul_Cpt = 0; (ul_Cpt < ul_Count) && ((ps_Queue->ul_Write - ps_Queue->ul_Read) < APCI1710_PULSE_ENCODER_QUEUE_SIZE); ul_Cpt ++)
+	   {
+	   ps_Queue->ul_Value [ps_Queue->ul_Write % APCI1710_PULSE_ENCODER_QUEUE_SIZE] = pul_Values [ul_Cpt];
+	   ps_Queue->ul_Write ++;
+	   }
+
+	ps_Queue->b_Active = 1;
+	*pul_Queued = ul_Cpt;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the state of the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ *
+ * @param [out] pul_Pending      : Number of values still queued.
+ * @param [out] pul_Underruns    : Number of interrupts which found the queue
+ *                                 empty since the last call.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ */
+int   i_APCI1710_GetPulseEncoderQueueStatus (struct pci_dev *pdev,
+                                             uint8_t        b_ModulNbr,
+                                             uint8_t        b_PulseEncoderNbr,
+                                             uint32_t     * pul_Pending,
+                                             uint32_t     * pul_Underruns)
+	{
+	int i_ReturnValue = 0;
+	str_PulseEncoderQueue * ps_Queue = NULL;
+
+	*pul_Pending = 0;
+	*pul_Underruns = 0;
+
+	/***************************/
+	/* Test if board handle OK */
+	/***************************/
+
+	if (!pdev)
+	   {
+	   return 1;
+	   }
+
+	i_ReturnValue = i_APCI1710_TestPulseEncoderQueue (pdev, b_ModulNbr, b_PulseEncoderNbr);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	ps_Queue = &APCI1710_PRIVDATA(pdev)->s_PulseEncoderQueue [b_ModulNbr][b_PulseEncoderNbr];
+
+	*pul_Pending = ps_Queue->ul_Write - ps_Queue->ul_Read;
+	*pul_Underruns = ps_Queue->ul_Underruns;
+	ps_Queue->ul_Underruns = 0;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Empty the reload queue of a pulse encoder.
+ *
+ * The current start value of the pulse encoder is kept.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ */
+int   i_APCI1710_ClearPulseEncoderQueue (struct pci_dev *pdev,
+                                         uint8_t        b_ModulNbr,
+                                         uint8_t        b_PulseEncoderNbr)
+	{
+	int i_ReturnValue = 0;
+
+	/***************************/
+	/* Test if board handle OK */
+	/***************************/
+
+	if (!pdev)
+	   {
+	   return 1;
+	   }
+
+	i_ReturnValue = i_APCI1710_TestPulseEncoderQueue (pdev, b_ModulNbr, b_PulseEncoderNbr);
+	if (i_ReturnValue)
+	   return i_ReturnValue;
+
+	v_APCI1710_ResetPulseEncoderQueue (pdev, b_ModulNbr, b_PulseEncoderNbr);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the value and status of all initialised pulse encoders of the board.
+ *
+ * The status register of each pulse encoder module is read once. The
+ * status of the returned pulse encoders is cleared like by
+ * i_APCI1710_ReadPulseEncoderStatus.
+ *
+ * @param [in] pdev              : The device to use.
+ *
+ * @param [out] ps_Values        : Values and status, bit (4 * module + encoder)
+ *                                 of the masks selects a pulse encoder.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised pulse encoder on this board.
+ */
+int   i_APCI1710_ReadAllPulseEncoderValues (struct pci_dev *pdev,
+                                            str_APCI1710_PulseEncoderValues * ps_Values)
+	{
+	uint8_t b_ModulNbr = 0;
+	uint8_t b_PulseEncoderNbr = 0;
+	uint32_t dw_StatusRegister = 0;
+	uint32_t dw_ReadMask = 0;
+	str_ModuleInfo * ps_ModuleInfo = NULL;
+
+	memset (ps_Values, 0, sizeof (*ps_Values));
+
+	/***************************/
+	/* Test if board handle OK */
+	/***************************/
+
+	if (!pdev)
+	   {
+	   return 1;
+	   }
+
+	for (b_ModulNbr = 0; b_ModulNbr < NUMBER_OF_MODULE(pdev); b_ModulNbr ++)
+	   {
+	   if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_PULSE_ENCODER)
+	      continue;
+
+	   ps_ModuleInfo = &APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr];
+
+	   /* Status bit (1 + n) of each initialised pulse encoder n */
+	   dw_ReadMask = 0;
+	   for (b_PulseEncoderNbr = 0; b_PulseEncoderNbr < 4; b_PulseEncoderNbr ++)
+	      {
+	      if (!IMP_COUNTER_NOT_INITIALISED (pdev, b_ModulNbr, b_PulseEncoderNbr))
+	         dw_ReadMask |= 1 << (1 + b_PulseEncoderNbr);
+	      }
+
+	   if (!dw_ReadMask)
+	      continue;
+
+	   /****************************/
+	   /* Read the status register */
+	   /****************************/
+
+	   INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr) + 16, &dw_StatusRegister);
+
+	   ps_ModuleInfo->s_PulseEncoderModuleInfo.dw_StatusRegister |= dw_StatusRegister;
+
+	   ps_Values->ul_InitMask   |= (dw_ReadMask >> 1) << (4 * b_ModulNbr);
+	   ps_Values->ul_StatusMask |= ((ps_ModuleInfo->s_PulseEncoderModuleInfo.dw_StatusRegister & dw_ReadMask) >> 1) << (4 * b_ModulNbr);
+
+	   ps_ModuleInfo->s_PulseEncoderModuleInfo.dw_StatusRegister &= ~dw_ReadMask;
+
+	   /*******************/
+	   /* Read the values */
+	   /*******************/
+
+	   for (b_PulseEncoderNbr = 0; b_PulseEncoderNbr < 4; b_PulseEncoderNbr ++)
+	      {
+	      if (dw_ReadMask & (1 << (1 + b_PulseEncoderNbr)))
+	         INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr) + (4 * b_PulseEncoderNbr), &ps_Values->ul_Value [b_ModulNbr][b_PulseEncoderNbr]);
+	      }
+	   }
+
+	if (!ps_Values->ul_InitMask)
+	   return 2;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Load the next queued start value of a pulse encoder.
+ *
+ * Called by the interrupt function of the pulse encoder module, with the
+ * board lock held, when the pulse encoder reached 0.
+ *
+ * @param [in] pdev              : The device.
+ * @param [in] b_ModulNbr        : Module number (0 to 3).
+ * @param [in] b_PulseEncoderNbr : Pulse encoder selection (0 to 3).
+ *
+ * @return Number of values still queued after the reload.
+ */
+uint32_t ul_APCI1710_ReloadPulseEncoder (struct pci_dev *pdev,
+                                         uint8_t        b_ModulNbr,
+                                         uint8_t        b_PulseEncoderNbr)
+	{
+	str_PulseEncoderQueue * ps_Queue = &APCI1710_PRIVDATA(pdev)->s_PulseEncoderQueue [b_ModulNbr][b_PulseEncoderNbr];
+
+	if (ps_Queue->ul_Write == ps_Queue->ul_Read)
+	   {
+	   /* The pulse encoder restarts with its current start value */
+	   if (ps_Queue->b_Active)
+	      ps_Queue->ul_Underruns ++;
+	   return 0;
+	   }
+
+	OUTPDW (GET_BAR2(pdev),
+	        MODULE_OFFSET(b_ModulNbr) + (4 * b_PulseEncoderNbr),
+	        ps_Queue->ul_Value [ps_Queue->ul_Read % APCI1710_PULSE_ENCODER_QUEUE_SIZE]);
+	ps_Queue->ul_Read ++;
+
+	return (ps_Queue->ul_Write - ps_Queue->ul_Read);
+	}
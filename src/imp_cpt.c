@@ -404,3 +404,174 @@ int do_CMD_APCI1710_PulseEncoderSetDigitalOutputOff (struct pci_dev *pdev, unsig
 	return (i_ErrorCode);
 }
 
+//------------------------------------------------------------------------------
+
+/** Queue start values for a pulse encoder.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ * @param [in] arg[2] (ul_Count)          : Number of values (1 to APCI1710_PULSE_ENCODER_QUEUE_SIZE).
+ * @param [in] arg[3 + n] (ul_Value)      : Start values to queue (> 1).
+ *
+ * @param [out] arg[2] (ul_Queued)        : Number of values queued.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval 5: The number of values or a value is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_QueuePulseEncoderValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t ui_ArgArray[3 + APCI1710_PULSE_ENCODER_QUEUE_SIZE];
+	uint32_t ui_Queued = 0;
+
+	if ( copy_from_user( ui_ArgArray, (uint32_t __user *)arg, 3 * sizeof(uint32_t) ) )
+		return -EFAULT;
+
+	if ((ui_ArgArray[2] == 0) || (ui_ArgArray[2] > APCI1710_PULSE_ENCODER_QUEUE_SIZE))
+		return 5;
+
+	if ( copy_from_user( &ui_ArgArray[3], ((uint32_t __user *)arg) + 3, ui_ArgArray[2] * sizeof(uint32_t) ) )
+		return -EFAULT;
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_QueuePulseEncoderValues (pdev,
+			                                                  (uint8_t) ui_ArgArray [0], // b_ModulNbr
+			                                                  (uint8_t) ui_ArgArray [1], // b_PulseEncoderNbr
+			                                                  &ui_ArgArray [3],          // pul_Values
+			                                                  ui_ArgArray [2],           // ul_Count
+			                                                  &ui_Queued);               // pul_Queued
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( ((uint32_t __user *)arg) + 2, &ui_Queued, sizeof(ui_Queued) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the state of the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ *
+ * @param [out] arg[0] (ul_Pending)       : Number of values still queued.
+ * @param [out] arg[1] (ul_Underruns)     : Interrupts which found the queue empty since the last call.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_GetPulseEncoderQueueStatus (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t ui_ArgArray[2];
+
+	if ( copy_from_user( ui_ArgArray, (uint32_t __user *)arg, sizeof(ui_ArgArray) ) )
+		return -EFAULT;
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_GetPulseEncoderQueueStatus (pdev,
+			                                                     (uint8_t) ui_ArgArray [0], // b_ModulNbr
+			                                                     (uint8_t) ui_ArgArray [1], // b_PulseEncoderNbr
+			                                                     &ui_ArgArray [0],          // pul_Pending
+			                                                     &ui_ArgArray [1]);         // pul_Underruns
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (uint32_t __user *)arg, ui_ArgArray, sizeof(ui_ArgArray) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Empty the reload queue of a pulse encoder.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg[0] (b_ModulNbr)        : Module number (0 to 3).
+ * @param [in] arg[1] (b_PulseEncoderNbr) : Pulse encoder selection (0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: Module selection is wrong
+ * @retval 3: Pulse encoder selection is wrong
+ * @retval 4: Pulse encoder not initialised. See function "i_APCI1710_InitPulseEncoder"
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_ClearPulseEncoderQueue (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint32_t ui_ArgArray[2];
+
+	if ( copy_from_user( ui_ArgArray, (uint32_t __user *)arg, sizeof(ui_ArgArray) ) )
+		return -EFAULT;
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ClearPulseEncoderQueue (pdev,
+			                                                 (uint8_t) ui_ArgArray [0],  // b_ModulNbr
+			                                                 (uint8_t) ui_ArgArray [1]); // b_PulseEncoderNbr
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Read the value and status of all initialised pulse encoders of the board.
+ *
+ * @param [in] pdev                       : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PulseEncoderValues) : The values and status.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised pulse encoder on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadAllPulseEncoderValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_PulseEncoderValues s_Values;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ReadAllPulseEncoderValues (pdev, &s_Values);
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (str_APCI1710_PulseEncoderValues __user *)arg, &s_Values, sizeof(s_Values) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
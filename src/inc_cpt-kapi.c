@@ -46,6 +46,9 @@
  
 
 #include "apci1710-private.h"
+#include "cache-private-kapi.h"
+#include "counter64-private-kapi.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitCounter);
 EXPORT_SYMBOL(i_APCI1710_ClearCounterValue);
@@ -445,6 +448,23 @@ int   i_APCI1710_InitCounter (struct pci_dev *pdev,
 	      s_SiemensCounterInfo.
 	      s_InitFlag.
 	      b_CounterInit = 1;
+
+	      APCI1710_PRIVDATA(pdev)->
+	      s_ModuleInfo [(int)b_ModulNbr].
+	      s_SiemensCounterInfo.
+	      s_InitFlag.
+	      b_Latch0Used = 0;
+
+	      v_APCI1710_ResetCounterExtension (pdev, b_ModulNbr);
+
+	      {
+	      str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+	      ps_Config->u.s_Counter.b_CounterRange        = b_CounterRange;
+	      ps_Config->u.s_Counter.b_FirstCounterModus   = b_FirstCounterModus;
+	      ps_Config->u.s_Counter.b_FirstCounterOption  = b_FirstCounterOption;
+	      ps_Config->u.s_Counter.b_SecondCounterModus  = b_SecondCounterModus;
+	      ps_Config->u.s_Counter.b_SecondCounterOption = b_SecondCounterOption;
+	      }
 	      }
 	   }
 	else
@@ -500,6 +520,8 @@ int   i_APCI1710_ClearCounterValue (struct pci_dev *pdev, uint8_t b_ModulNbr)
 	      /*********************/
 
 	      OUTPDW (GET_BAR2(pdev), 16 + MODULE_OFFSET(b_ModulNbr), 1);
+
+	      v_APCI1710_ResetCounterExtension (pdev, b_ModulNbr);
 	      }
 	   else
 	      {
@@ -562,6 +584,8 @@ int   i_APCI1710_ClearAllCounterValue (struct pci_dev *pdev)
 		 /*********************/
 
 		 OUTPDW (GET_BAR2(pdev), 16 + MODULE_OFFSET(b_ModulCpt), 1);
+
+		 v_APCI1710_ResetCounterExtension (pdev, b_ModulCpt);
 		 }
 	      }
 	   }
@@ -723,6 +747,12 @@ int i_APCI1710_SetInputFilter (struct pci_dev *pdev,
 	/* Write the configuration */
 	OUTPDW (GET_BAR2(pdev), 20 + MODULE_OFFSET(b_ModulNbr),APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_ModeRegister.dw_ModeRegister1_2_3_4);
 
+	{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_INPUT_FILTER);
+		ps_Config->u.s_Counter.b_PCIInputClock = b_PCIInputClock;
+		ps_Config->u.s_Counter.b_Filter        = b_Filter;
+	}
+
 	return 0;
 }
 
@@ -732,6 +762,8 @@ int i_APCI1710_SetInputFilter (struct pci_dev *pdev,
  * 
  * Latch the value from selected module (b_ModulNbr) 
  * in to the selected latch register (b_LatchReg).
+ * A latch into register 0 keeps the value cache sampler, the counter
+ * extension sampler and the boards snapshot off the module until the register is read with i_APCI1710_ReadLatchRegisterValue.
  *
  * @param [in] pdev          : The device to initialize.
  * @param [in] b_ModulNbr    : Module number to configure (0 to 3).
@@ -780,6 +812,10 @@ int   i_APCI1710_LatchCounter (struct pci_dev *pdev,
 		 /*********************/
 
 		 OUTPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), 1 << (b_LatchReg * 4));
+
+		 /* Keep the samplers off the register until it is read */
+		 if (b_LatchReg == 0)
+		    APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_Latch0Used = 1;
 		 }
 	      else
 		 {
@@ -957,6 +993,9 @@ int   i_APCI1710_ReadLatchRegisterValue (struct pci_dev *pdev,
 	      if (b_LatchReg < 2)
 		 {
 		 INPDW (GET_BAR2(pdev), ((b_LatchReg + 1) * 4) + MODULE_OFFSET(b_ModulNbr), pul_LatchValue);
+
+		 if (b_LatchReg == 0)
+		    APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_Latch0Used = 0;
 		 }
 	      else
 		 {
@@ -990,6 +1029,30 @@ int   i_APCI1710_ReadLatchRegisterValue (struct pci_dev *pdev,
 	}		
 
 //------------------------------------------------------------------------------
+
+/** Tell if the application uses latch register 0 of a counter module.
+ *
+ * The kernel samplers read the counter through latch register 0 like
+ * i_APCI1710_Read32BitCounterValue. They skip a module while a software
+ * latch into register 0 is not read back, while the index latches the
+ * counter into it (i_APCI1710_InitIndex) or while the latch interrupt
+ * is enabled, since each of their latches would raise it.
+ *
+ * @warning The board lock must be held.
+ *
+ * @retval 0: The samplers may latch the counter.
+ * @retval 1: Latch register 0 belongs to the application.
+ */
+int apci1710_inc_cpt_latch0_in_use (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_Latch0Used)
+		return 1;
+
+	return (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister2 &
+	        (APCI1710_ENABLE_LATCH_INT | APCI1710_INDEX_LATCH_COUNTER)) != 0;
+	}
+
+//------------------------------------------------------------------------------
 	
 /** Enable the latch interrupt. 
  * 
@@ -1112,6 +1175,8 @@ int   i_APCI1710_EnableLatchInterrupt (struct pci_dev *pdev, uint8_t b_ModulNbr)
 	   }
 
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 
@@ -1217,6 +1282,8 @@ int   i_APCI1710_DisableLatchInterrupt (struct pci_dev *pdev, uint8_t b_ModulNbr
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 
@@ -1369,6 +1436,9 @@ int   i_APCI1710_Read16BitCounterValue (struct pci_dev *pdev,
 	      /************************/
 
 	      INPDW (GET_BAR2(pdev), 4 + MODULE_OFFSET(b_ModulNbr), pul_CounterValue);
+
+	      v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, *pul_CounterValue);
+	      v_APCI1710_ExtendCounterValue (pdev, b_ModulNbr, *pul_CounterValue);
 	      }
 	   else
 	      {
@@ -1533,6 +1603,8 @@ int   i_APCI1710_Write32BitCounterValue (struct pci_dev *pdev,
 	      /*******************/
 
 	      OUTPDW (GET_BAR2(pdev), 4 + MODULE_OFFSET(b_ModulNbr), ul_WriteValue);
+
+	      v_APCI1710_ResetCounterExtension (pdev, b_ModulNbr);
 	      }
 	   else
 	      {
@@ -1604,6 +1676,8 @@ int   i_APCI1710_InitCompareLogic (struct pci_dev *pdev,
 	      s_SiemensCounterInfo.
 	      s_InitFlag.
 	      b_CompareLogicInit = 1;
+
+	      ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_COMPARE_LOGIC)->u.s_Counter.ul_CompareValue = ui_CompareValue;
 	      }
 	   else
 	      {
@@ -1744,6 +1818,8 @@ int   i_APCI1710_EnableCompareLogic (struct pci_dev *pdev, uint8_t   b_ModulNbr)
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 	
@@ -1845,6 +1921,8 @@ int   i_APCI1710_DisableCompareLogic  (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
 	return (i_ReturnValue);
 	}
 		
@@ -2988,6 +3066,16 @@ int i_APCI1710_InitIndex (struct pci_dev * pdev, uint8_t b_ModulNbr, uint8_t b_R
 	
 	APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_IndexInit = 1;
 
+	v_APCI1710_UpdateArmedModules (pdev);
+
+	{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_INDEX);
+		ps_Config->u.s_Counter.b_ReferenceAction = b_ReferenceAction;
+		ps_Config->u.s_Counter.b_IndexOperation  = b_IndexOperation;
+		ps_Config->u.s_Counter.b_AutoMode        = b_AutoMode;
+		ps_Config->u.s_Counter.b_InterruptEnable = b_InterruptEnable;
+	}
+
 	return 0;
 }
 
@@ -3111,6 +3199,9 @@ int i_APCI1710_GetIndexStatus (struct pci_dev * pdev, uint8_t b_ModulNbr, uint8_
 		uint32_t StatusReg;
 		INPDW  (GET_BAR2(pdev), 12 + MODULE_OFFSET(b_ModulNbr), &StatusReg);
 		 *pb_IndexStatus = (uint8_t) (StatusReg & 0x1);	
+
+		 if (*pb_IndexStatus)
+			 v_APCI1710_IndexCounterExtension (pdev, b_ModulNbr);
 	}
 	
 	return 0;
@@ -3222,6 +3313,8 @@ int i_APCI1710_InitReference (struct pci_dev * pdev, uint8_t b_ModulNbr, uint8_t
 
 	/* set flag to indicate reference was initialised */ 
 	APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SiemensCounterInfo.s_InitFlag.b_ReferenceInit = 1;
+
+	ps_APCI1710_RecordModuleStep (pdev, b_ModulNbr, APCI1710_CONFIG_REFERENCE)->u.s_Counter.b_ReferenceLevel = b_ReferenceLevel;
 			
 	return 0;
 }
@@ -1147,3 +1147,71 @@ int do_CMD_APCI1710_GetReferenceStatus (struct pci_dev *pdev, unsigned int cmd,
 
 	return 0;
  }
+
+//------------------------------------------------------------------------------
+
+/** Latch the 32-bit counter and return its 64-bit extended position.
+ *
+ * @param [in] pdev                       : The device to use.
+ * @param [in] arg (b_ModulNbr)           : Module number (0 to 3).
+ *
+ * @param [out] arg (ll_Position)         : 64-bit extended position.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No counter module found.
+ * @retval 3: Counter not initialised see function "i_APCI1710_InitCounter".
+ * @retval 4: The counter is not in 32-bit mode.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_Read64BitCounterValue (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	int64_t ll_Arg = 0;
+
+	if ( copy_from_user( &ll_Arg, (int64_t __user *)arg, sizeof(ll_Arg) ) )
+		return -EFAULT;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_Read64BitCounterValue (pdev,
+			                                                (uint8_t) ll_Arg,	// b_ModulNbr
+			                                                &ll_Arg);		// ll_Position
+		}
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	if ( copy_to_user( (int64_t __user *)arg , &ll_Arg, sizeof(ll_Arg) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Start or stop the counter extension sampler.
+ *
+ * The board is locked by i_APCI1710_SetCounterExtensionPeriod itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (ul_Period)       : Sampling period in us (0: stop the sampler).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetCounterExtensionPeriod (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	uint32_t ul_Period = 0;
+
+	if ( copy_from_user(&ul_Period, (uint32_t __user *)arg, sizeof(ul_Period) ) )
+		return -EFAULT;
+
+	return i_APCI1710_SetCounterExtensionPeriod (pdev, ul_Period);
+}
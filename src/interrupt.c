@@ -78,6 +78,7 @@ EXPORT_NO_SYMBOLS;
 	uint8_t b_ModuleCpt = 0;
 	uint8_t b_InterruptFlag = 0;
 	uint8_t b_InterruptFlagCount = 0;
+	uint8_t b_ArmedModules = 0;
 
 	{
 		unsigned long irqstate;
@@ -89,15 +90,17 @@ EXPORT_NO_SYMBOLS;
 					APCI1710_UNLOCK(VOID_TO_PCIDEV(dev_id), irqstate);
 					RETURN_NONE;
 			}
-			/* Test if the interrupt occured on one of the modules */
-			for (b_ModuleCpt = 0; b_ModuleCpt < NUMBER_OF_MODULE(VOID_TO_PCIDEV(dev_id)); b_ModuleCpt ++)
+			/* Test if the interrupt occured on one of the armed modules */
+			b_ArmedModules = APCI1710_PRIVDATA(VOID_TO_PCIDEV(dev_id))->b_ArmedModules;
+			for (b_ModuleCpt = 0; b_ArmedModules != 0; b_ModuleCpt ++, b_ArmedModules >>= 1)
 			{
-				/* Test if for this functionality any interrupt function installed */
-				if (APCI1710_PRIVDATA(VOID_TO_PCIDEV(dev_id))->s_InterruptFunctionality [b_ModuleCpt].v_InterruptFunction != NULL)
-				{
-					/* Call the interrupt function */
-					APCI1710_PRIVDATA(VOID_TO_PCIDEV(dev_id))->s_InterruptFunctionality [b_ModuleCpt].v_InterruptFunction (VOID_TO_PCIDEV(dev_id), b_ModuleCpt, &b_InterruptFlag);
-				}
+				/* No interrupt source enabled on this module, don't touch its registers */
+				if ((b_ArmedModules & 1) == 0)
+					continue;
+
+				/* Call the interrupt function */
+				b_InterruptFlag = 0;
+				APCI1710_PRIVDATA(VOID_TO_PCIDEV(dev_id))->s_InterruptFunctionality [b_ModuleCpt].v_InterruptFunction (VOID_TO_PCIDEV(dev_id), b_ModuleCpt, &b_InterruptFlag);
 				b_InterruptFlagCount = b_InterruptFlagCount + b_InterruptFlag;
 			}
 		}
@@ -122,6 +125,18 @@ int apci1710_register_interrupt(struct pci_dev * pdev)
 		outl((tmp | (1<<11) | (1 << 8)), GET_BAR1(pdev) + 0x68);
 	}
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,18)
+	/* A MSI vector is ours alone: its affinity can be set, see affinity-kapi.c */
+	if ( pci_enable_msi(pdev) == 0 )
+	{
+		if ( request_irq( pdev->irq, apci1710_do_interrupt, 0, __DRIVER_NAME, pdev) == 0 )
+			return 0;
+
+		/* Back to the INTx line */
+		pci_disable_msi(pdev);
+	}
+#endif
+
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,18)
 	if ( request_irq( pdev->irq, apci1710_do_interrupt, SA_SHIRQ, __DRIVER_NAME, pdev) )
 #else
@@ -139,6 +154,10 @@ int apci1710_register_interrupt(struct pci_dev * pdev)
 int apci1710_deregister_interrupt(struct pci_dev * pdev)
 {
 	free_irq( pdev->irq , pdev);
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,18)
+	/* Does nothing on the INTx line */
+	pci_disable_msi(pdev);
+#endif
 	return 0;
 }
 
@@ -63,6 +63,7 @@
 
 #include "apci1710-private.h"
 #include "vtable.h"
+#include "apci1710-trace.h"
 
 EXPORT_NO_SYMBOLS;
 
@@ -86,6 +87,7 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_CheckAndGetPCISlotNumber,do_CMD_APCI1710_CheckAndGetPCISlotNumber);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_GetHardwareInformation,do_CMD_APCI1710_GetHardwareInformation);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetBoardInformation,do_CMD_APCI1710_SetBoardInformation);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_ReadBoardsSnapshot,do_CMD_APCI1710_ReadBoardsSnapshot);
 
 	/* Incremental counter */
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_InitCounter,do_CMD_APCI1710_InitCounter);
@@ -99,6 +101,8 @@ void apci1710_init_vtable(vtable_t vtable)
 
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_Read16BitCounterValue,do_CMD_APCI1710_Read16BitCounterValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_Read32BitCounterValue,do_CMD_APCI1710_Read32BitCounterValue);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_Read64BitCounterValue,do_CMD_APCI1710_Read64BitCounterValue);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetCounterExtensionPeriod,do_CMD_APCI1710_SetCounterExtensionPeriod);
 
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalChlOn,do_CMD_APCI1710_SetDigitalChlOn);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalChlOff,do_CMD_APCI1710_SetDigitalChlOff);
@@ -124,11 +128,13 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalIOChlOff,do_CMD_APCI1710_SetDigitalIOChlOff);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalIOPortOn,do_CMD_APCI1710_SetDigitalIOPortOn);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalIOPortOff,do_CMD_APCI1710_SetDigitalIOPortOff);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetDigitalOutputsMasked,do_CMD_APCI1710_SetDigitalOutputsMasked);
 
 	/* TTL I/O */
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_InitTTLIODirection,do_CMD_APCI1710_InitTTLIODirection);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetTTLIOChlOn,do_CMD_APCI1710_SetTTLIOChlOn);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_SetTTLIOChlOff,do_CMD_APCI1710_SetTTLIOChlOff);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_ReadTTLIOAllPortValues,do_CMD_APCI1710_ReadTTLIOAllPortValues);
 
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_Write16BitCounterValue,do_CMD_APCI1710_Write16BitCounterValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable,CMD_APCI1710_Write32BitCounterValue,do_CMD_APCI1710_Write32BitCounterValue);
@@ -152,6 +158,10 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadPulseEncoderStatus,          do_CMD_APCI1710_ReadPulseEncoderStatus);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadPulseEncoderValue,           do_CMD_APCI1710_ReadPulseEncoderValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_WritePulseEncoderValue,          do_CMD_APCI1710_WritePulseEncoderValue);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_QueuePulseEncoderValues,        do_CMD_APCI1710_QueuePulseEncoderValues);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetPulseEncoderQueueStatus,      do_CMD_APCI1710_GetPulseEncoderQueueStatus);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ClearPulseEncoderQueue,          do_CMD_APCI1710_ClearPulseEncoderQueue);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadAllPulseEncoderValues,       do_CMD_APCI1710_ReadAllPulseEncoderValues);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_PulseEncoderSetDigitalOutputOn,  do_CMD_APCI1710_PulseEncoderSetDigitalOutputOn);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_PulseEncoderSetDigitalOutputOff, do_CMD_APCI1710_PulseEncoderSetDigitalOutputOff);
 
@@ -166,6 +176,41 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadChronoChlValue, do_CMD_APCI1710_ReadChronoChlValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadChronoPortValue, do_CMD_APCI1710_ReadChronoPortValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadChronoPortValue, do_CMD_APCI1710_ReadChronoPortValue);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetChronoStream, do_CMD_APCI1710_SetChronoStream);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadChronoStream, do_CMD_APCI1710_ReadChronoStream);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetChronoStatistics, do_CMD_APCI1710_GetChronoStatistics);
+
+	/* ETM */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetETMCapture, do_CMD_APCI1710_SetETMCapture);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadETMCapture, do_CMD_APCI1710_ReadETMCapture);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetETMCaptureStatistics, do_CMD_APCI1710_GetETMCaptureStatistics);
+
+	/* Scan program */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_LoadScanProgram, do_CMD_APCI1710_LoadScanProgram);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetScanStatus, do_CMD_APCI1710_GetScanStatus);
+
+	/* Position compare */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetPositionCompare, do_CMD_APCI1710_SetPositionCompare);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadPositionTriggers, do_CMD_APCI1710_ReadPositionTriggers);
+
+	/* Timed outputs */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_QueueTimedOutputs, do_CMD_APCI1710_QueueTimedOutputs);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadTimedOutputReports, do_CMD_APCI1710_ReadTimedOutputReports);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ClearTimedOutputs, do_CMD_APCI1710_ClearTimedOutputs);
+
+	/* Board affinity */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetBoardAffinity, do_CMD_APCI1710_SetBoardAffinity);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetBoardAffinity, do_CMD_APCI1710_GetBoardAffinity);
+
+	/* Board configuration */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ApplyBoardConfig, do_CMD_APCI1710_ApplyBoardConfig);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadBoardConfig, do_CMD_APCI1710_ReadBoardConfig);
+
+	/* Event replay */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReplayEvents, do_CMD_APCI1710_ReplayEvents);
+
+	/* Event notification coalescing */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetNotificationCoalescing, do_CMD_APCI1710_SetNotificationCoalescing);
 
 	/* BiSS */
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterInitSingleCycle, do_CMD_APCI1710_BissMasterInitSingleCycle);
@@ -173,6 +218,8 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterSingleCycleRegisterRead, do_CMD_APCI1710_BissMasterSingleCycleRegisterRead);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterSingleCycleRegisterWrite, do_CMD_APCI1710_BissMasterSingleCycleRegisterWrite);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterReleaseSingleCycle, do_CMD_APCI1710_BissMasterReleaseSingleCycle);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterRegisterTransfer, do_CMD_APCI1710_BissMasterRegisterTransfer);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_BissMasterSetStaticRegisters, do_CMD_APCI1710_BissMasterSetStaticRegisters);
 
 	/* SSI */
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_InitSSI, do_CMD_APCI1710_InitSSI);
@@ -202,12 +249,22 @@ void apci1710_init_vtable(vtable_t vtable)
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1711_EndatSensorSendPositionValue, do_CMD_APCI1711_EndatSensorSendPositionValue);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1711_EndatSelectAdditionalData, do_CMD_APCI1711_EndatSelectAdditionalData);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1711_EndatSensorSendPositionValueWithAdditionalData, do_CMD_APCI1711_EndatSensorSendPositionValueWithAdditionalData);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1711_EndatReadParameterArea, do_CMD_APCI1711_EndatReadParameterArea);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1711_EndatSetPositionStream, do_CMD_APCI1711_EndatSetPositionStream);
 
 	/* Utils */
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetModulesId, do_CMD_APCI1710_GetModulesId);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_GetBoardType, do_CMD_APCI1710_GetBoardType);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_WRITE, do_CMD_APCI1710_WRITE);
 	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_READ, do_CMD_APCI1710_READ);
+
+	/* Latest value cache */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_ReadValueCache, do_CMD_APCI1710_ReadValueCache);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetValueCacheSampler, do_CMD_APCI1710_SetValueCacheSampler);
+
+	/* Input edge detection */
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_InitEdgeDetection, do_CMD_APCI1710_InitEdgeDetection);
+	__APCI_1710_DECLARE_IOCTL_HANDLER(vtable, CMD_APCI1710_SetEdgeDetectionPeriod, do_CMD_APCI1710_SetEdgeDetectionPeriod);
 	
 	/* Balise */
 #ifdef WITH_BALISE_OPTION	
@@ -234,6 +291,7 @@ void apci1710_init_vtable(vtable_t vtable)
 //------------------------------------------------------------------------------
 int apci1710_do_ioctl(struct pci_dev * pdev,unsigned int cmd,unsigned long arg)
 {
+	int ret;
 
 	/* boundaries check
 	 *
@@ -244,11 +302,17 @@ int apci1710_do_ioctl(struct pci_dev * pdev,unsigned int cmd,unsigned long arg)
 	 *
 	 * */
 
+	trace_apci1710_ioctl_entry(pdev, cmd);
+
 	if (_IOC_NR(cmd) > (VTABLE_ELEMENT_NB(vtable_t)-1) )
-		return apci1710_do_dummy(pdev,cmd,arg);
+		ret = apci1710_do_dummy(pdev,cmd,arg);
+	else
+		/* call actual ioctl handler - should be safe now */
+		ret = (apci1710_vtable[_IOC_NR(cmd)]) (pdev, cmd, arg);
+
+	trace_apci1710_ioctl_exit(pdev, cmd, ret);
 
-	/* call actual ioctl handler - should be safe now */
-	return (apci1710_vtable[_IOC_NR(cmd)]) (pdev, cmd, arg);
+	return ret;
 }
 //------------------------------------------------------------------------------
 int do_CMD_APCI1710_CheckAndGetPCISlotNumber(struct pci_dev * pdev, unsigned int cmd, unsigned long arg)
@@ -273,12 +337,13 @@ int do_CMD_APCI1710_CheckAndGetPCISlotNumber(struct pci_dev * pdev, unsigned int
 	/* record the PCI_SLOT for each device from 0 to CONFIG_apci1710_MAX_BOARD_NBR  */
 	{
 		int i;
-		for(i = 0; ( ( i < atomic_read(&apci1710_count) ) || ( i< CONFIG_apci1710_MAX_BOARD_NBR ) ); i++)
+		for(i = 0; i < CONFIG_apci1710_MAX_BOARD_NBR; i++)
 		{
 
 			struct pci_dev * dev =  apci1710_lookup_board_by_index(i);
 
-			if (!dev) break;
+			/* removed board */
+			if (!dev) continue;
 
 			b_SlotArray[i] = PCI_SLOT(dev->devfn);
 
@@ -330,3 +395,27 @@ int do_CMD_APCI1710_SetBoardInformation(struct pci_dev * pdev, unsigned int cmd,
 {
 	return 0;
 }
+//------------------------------------------------------------------------------
+/** Latch and read the initialised modules of all the boards in one call.
+ * The command can be sent to any board, see i_APCI1710_ReadBoardsSnapshot.
+ */
+int do_CMD_APCI1710_ReadBoardsSnapshot(struct pci_dev * pdev, unsigned int cmd, unsigned long arg)
+{
+	/* the snapshot is too large for the kernel stack */
+	str_APCI1710_Snapshot * ps_Snapshot = kmalloc(sizeof(str_APCI1710_Snapshot),GFP_KERNEL);
+
+	if (!ps_Snapshot)
+		return -ENOMEM;
+
+	i_APCI1710_ReadBoardsSnapshot(ps_Snapshot);
+
+	if ( copy_to_user ( (str_APCI1710_Snapshot __user *)arg, ps_Snapshot, sizeof(str_APCI1710_Snapshot)) )
+	{
+		kfree(ps_Snapshot);
+		return -EFAULT;
+	}
+
+	kfree(ps_Snapshot);
+
+	return 0;
+}
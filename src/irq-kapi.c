@@ -46,6 +46,7 @@
 
 #include "apci1710-private.h"
 #include "irq-private-kapi.h"
+#include "counter64-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_SetBoardIntRoutine);
 EXPORT_SYMBOL(i_APCI1710_TestInterrupt);
@@ -79,9 +80,73 @@ int i_APCI1710_ClearUserHandler(struct pci_dev * pdev, uint8_t b_ModulNbr)
 {
 	/* Clear the module interrupt function address */
 	APCI1710_PRIVDATA(pdev)->s_InterruptFunctionality [b_ModulNbr].v_InterruptFunction = NULL;
+	v_APCI1710_UpdateArmedModules(pdev);
 	return 0;
 }
 //------------------------------------------------------------------------------
+/** Recompute the armed modules bitmap of the board.
+ *
+ * A module is armed when an interrupt function is installed for it and
+ * at least one of its interrupt sources is enabled in the software copy
+ * of its registers. The interrupt handler only visits armed modules.
+ * Must be called with the board lock held, after each change of the
+ * interrupt configuration of a module.
+ *
+ * @param [in] pdev              : The device.
+ */
+void v_APCI1710_UpdateArmedModules (struct pci_dev * pdev)
+{
+	uint8_t b_ModuleCpt = 0;
+	uint8_t b_ArmedModules = 0;
+	str_ModuleInfo * ps_ModuleInfo = NULL;
+
+	for (b_ModuleCpt = 0; b_ModuleCpt < NUMBER_OF_MODULE(pdev); b_ModuleCpt ++)
+	{
+		if (APCI1710_PRIVDATA(pdev)->s_InterruptFunctionality [b_ModuleCpt].v_InterruptFunction == NULL)
+			continue;
+
+		ps_ModuleInfo = &APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModuleCpt];
+
+		switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModuleCpt))
+		{
+			case APCI1710_INCREMENTAL_COUNTER:
+				if ((ps_ModuleInfo->s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister2 & APCI1710_ENABLE_LATCH_INT) ||
+				    (ps_ModuleInfo->s_SiemensCounterInfo.s_ModeRegister.s_ByteModeRegister.b_ModeRegister3 & (APCI1710_ENABLE_INDEX_INT | APCI1710_ENABLE_FREQUENCY_INT | APCI1710_ENABLE_COMPARE_INT)))
+					b_ArmedModules |= (1 << b_ModuleCpt);
+				break;
+
+			case APCI1710_PULSE_ENCODER:
+				if ((ps_ModuleInfo->s_PulseEncoderModuleInfo.s_PulseEncoderInfo [0].b_PulseEncoderInit ||
+				     ps_ModuleInfo->s_PulseEncoderModuleInfo.s_PulseEncoderInfo [1].b_PulseEncoderInit ||
+				     ps_ModuleInfo->s_PulseEncoderModuleInfo.s_PulseEncoderInfo [2].b_PulseEncoderInit ||
+				     ps_ModuleInfo->s_PulseEncoderModuleInfo.s_PulseEncoderInfo [3].b_PulseEncoderInit) &&
+				    (ps_ModuleInfo->s_PulseEncoderModuleInfo.dw_SetRegister & ps_ModuleInfo->s_PulseEncoderModuleInfo.dw_ControlRegister & 0xF))
+					b_ArmedModules |= (1 << b_ModuleCpt);
+				break;
+
+			case APCI1710_CHRONOMETER:
+				if (ps_ModuleInfo->s_ChronoModuleInfo.b_InterruptMask != 0)
+					b_ArmedModules |= (1 << b_ModuleCpt);
+				break;
+
+			case APCI1710_ETM:
+				if (((ps_ModuleInfo->s_ETMModuleInfo.s_ETMInfo [0].b_ETMInterrupt == APCI1710_ENABLE) &&
+				     (ps_ModuleInfo->s_ETMModuleInfo.s_ETMInfo [0].b_ETMEnable == APCI1710_ENABLE)) ||
+				    ((ps_ModuleInfo->s_ETMModuleInfo.s_ETMInfo [1].b_ETMInterrupt == APCI1710_ENABLE) &&
+				     (ps_ModuleInfo->s_ETMModuleInfo.s_ETMInfo [1].b_ETMEnable == APCI1710_ENABLE)))
+					b_ArmedModules |= (1 << b_ModuleCpt);
+				break;
+
+			default:
+				/* No software state to test (e.g.: IDV), always visit the module */
+				b_ArmedModules |= (1 << b_ModuleCpt);
+				break;
+		}
+	}
+
+	APCI1710_PRIVDATA(pdev)->b_ArmedModules = b_ArmedModules;
+}
+//------------------------------------------------------------------------------
 /** Disable and reset the interrupt routine.
  *
  * @param [in] pdev              : The device to initialize.
@@ -258,6 +323,8 @@ int   i_APCI1710_SetBoardIntRoutine  (struct pci_dev * pdev, void (*InterruptCal
 
 			APCI1710_PRIVDATA(pdev)->s_InterruptInfos.b_InterruptInitialized = 1;
 
+			v_APCI1710_UpdateArmedModules(pdev);
+
 		return (i_ReturnValue);
 	}
 
@@ -389,6 +456,8 @@ void	v_APCI1710_IncrementalCounter_InterruptFunction (struct pci_dev *pdev,
 			s_InitFlag.
 			b_IndexInterruptOccur = 1;
 
+			v_APCI1710_IndexCounterExtension (pdev, b_Module);
+
 			if (APCI1710_PRIVDATA(pdev)->
 				s_ModuleInfo[b_Module].
 				s_SiemensCounterInfo.
@@ -562,7 +631,7 @@ void	v_APCI1710_ImpulsCounter_InterruptFunction (struct pci_dev *pdev,
 	{
 	uint8_t   b_PulseIncoderCpt;
 	uint32_t ul_StatusRegister;
-	uint32_t ul_Dummy = 0;
+	uint32_t ul_Pending = 0;
 
 	*pb_InterruptFlag = 0;
 
@@ -622,11 +691,17 @@ void	v_APCI1710_ImpulsCounter_InterruptFunction (struct pci_dev *pdev,
 
 		    *pb_InterruptFlag = 1;
 
+		    /************************************/
+		    /* Load the next queued start value */
+		    /************************************/
+
+		    ul_Pending = ul_APCI1710_ReloadPulseEncoder (pdev, b_Module, b_PulseIncoderCpt);
+
 		    /*****************************/
 		    /* User interrupt management */
 		    /*****************************/
 
-		    v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x100UL << b_PulseIncoderCpt, &ul_Dummy);
+		    v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x100UL << b_PulseIncoderCpt, &ul_Pending);
 		    }
 	         }
 	      }
@@ -717,11 +792,18 @@ void	v_APCI1710_Chronos_InterruptFunction (struct pci_dev *pdev,
 
 				*pb_InterruptFlag = 1;
 
-				/*****************************/
-				/* User interrupt management */
-				/*****************************/
+				/********************************************/
+				/* Measurement stream and statistics update */
+				/********************************************/
+
+				if (i_APCI1710_ChronoStreamAdd (pdev, b_Module, ul_LatchRegisterValue))
+				{
+					/*****************************/
+					/* User interrupt management */
+					/*****************************/
 
-				v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x80UL, &ul_LatchRegisterValue);
+					v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x80UL, &ul_LatchRegisterValue);
+				}
 			}
 		}
 		// Begin CG 2249-0505 -> 2250-0705 : Only Interrupt if interrupt was enabled !
@@ -791,11 +873,18 @@ void v_APCI1710_ETM_InterruptFunction	(struct pci_dev *pdev,
 
 		 *pb_InterruptFlag = 1;
 
-		 /*****************************/
-		 /* User interrupt management */
-		 /*****************************/
+		 /**************************************/
+		 /* Capture ring and aggregates update */
+		 /**************************************/
 
-		 v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x20000UL << b_ETMCpt, ul_Value);
+		 if (i_APCI1710_ETMCaptureAdd (pdev, b_Module, b_ETMCpt, ul_Value))
+		    {
+		    /*****************************/
+		    /* User interrupt management */
+		    /*****************************/
+
+		    v_APCI1710_UserInterruptManagement (pdev, b_Module, 0x20000UL << b_ETMCpt, ul_Value);
+		    }
 
 		 } // if (((ul_StatusRegister >> b_EtmCpt) & 1) == 1)
 	      } // for (b_ETMCpt = 0; b_ETMCpt < 2; b_ETMCpt ++)
@@ -1,6 +1,8 @@
 #ifndef APCI1710_INT_PRIVATE_H_
 #define APCI1710_INT_PRIVATE_H_
 
+#include "apci1710-trace.h"
+
 //------------------------------------------------------------------------------
 
 /** Incremental counter interrupt function management.
@@ -147,19 +149,27 @@ static __inline__ void v_APCI1710_UserInterruptManagement (struct pci_dev *pdev,
 		    s_InterruptParameters.
 		    ui_Write + 1) % APCI1710_SAVE_INTERRUPT;
 
-	/**********************/
-	/* Call user function */
-	/**********************/
+	/*******************/
+	/* Trace the event */
+	/*******************/
+
+	trace_apci1710_interrupt_event (pdev, b_Module, ul_InterruptMask, ul_Value[0]);
+
+	/*********************************************/
+	/* Deliver the event to the subscribed files */
+	/*********************************************/
+
+	apci1710_event_dispatch (pdev, b_Module, ul_InterruptMask, ul_Value);
 
-	/* Call the user kernel callback */
-	if (APCI1710_PRIVDATA(pdev)->s_UserInterruptCallback.v_UserInterruptFunction != NULL)
-		(APCI1710_PRIVDATA(pdev)->s_UserInterruptCallback.v_UserInterruptFunction ) (pdev);
+	/*****************************************************************/
+	/* Wake up the files, call user function and send SIGIO, at once */
+	/* or once enough events are pending (see notify-kapi.c)         */
+	/*****************************************************************/
 
-	/* Asynchronous IO signal implementation - send a SIGIO to all registered processes*/
-	if (APCI1710_PRIVDATA(pdev)->async_queue)
-		{
-		kill_fasync( &(APCI1710_PRIVDATA(pdev)->async_queue), SIGIO, POLL_IN);
-		}
+	if (APCI1710_PRIVDATA(pdev)->s_NotifyCoalescing.ul_MaxEvents > 1)
+		v_APCI1710_CoalesceNotification (pdev);
+	else
+		v_APCI1710_Notify (pdev);
 	}
 
 //------------------------------------------------------------------------------
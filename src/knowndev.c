@@ -1,6 +1,6 @@
 /** @file knowndev.c
  *
- * @brief Implements known device linked-list, used for apci1710_lookup_board_by_index
+ * @brief Implements the known device table, used for apci1710_lookup_board_by_index
  *
  * The index given to apci1710_lookup_board_by_index is supposed to be also the minor number
  * of the device. For drivers that manage only one type of board a simple algorithme works
@@ -13,8 +13,17 @@
  * Anyway, when a driver want to manage several types of boards, the order in discover the board,
  * whereas probably still deterministic from one boot to another, is a lot less evident.
  *
- * To handle this case, the simple way is to implements a linked list that will memorize
- * the order of discovery of the boards. It is named "known_boards"
+ * To handle this case, a table memorizes the boards in the order of discovery.
+ * A board keeps its index until it is removed, the index is then free for the next
+ * board found (hotplug).
+ *
+ * The table is written under a spinlock by probe() and remove() only, and read under
+ * RCU: a lookup takes no lock and can be done from any context, interrupts included.
+ * remove() waits for the readers before the board data is released.
+ *
+ * An open file holds a reference on the board data and on its pci_dev, so an index
+ * reused by a new board never leads a file to the data of another board: the files
+ * of a removed board are detached and fail with -ENODEV until they are closed.
  *
  */
 
@@ -31,7 +40,12 @@ EXPORT_NO_SYMBOLS;
 
 
 //------------------------------------------------------------------------------
-static struct pci_dev * known_dev = NULL;
+#ifndef __rcu
+	#define __rcu
+#endif
+
+/** the boards by index, NULL if free. Written under spinlock_known_dev, read under RCU */
+static struct pci_dev __rcu * known_dev[APCI1710_MAX_KNOWN_DEV];
 //------------------------------------------------------------------------------
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,11)
@@ -40,77 +54,130 @@ static struct pci_dev * known_dev = NULL;
 	DEFINE_SPINLOCK(spinlock_known_dev);
 #endif
 
-#define KNOWNDEV_LIST_LOCK(__flag) spin_lock_irqsave(&spinlock_known_dev,__flag);
-#define KNOWNDEV_LIST_UNLOCK(__flag)  spin_unlock_irqrestore(&spinlock_known_dev,__flag);
+/* only taken by probe() and remove(), never by the readers */
+#define KNOWNDEV_LIST_LOCK() spin_lock(&spinlock_known_dev);
+#define KNOWNDEV_LIST_UNLOCK()  spin_unlock(&spinlock_known_dev);
 //------------------------------------------------------------------------------
-/** get tail of the list */
-static __inline__ struct pci_dev * GET_LAST(void)
+/** register a new board at the first free index.
+ *
+ * @return the index of the board (its minor number), -ENOSPC if the table is full.
+ */
+int apci1710_known_dev_append(struct pci_dev * pdev)
 {
-	struct pci_dev * current_dev = known_dev;
-	while(current_dev && APCI1710_PRIVDATA(current_dev)->next)
+	int index = 0;
+
+	KNOWNDEV_LIST_LOCK();
 	{
-		current_dev = APCI1710_PRIVDATA(current_dev)->next;
+		for (index = 0; index < APCI1710_MAX_KNOWN_DEV; index++)
+		{
+			if (!rcu_access_pointer(known_dev[index]))
+			{
+				/* the board data is initialised before it is published */
+				rcu_assign_pointer(known_dev[index], pdev);
+				KNOWNDEV_LIST_UNLOCK();
+				return index;
+			}
+		}
 	}
-	return current_dev;
+	KNOWNDEV_LIST_UNLOCK();
+	return -ENOSPC;
 }
 //------------------------------------------------------------------------------
-void apci1710_known_dev_append(struct pci_dev * pdev)
+/** unregister a board, its index is free for the next board found.
+ *
+ * When this function returns no reader uses the board anymore:
+ * the lookups in progress are over and the open files of the board
+ * are detached, their operations fail with -ENODEV from now on.
+ * The board data itself is freed by the last apci1710_put_board().
+ */
+void apci1710_known_dev_remove(struct pci_dev * pdev)
 {
-	unsigned long irqstate = 0;
-	KNOWNDEV_LIST_LOCK(irqstate);
-	{
-		struct pci_dev * last = GET_LAST();
+	struct apci1710_str_BoardInformations * ps_Board = APCI1710_PRIVDATA(pdev);
+	int index = 0;
 
-		if (!last)
+	KNOWNDEV_LIST_LOCK();
+	{
+		for (index = 0; index < APCI1710_MAX_KNOWN_DEV; index++)
 		{
-			/* no entry yet */
-			known_dev = pdev;
-			APCI1710_PRIVDATA(pdev)->previous = NULL;
-			APCI1710_PRIVDATA(pdev)->next = NULL;
-			KNOWNDEV_LIST_UNLOCK(irqstate);
-			return;
+			if (rcu_access_pointer(known_dev[index]) == pdev)
+				RCU_INIT_POINTER(known_dev[index], NULL);
 		}
+	}
+	KNOWNDEV_LIST_UNLOCK();
 
-		/* append */
-		APCI1710_PRIVDATA(last)->next = pdev;
-		APCI1710_PRIVDATA(pdev)->previous = last;
+	/* wait for the lookups in progress */
+	synchronize_rcu();
+
+	/* the file operations which sleep (event replay) stop at once */
+	ps_Board->b_Removed = 1;
+	wake_up_all(&ps_Board->remove_wait);
+
+	/* wait for the file operations in progress, the next ones see the flag */
+	down_write(&ps_Board->remove_sem);
+	{
+		apci1710_event_detach_all(pdev);
 	}
-	KNOWNDEV_LIST_UNLOCK(irqstate);
+	up_write(&ps_Board->remove_sem);
 }
 //------------------------------------------------------------------------------
-void apci1710_known_dev_remove(struct pci_dev * pdev)
+/** return the data of the board of the given index (minor number) with a reference held, NULL if none.
+ *
+ * Used by open(): the board data and its pci_dev stay valid until
+ * apci1710_put_board(), even if the board is removed meanwhile.
+ */
+struct apci1710_str_BoardInformations * apci1710_get_board_by_index(unsigned int index)
 {
-	unsigned long irqstate = 0;
-	KNOWNDEV_LIST_LOCK(irqstate);
+	struct apci1710_str_BoardInformations * ps_Board = NULL;
+	struct pci_dev * pdev = NULL;
+
+	if (index >= APCI1710_MAX_KNOWN_DEV)
+		return NULL;
+
+	rcu_read_lock();
+	pdev = rcu_dereference(known_dev[index]);
+	if (pdev)
 	{
-		if (APCI1710_PRIVDATA(pdev)->next)
-			APCI1710_PRIVDATA(APCI1710_PRIVDATA(pdev)->next)->previous = APCI1710_PRIVDATA(pdev)->previous;
-		if (APCI1710_PRIVDATA(pdev)->previous)
-			APCI1710_PRIVDATA(APCI1710_PRIVDATA(pdev)->previous)->next = APCI1710_PRIVDATA(pdev)->next;
+		/* remove() drops the probe reference after synchronize_rcu() */
+		ps_Board = APCI1710_PRIVDATA(pdev);
+		kref_get(&ps_Board->kref);
+		pci_dev_get(pdev);
 	}
-	KNOWNDEV_LIST_UNLOCK(irqstate);
+	rcu_read_unlock();
+
+	return ps_Board;
+}
+//------------------------------------------------------------------------------
+/** free the board data once the last reference is dropped */
+static void apci1710_board_free(struct kref * ps_Kref)
+{
+	kfree(container_of(ps_Kref, struct apci1710_str_BoardInformations, kref));
+}
+//------------------------------------------------------------------------------
+/** drop a reference to the board data taken by apci1710_get_board_by_index() or by the probe.
+ *
+ * The pci_dev reference of the file is dropped by the caller.
+ */
+void apci1710_put_board(struct apci1710_str_BoardInformations * ps_Board)
+{
+	kref_put(&ps_Board->kref, apci1710_board_free);
 }
 //------------------------------------------------------------------------------
-/* implementing this becomes quite trivial now */
+/** return the board of the given index (minor number), NULL if none.
+ *
+ * No lock is taken, this function can be called from any context.
+ * The board stays valid as long as the caller is in an RCU read-side section
+ * (rcu_read_lock()) or holds an open file of the board.
+ */
 struct pci_dev * apci1710_lookup_board_by_index(unsigned int index)
 {
-	unsigned long irqstate = 0;
-	KNOWNDEV_LIST_LOCK(irqstate);
-	{
-		struct pci_dev * current_dev = known_dev;
-		int i = 0;
+	struct pci_dev * pdev = NULL;
 
-		while ( current_dev )
-		{
-			if (i == index)
-			{
-				KNOWNDEV_LIST_UNLOCK(irqstate);
-				return current_dev;
-			}
-			i++;
-			current_dev = APCI1710_PRIVDATA(current_dev)->next;
-		}
-	}
-	KNOWNDEV_LIST_UNLOCK(irqstate);
-	return NULL;
+	if (index >= APCI1710_MAX_KNOWN_DEV)
+		return NULL;
+
+	rcu_read_lock();
+	pdev = rcu_dereference(known_dev[index]);
+	rcu_read_unlock();
+
+	return pdev;
 }
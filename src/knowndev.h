@@ -1,7 +1,12 @@
 #ifndef __APCI1710_KNOWNDEV_H__
 #define __APCI1710_KNOWNDEV_H__
 
-void apci1710_known_dev_append(struct pci_dev * pdev);
+/** size of the known device table: highest number of boards managed */
+#define APCI1710_MAX_KNOWN_DEV	64
+
+int apci1710_known_dev_append(struct pci_dev * pdev);
 void apci1710_known_dev_remove(struct pci_dev * pdev);
+struct apci1710_str_BoardInformations * apci1710_get_board_by_index(unsigned int index);
+void apci1710_put_board(struct apci1710_str_BoardInformations * ps_Board);
 
 #endif // __APCI1710_KNOWNDEV_H__
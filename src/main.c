@@ -104,13 +104,30 @@ static struct file_operations apci1710_fops =
 	.open		= apci1710_open_lookup,
 	.release	= apci1710_release_lookup,
 	.fasync		= apci1710_fasync_lookup,
+	.read		= apci1710_read_lookup,
+	.poll		= apci1710_poll_lookup,
+	.mmap		= apci1710_mmap_lookup,
 };
 
 //------------------------------------------------------------------------------
 /** when module is unloaded, stop all board activities (cf interrupt)*/
 static void apci1710_stop_board(struct pci_dev * pdev)
 {
+	i_APCI1710_SetValueCacheSampler (pdev, 0, 0);
+	i_APCI1710_SetEdgeDetectionPeriod (pdev, 0);
+	{
+		static const str_APCI1710_ScanProgram s_Stop; /* no program */
+		i_APCI1710_LoadScanProgram (pdev, &s_Stop);
+	}
+	i_APCI1710_SetCounterExtensionPeriod (pdev, 0);
+	{
+		static const str_APCI1710_PositionCompare s_Stop; /* period 0 */
+		i_APCI1710_SetPositionCompare (pdev, &s_Stop);
+	}
+	apci1710_endat_stream_stop (pdev);
+	i_APCI1710_ClearTimedOutputs (pdev);
 	i_APCI1710_ResetBoardIntRoutine (pdev);
+	i_APCI1710_SetNotificationCoalescing (pdev, 1, 0);
 }
 
 //-------------------------------------------------------------------
@@ -175,7 +192,8 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 	/* allocate a new data structure containing board private data */
 	{
 		struct apci1710_str_BoardInformations * newboard_data = NULL;
-		newboard_data = kmalloc( sizeof( struct apci1710_str_BoardInformations) , GFP_ATOMIC);
+		/* on the node of the board, near its PCIe root port; probe() may sleep */
+		newboard_data = kzalloc_node( sizeof( struct apci1710_str_BoardInformations) , GFP_KERNEL, APCI1710_NODE(dev));
 		if (!newboard_data)
 		{
 			printk(KERN_CRIT "Can't allocate memory for new board %s\n",pci_name(dev));
@@ -185,6 +203,23 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 		pci_set_drvdata(dev,newboard_data);
 
 		apci1710_init_priv_data(newboard_data);
+		newboard_data->pdev = dev;
+		apci1710_edge_detection_init(dev);
+		apci1710_counter_extension_init(dev);
+		apci1710_scan_program_init(dev);
+		apci1710_position_compare_init(dev);
+		apci1710_endat_stream_init(dev);
+		apci1710_notify_coalescing_init(dev);
+		apci1710_timed_output_init(dev);
+		apci1710_affinity_init(dev);
+	}
+
+	/* allocate the latest value cache */
+	if ( apci1710_value_cache_init(dev) )
+	{
+		printk(KERN_CRIT "Can't allocate memory for new board %s\n",pci_name(dev));
+		kfree(APCI1710_PRIVDATA(dev));
+		return -ENOMEM;
 	}
 
 	/* lock BAR IO ports ressources */
@@ -194,6 +229,7 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 		{
 			printk(KERN_ERR "%s: pci_request_regions failed\n",__DRIVER_NAME);
 			/* free all allocated ressources here*/
+			apci1710_value_cache_release(dev);
 			kfree(APCI1710_PRIVDATA(dev));
 			return ret;
 		}
@@ -206,16 +242,28 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 		APCI1710_PRIVDATA(dev)->memBaseAddress3 = ioremap(dev->resource[3].start, pci_resource_len(dev,3));
 	}
 
+	/* register the board, its index in the known devices is its minor number */
 	{
+		int index = apci1710_known_dev_append(dev);
+		if (index < 0)
+		{
+			printk(KERN_ERR "%s: too many boards, %s ignored\n",__DRIVER_NAME, pci_name(dev));
+			if (dev->device == apcie1711_BOARD_DEVICE_ID)
+				iounmap(APCI1710_PRIVDATA(dev)->memBaseAddress3);
+			apci1710_value_cache_release(dev);
+			kfree(APCI1710_PRIVDATA(dev));
+			pci_release_regions(dev);
+			return index;
+		}
+		APCI1710_PRIVDATA(dev)->ui_Index = index;
+
 		/* increase the global board count */
 		atomic_inc(&apci1710_count);
-		printk(KERN_INFO "%s: board %s managed (minor number will be %d)\n",__DRIVER_NAME, pci_name(dev), atomic_read(&apci1710_count)-1);
+		printk(KERN_INFO "%s: board %s managed (minor number will be %d)\n",__DRIVER_NAME, pci_name(dev), index);
 	}
 
 	/* create /proc entry */
-	apci1710_proc_create_device(dev, atomic_read(&apci1710_count)-1);
-
-	apci1710_known_dev_append(dev);
+	apci1710_proc_create_device(dev, APCI1710_PRIVDATA(dev)->ui_Index);
 
     /* Read the board configuration */
 	i_APCI1710_ReadModulesConfiguration(dev);
@@ -227,6 +275,7 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 	 	/* failed, clean previously allocated resources */
 		if (dev->device == apcie1711_BOARD_DEVICE_ID)
 			iounmap(APCI1710_PRIVDATA(dev)->memBaseAddress3);
+		apci1710_value_cache_release(dev);
 	 	kfree(APCI1710_PRIVDATA(dev));
 	 	pci_release_regions(dev);
 	 }
@@ -240,7 +289,7 @@ static int __devinit apci1710_probe_one(struct pci_dev *dev, const struct pci_de
 			struct device *cdev;
 		#endif
 
-		int minor = (atomic_read(&apci1710_count)-1);
+		int minor = APCI1710_PRIVDATA(dev)->ui_Index;
 
 		/* don't execute if class not exists */
 		if (IS_ERR(apci1710_class))
@@ -330,10 +379,17 @@ static int __init apci1710_init(void)
 /** event: a card is removed (also called when module is unloaded) */
 static void __devexit apci1710_remove_one(struct pci_dev *dev)
 {
+	/* minor number, the private data is freed below */
+	int index = APCI1710_PRIVDATA(dev)->ui_Index;
+
+	/* first, so that the lookups and file operations in progress are over before anything is released */
+	apci1710_known_dev_remove(dev);
+
 	/* stop board activities */
 	apci1710_stop_board(dev);
 
 	/* register interrupt */
+	apci1710_affinity_release(dev);
 	apci1710_deregister_interrupt(dev);
 
 	/* deallocate BAR IO Ports ressources */
@@ -346,11 +402,14 @@ static void __devexit apci1710_remove_one(struct pci_dev *dev)
 	if (dev->device == apcie1711_BOARD_DEVICE_ID)
 		iounmap(APCI1710_PRIVDATA(dev)->memBaseAddress3);
 
-	apci1710_known_dev_remove(dev);
-
 	/* free private device data*/
 	if (APCI1710_PRIVDATA(dev))
-		kfree(APCI1710_PRIVDATA(dev));
+	{
+		apci1710_value_cache_release(dev);
+		apci1710_endat_stream_release(dev);
+		/* the open files of the board may still hold it */
+		apci1710_put_board(APCI1710_PRIVDATA(dev));
+	}
 
 	/* delete associated /proc entry */
 	apci1710_proc_release_device(dev);
@@ -358,7 +417,7 @@ static void __devexit apci1710_remove_one(struct pci_dev *dev)
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2,6,0)
 	while(1)
 	{
-		int minor = (atomic_read(&apci1710_count)-1);
+		int minor = index;
 
         /* don't execute if class not exists */
         if(IS_ERR(apci1710_class))
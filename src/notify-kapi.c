@@ -0,0 +1,184 @@
+/** @file notify-kapi.c
+ 
+   Coalescing of the event notifications (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_SetNotificationCoalescing);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Notify the events recorded since the last notification.
+ *
+ * The board lock is held. Wakes up the subscribed files that received an
+ * event, calls the user kernel callback and sends SIGIO to the
+ * asynchronous readers.
+ */
+void v_APCI1710_Notify (struct pci_dev *pdev)
+	{
+	/* Wake up the subscribed files */
+	apci1710_event_wake_up (pdev);
+
+	/* Call the user kernel callback */
+	if (APCI1710_PRIVDATA(pdev)->s_UserInterruptCallback.v_UserInterruptFunction != NULL)
+		(APCI1710_PRIVDATA(pdev)->s_UserInterruptCallback.v_UserInterruptFunction ) (pdev);
+
+	/* Asynchronous IO signal implementation - send a SIGIO to all registered processes*/
+	if (APCI1710_PRIVDATA(pdev)->async_queue)
+		kill_fasync( &(APCI1710_PRIVDATA(pdev)->async_queue), SIGIO, POLL_IN);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Count an event and notify once enough events are pending.
+ *
+ * The board lock is held. The first pending event starts the delay timer,
+ * the N-th one notifies at once.
+ */
+void v_APCI1710_CoalesceNotification (struct pci_dev *pdev)
+	{
+	str_NotifyCoalescingInfos * ps_Coalescing = &(APCI1710_PRIVDATA(pdev)->s_NotifyCoalescing);
+
+	ps_Coalescing->ul_Pending++;
+
+	if (ps_Coalescing->ul_Pending >= ps_Coalescing->ul_MaxEvents)
+		{
+		/* A callback already running finds no pending event */
+		hrtimer_try_to_cancel (&ps_Coalescing->s_Timer);
+		ps_Coalescing->ul_Pending = 0;
+		v_APCI1710_Notify (pdev);
+		}
+	else if (ps_Coalescing->ul_Pending == 1)
+		hrtimer_start (&ps_Coalescing->s_Timer, ps_Coalescing->kt_Delay, HRTIMER_MODE_REL);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Notification delay elapsed, hrtimer callback. */
+static enum hrtimer_restart v_APCI1710_NotifyTimer (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_NotifyCoalescing.s_Timer);
+	struct pci_dev * pdev = ps_Board->pdev;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			if (ps_Board->s_NotifyCoalescing.ul_Pending != 0)
+				{
+				ps_Board->s_NotifyCoalescing.ul_Pending = 0;
+				v_APCI1710_Notify (pdev);
+				}
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return HRTIMER_NORESTART;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the notification coalescing of a new board (each event is notified). */
+void apci1710_notify_coalescing_init (struct pci_dev *pdev)
+	{
+	str_NotifyCoalescingInfos * ps_Coalescing = &(APCI1710_PRIVDATA(pdev)->s_NotifyCoalescing);
+
+	hrtimer_init (&ps_Coalescing->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ps_Coalescing->s_Timer.function = v_APCI1710_NotifyTimer;
+	ps_Coalescing->ul_MaxEvents = 1;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Set the coalescing of the event notifications.
+ *
+ * See CMD_APCI1710_SetNotificationCoalescing.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running timer callback.
+ *
+ * @param [in] pdev                : The device to use.
+ * @param [in] ul_MaxEvents        : Notify once ul_MaxEvents events are pending
+ *                                   (0 or 1: notify each event, max APCI1710_NOTIFY_MAX_EVENTS).
+ * @param [in] ul_Delay            : Or once ul_Delay us have passed since the first pending event
+ *                                   (APCI1710_NOTIFY_MIN_DELAY to APCI1710_NOTIFY_MAX_DELAY),
+ *                                   not used if each event is notified.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The delay is wrong.
+ */
+int i_APCI1710_SetNotificationCoalescing (struct pci_dev *pdev, uint32_t ul_MaxEvents, uint32_t ul_Delay)
+	{
+	str_NotifyCoalescingInfos * ps_Coalescing = NULL;
+
+	if (!pdev) return 1;
+
+	ps_Coalescing = &(APCI1710_PRIVDATA(pdev)->s_NotifyCoalescing);
+
+	if (ul_MaxEvents > APCI1710_NOTIFY_MAX_EVENTS)
+		return 2;
+
+	if ((ul_MaxEvents > 1) && ((ul_Delay < APCI1710_NOTIFY_MIN_DELAY) || (ul_Delay > APCI1710_NOTIFY_MAX_DELAY)))
+		return 3;
+
+	hrtimer_cancel (&ps_Coalescing->s_Timer);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ps_Coalescing->ul_MaxEvents = (ul_MaxEvents > 1) ? ul_MaxEvents : 1;
+			ps_Coalescing->kt_Delay     = ns_to_ktime ((uint64_t) ul_Delay * NSEC_PER_USEC);
+
+			/* The events pending under the previous setting are notified now */
+			if (ps_Coalescing->ul_Pending != 0)
+				{
+				ps_Coalescing->ul_Pending = 0;
+				v_APCI1710_Notify (pdev);
+				}
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+/** @file notify.c
+ 
+   Coalescing of the event notifications (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Set the coalescing of the event notifications.
+ *
+ * The board is locked by i_APCI1710_SetNotificationCoalescing itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg[0] (ul_MaxEvents)    : Notify once ul_MaxEvents events are pending (0 or 1: each event).
+ * @param [in] arg[1] (ul_Delay)        : Or once ul_Delay us have passed since the first pending event.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The delay is wrong.
+ * @retval -EFAULT : Fail to retrieve user data.
+ */
+int do_CMD_APCI1710_SetNotificationCoalescing (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	uint32_t dw_ArgArray[2];
+
+	if ( copy_from_user(dw_ArgArray, (uint32_t __user *)arg, sizeof(dw_ArgArray) ) )
+		return -EFAULT;
+
+	return i_APCI1710_SetNotificationCoalescing (pdev,
+	                                             dw_ArgArray[0],  // ul_MaxEvents
+	                                             dw_ArgArray[1]); // ul_Delay
+}
+
+//------------------------------------------------------------------------------
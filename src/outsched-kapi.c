@@ -0,0 +1,309 @@
+/** @file outsched-kapi.c
+ 
+   Timed output scheduler (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_QueueTimedOutputs);
+EXPORT_SYMBOL(i_APCI1710_ReadTimedOutputReports);
+EXPORT_SYMBOL(i_APCI1710_ClearTimedOutputs);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Write one timed output.
+ *
+ * The board lock is held.
+ *
+ * @return The error code of the output function, 0 if no error.
+ */
+static int i_APCI1710_WriteTimedOutput (struct pci_dev *pdev,
+                                        const str_APCI1710_TimedOutput * ps_Output)
+	{
+	uint8_t b_ModulNbr = ps_Output->b_ModulNbr;
+
+	switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+		{
+		case APCI1710_DIGITAL_IO:
+			return ps_Output->b_On ? i_APCI1710_SetDigitalIOChlOn (pdev, b_ModulNbr, ps_Output->b_Channel) :
+			                         i_APCI1710_SetDigitalIOChlOff (pdev, b_ModulNbr, ps_Output->b_Channel);
+
+		case APCI1710_TTL_IO:
+			return ps_Output->b_On ? i_APCI1710_SetTTLIOChlOn (pdev, b_ModulNbr, ps_Output->b_Channel) :
+			                         i_APCI1710_SetTTLIOChlOff (pdev, b_ModulNbr, ps_Output->b_Channel);
+
+		case APCI1710_PULSE_ENCODER:
+			return ps_Output->b_On ? i_APCI1710_PulseEncoderSetDigitalOutputOn (pdev, b_ModulNbr) :
+			                         i_APCI1710_PulseEncoderSetDigitalOutputOff (pdev, b_ModulNbr);
+
+		case APCI1710_INCREMENTAL_COUNTER:
+			return ps_Output->b_On ? i_APCI1710_SetDigitalChlOn (pdev, b_ModulNbr) :
+			                         i_APCI1710_SetDigitalChlOff (pdev, b_ModulNbr);
+
+		default:
+			return 3;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Arm the timer on the first pending output.
+ *
+ * The board lock is held, it serialises the timer starts of the
+ * callback and of i_APCI1710_QueueTimedOutputs.
+ */
+static void v_APCI1710_ArmTimedOutputs (str_TimedOutputInfos * ps_Timed)
+	{
+	if (ps_Timed->ul_Pending != 0)
+		hrtimer_start (&ps_Timed->s_Timer, ns_to_ktime (ps_Timed->s_Schedule [0].ull_Time), HRTIMER_MODE_ABS);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Timed output scheduler, hrtimer callback.
+ *
+ * Writes every output whose time is reached, logs its execution time and
+ * arms the timer on the next output.
+ */
+static enum hrtimer_restart v_APCI1710_TimedOutputCallback (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_TimedOutput.s_Timer);
+	str_TimedOutputInfos * ps_Timed = &ps_Board->s_TimedOutput;
+	struct pci_dev * pdev = ps_Board->pdev;
+	uint32_t ul_Done = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			while ((ul_Done < ps_Timed->ul_Pending) &&
+			       (ps_Timed->s_Schedule [ul_Done].ull_Time <= APCI1710_TIMESTAMP()))
+				{
+				const str_APCI1710_TimedOutput * ps_Output = &ps_Timed->s_Schedule [ul_Done];
+				int i_ReturnValue = i_APCI1710_WriteTimedOutput (pdev, ps_Output);
+				uint64_t ull_ExecutionTime = APCI1710_TIMESTAMP();
+
+				if ((ps_Timed->ul_Write - ps_Timed->ul_Read) < APCI1710_TIMED_OUTPUT_REPORT_SIZE)
+					{
+					str_APCI1710_TimedOutputReport * ps_Report = &ps_Timed->s_Report [ps_Timed->ul_Write % APCI1710_TIMED_OUTPUT_REPORT_SIZE];
+
+					ps_Report->ull_Time          = ps_Output->ull_Time;
+					ps_Report->ull_ExecutionTime = ull_ExecutionTime;
+					ps_Report->ul_Tag            = ps_Output->ul_Tag;
+					ps_Report->i_Error           = i_ReturnValue;
+					ps_Timed->ul_Write++;
+					}
+				else
+					ps_Timed->ul_Lost++;
+
+				ul_Done++;
+				}
+
+			/* Remove the executed outputs */
+			if (ul_Done != 0)
+				{
+				ps_Timed->ul_Pending -= ul_Done;
+				memmove (&ps_Timed->s_Schedule [0],
+				         &ps_Timed->s_Schedule [ul_Done],
+				         ps_Timed->ul_Pending * sizeof (str_APCI1710_TimedOutput));
+				}
+
+			v_APCI1710_ArmTimedOutputs (ps_Timed);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return HRTIMER_NORESTART;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the timed output scheduler of a new board. */
+void apci1710_timed_output_init (struct pci_dev *pdev)
+	{
+	str_TimedOutputInfos * ps_Timed = &(APCI1710_PRIVDATA(pdev)->s_TimedOutput);
+
+	hrtimer_init (&ps_Timed->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+	ps_Timed->s_Timer.function = v_APCI1710_TimedOutputCallback;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Queue output changes at absolute times.
+ *
+ * See CMD_APCI1710_QueueTimedOutputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Outputs            : The outputs.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of outputs is wrong.
+ * @retval 3: An output module is wrong or has no output.
+ * @retval 4: Not enough room in the schedule.
+ */
+int i_APCI1710_QueueTimedOutputs (struct pci_dev *pdev,
+                                  const str_APCI1710_TimedOutputs * ps_Outputs)
+	{
+	str_TimedOutputInfos * ps_Timed = NULL;
+	uint32_t ul_Output = 0;
+
+	if (!pdev || !ps_Outputs) return 1;
+
+	if ((ps_Outputs->ul_NumberOfOutputs == 0) ||
+	    (ps_Outputs->ul_NumberOfOutputs > APCI1710_TIMED_OUTPUT_MAX_QUEUE))
+		return 2;
+
+	for (ul_Output = 0; ul_Output < ps_Outputs->ul_NumberOfOutputs; ul_Output++)
+		{
+		uint8_t b_ModulNbr = ps_Outputs->s_Output [ul_Output].b_ModulNbr;
+
+		if (b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+			return 3;
+
+		switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+			{
+			case APCI1710_DIGITAL_IO:
+			case APCI1710_TTL_IO:
+			case APCI1710_PULSE_ENCODER:
+			case APCI1710_INCREMENTAL_COUNTER:
+				break;
+
+			default:
+				return 3;
+			}
+		}
+
+	ps_Timed = &(APCI1710_PRIVDATA(pdev)->s_TimedOutput);
+
+	if (ps_Timed->ul_Pending + ps_Outputs->ul_NumberOfOutputs > APCI1710_TIMED_OUTPUT_SCHEDULE_SIZE)
+		return 4;
+
+	/* Insert in time order, after the outputs with the same time */
+	for (ul_Output = 0; ul_Output < ps_Outputs->ul_NumberOfOutputs; ul_Output++)
+		{
+		const str_APCI1710_TimedOutput * ps_Output = &ps_Outputs->s_Output [ul_Output];
+		uint32_t ul_Index = ps_Timed->ul_Pending;
+
+		while ((ul_Index > 0) && (ps_Timed->s_Schedule [ul_Index - 1].ull_Time > ps_Output->ull_Time))
+			{
+			ps_Timed->s_Schedule [ul_Index] = ps_Timed->s_Schedule [ul_Index - 1];
+			ul_Index--;
+			}
+
+		ps_Timed->s_Schedule [ul_Index] = *ps_Output;
+		ps_Timed->ul_Pending++;
+		}
+
+	v_APCI1710_ArmTimedOutputs (ps_Timed);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the execution reports of the timed outputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Reports           : The reports, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadTimedOutputReports (struct pci_dev *pdev,
+                                       str_APCI1710_TimedOutputReports * ps_Reports)
+	{
+	str_TimedOutputInfos * ps_Timed = NULL;
+	uint32_t ul_Count = 0;
+
+	if (!pdev || !ps_Reports) return 1;
+
+	ps_Timed = &(APCI1710_PRIVDATA(pdev)->s_TimedOutput);
+
+	while ((ps_Timed->ul_Read != ps_Timed->ul_Write) && (ul_Count < APCI1710_TIMED_OUTPUT_REPORT_SIZE))
+		{
+		ps_Reports->s_Report [ul_Count++] = ps_Timed->s_Report [ps_Timed->ul_Read % APCI1710_TIMED_OUTPUT_REPORT_SIZE];
+		ps_Timed->ul_Read++;
+		}
+
+	ps_Reports->ul_NumberOfReports = ul_Count;
+	ps_Reports->ul_LostReports     = ps_Timed->ul_Lost;
+	ps_Reports->ul_Pending         = ps_Timed->ul_Pending;
+
+	ps_Timed->ul_Lost = 0;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Remove all the pending timed outputs.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running callback.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ClearTimedOutputs (struct pci_dev *pdev)
+	{
+	str_TimedOutputInfos * ps_Timed = NULL;
+
+	if (!pdev) return 1;
+
+	ps_Timed = &(APCI1710_PRIVDATA(pdev)->s_TimedOutput);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ps_Timed->ul_Pending = 0;
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	/* A running callback finds no output and does not rearm */
+	hrtimer_cancel (&ps_Timed->s_Timer);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
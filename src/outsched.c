@@ -0,0 +1,146 @@
+/** @file outsched.c
+ 
+   Timed output scheduler (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Queue output changes at absolute times.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_TimedOutputs) : The outputs.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of outputs is wrong.
+ * @retval 3: An output module is wrong or has no output.
+ * @retval 4: Not enough room in the schedule.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_QueueTimedOutputs (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_TimedOutputs * ps_Outputs = kmalloc (sizeof (str_APCI1710_TimedOutputs), GFP_KERNEL);
+
+	if (!ps_Outputs)
+		return -ENOMEM;
+
+	if ( copy_from_user(ps_Outputs, (str_APCI1710_TimedOutputs __user *)arg, sizeof(str_APCI1710_TimedOutputs) ) )
+	{
+		kfree (ps_Outputs);
+		return -EFAULT;
+	}
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_QueueTimedOutputs (pdev, ps_Outputs);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	kfree (ps_Outputs);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the execution reports of the timed outputs.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_TimedOutputReports) : The reports.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadTimedOutputReports (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_TimedOutputReports * ps_Reports = kmalloc (sizeof (str_APCI1710_TimedOutputReports), GFP_KERNEL);
+
+	if (!ps_Reports)
+		return -ENOMEM;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_APCI1710_ReadTimedOutputReports (pdev, ps_Reports);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if ( copy_to_user( (str_APCI1710_TimedOutputReports __user *)arg, ps_Reports, sizeof(str_APCI1710_TimedOutputReports) ) )
+	{
+		kfree (ps_Reports);
+		return -EFAULT;
+	}
+
+	kfree (ps_Reports);
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+
+/** Remove all the pending timed outputs.
+ *
+ * The board is locked by i_APCI1710_ClearTimedOutputs itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int do_CMD_APCI1710_ClearTimedOutputs (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	return i_APCI1710_ClearTimedOutputs (pdev);
+}
+
+//------------------------------------------------------------------------------
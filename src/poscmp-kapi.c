@@ -0,0 +1,498 @@
+/** @file poscmp-kapi.c
+ 
+   Software position compare of SSI, BiSS and EnDat axes (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include "irq-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_SetPositionCompare);
+EXPORT_SYMBOL(i_APCI1710_ReadPositionTriggers);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Read the position of the compared axis.
+ *
+ * Called by the sampling thread without the board lock; the SSI read takes
+ * it, the BiSS and EnDat functions use their own lock like their ioctls.
+ * An EnDat read waits for the EnDat function using the channel and fails
+ * with -EBUSY if a position stream was started on it meanwhile.
+ * The SSI conversion is not waited for: each period reads the conversion
+ * started at the previous one and starts the next, the position is
+ * stamped with the start of its conversion.
+ *
+ * @param [in,out] pull_TimeStamp : Time of the sample, set by the caller.
+ *
+ * @return The error code of the kernel function called, 0 if no error,
+ *         -EAGAIN if the SSI conversion is not complete yet.
+ */
+static int i_APCI1710_ReadComparedPosition (struct pci_dev *pdev,
+                                            str_PositionCompareInfos * ps_Compare,
+                                            uint64_t * pull_Position,
+                                            uint64_t * pull_TimeStamp)
+	{
+	const str_APCI1710_PositionCompare * ps_Config = &ps_Compare->s_Config;
+	uint32_t ul_Low = 0;
+	uint32_t ul_High = 0;
+	int i_ReturnValue = 0;
+
+	switch (ps_Config->b_AxisType)
+		{
+		case APCI1710_COMPARE_AXIS_SSI:
+			{
+			uint32_t ul_Position[3] = {0, 0, 0};
+			uint32_t ul_TurnCpt[3] = {0, 0, 0};
+			unsigned long irqstate;
+
+			APCI1710_LOCK(pdev,&irqstate);
+			{
+				if (ps_Compare->b_SSIStarted)
+					i_ReturnValue = apci1710_ssi_read_conversion (pdev, ps_Config->b_ModulNbr, ul_Position, ul_TurnCpt);
+				else
+					i_ReturnValue = -EAGAIN;
+
+				/* Still running: retried at the next period */
+				if (i_ReturnValue == 1)
+					i_ReturnValue = -EAGAIN;
+				else if ((i_ReturnValue == 0) || (i_ReturnValue == -EAGAIN))
+					{
+					*pull_TimeStamp = ps_Compare->ull_SSIStartTime;
+
+					apci1710_ssi_start_conversion (pdev, ps_Config->b_ModulNbr);
+					ps_Compare->ull_SSIStartTime = APCI1710_TIMESTAMP();
+					ps_Compare->b_SSIStarted = 1;
+					}
+			}
+			APCI1710_UNLOCK(pdev, irqstate);
+
+			ul_Low = ul_Position [ps_Config->b_Channel];
+			}
+			break;
+
+		case APCI1710_COMPARE_AXIS_BISS:
+			i_ReturnValue = i_APCI1711_BissMasterSingleCycleDataRead (pdev, ps_Config->b_ModulNbr, ps_Config->b_Channel, &ul_Low, &ul_High);
+			break;
+
+		case APCI1710_COMPARE_AXIS_ENDAT:
+			{
+			uint32_t ul_Size = 0;
+
+			i_ReturnValue = i_APCI1711_EndatSensorSendPositionValue (pdev, ps_Config->b_ModulNbr, ps_Config->b_Channel, &ul_Low, &ul_High, &ul_Size);
+			}
+			break;
+		}
+
+	*pull_Position = ((uint64_t) ul_High << 32) | ul_Low;
+
+	return i_ReturnValue;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Set the output of a window.
+ *
+ * The board lock is held.
+ */
+static int i_APCI1710_SetWindowOutput (struct pci_dev *pdev,
+                                       const str_APCI1710_PositionWindow * ps_Window,
+                                       int i_On)
+	{
+	uint8_t b_ModulNbr = ps_Window->b_OutputModule;
+
+	switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+		{
+		case APCI1710_INCREMENTAL_COUNTER:
+			return i_On ? i_APCI1710_SetDigitalChlOn (pdev, b_ModulNbr) :
+			              i_APCI1710_SetDigitalChlOff (pdev, b_ModulNbr);
+
+		case APCI1710_DIGITAL_IO:
+			return i_On ? i_APCI1710_SetDigitalIOChlOn (pdev, b_ModulNbr, ps_Window->b_OutputChannel) :
+			              i_APCI1710_SetDigitalIOChlOff (pdev, b_ModulNbr, ps_Window->b_OutputChannel);
+
+		case APCI1710_TTL_IO:
+			return i_On ? i_APCI1710_SetTTLIOChlOn (pdev, b_ModulNbr, ps_Window->b_OutputChannel) :
+			              i_APCI1710_SetTTLIOChlOff (pdev, b_ModulNbr, ps_Window->b_OutputChannel);
+
+		default:
+			return 3;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Compare a sampled position with the windows.
+ *
+ * The board lock is held. The outputs of the windows the position entered
+ * or left are updated, the transitions are logged and delivered as events.
+ */
+static void v_APCI1710_ComparePosition (struct pci_dev *pdev,
+                                        str_PositionCompareInfos * ps_Compare,
+                                        uint64_t ull_Position,
+                                        uint64_t ull_TimeStamp)
+	{
+	const str_APCI1710_PositionCompare * ps_Config = &ps_Compare->s_Config;
+	uint32_t ul_InsideMask = 0;
+	uint32_t ul_Changed = 0;
+	uint32_t ul_Window = 0;
+	int i_ReturnValue = 0;
+
+	for (ul_Window = 0; ul_Window < ps_Config->ul_NumberOfWindows; ul_Window++)
+		if ((ull_Position >= ps_Config->s_Window [ul_Window].ull_Low) &&
+		    (ull_Position <= ps_Config->s_Window [ul_Window].ull_High))
+			ul_InsideMask |= (1 << ul_Window);
+
+	/* The first sample sets all the outputs */
+	if (ps_Compare->b_Valid)
+		ul_Changed = ul_InsideMask ^ ps_Compare->ul_InsideMask;
+	else
+		ul_Changed = (1 << ps_Config->ul_NumberOfWindows) - 1;
+
+	for (ul_Window = 0; ul_Window < ps_Config->ul_NumberOfWindows; ul_Window++)
+		{
+		const str_APCI1710_PositionWindow * ps_Window = &ps_Config->s_Window [ul_Window];
+		int i_Inside = (ul_InsideMask >> ul_Window) & 1;
+		uint32_t ul_Value = 0;
+
+		if ((ul_Changed & (1 << ul_Window)) == 0)
+			continue;
+
+		i_ReturnValue = i_APCI1710_SetWindowOutput (pdev, ps_Window, i_Inside ^ (ps_Window->b_Inverted != 0));
+		if (i_ReturnValue != 0)
+			{
+			ps_Compare->i_LastError = i_ReturnValue;
+			ps_Compare->ul_Errors++;
+			}
+
+		/* The initial state is not a trigger */
+		if (!ps_Compare->b_Valid)
+			continue;
+
+		if ((ps_Compare->ul_Write - ps_Compare->ul_Read) < APCI1710_POSITION_TRIGGER_LOG_SIZE)
+			{
+			str_APCI1710_PositionTrigger * ps_Trigger = &ps_Compare->s_Trigger [ps_Compare->ul_Write % APCI1710_POSITION_TRIGGER_LOG_SIZE];
+
+			ps_Trigger->ull_TimeStamp = ull_TimeStamp;
+			ps_Trigger->ull_Position  = ull_Position;
+			ps_Trigger->ul_Window     = ul_Window;
+			ps_Trigger->ul_Entered    = i_Inside;
+			ps_Compare->ul_Write++;
+			}
+		else
+			ps_Compare->ul_Lost++;
+
+		ul_Value = ul_Window | (i_Inside ? 0x80000000UL : 0);
+		v_APCI1710_UserInterruptManagement (pdev, ps_Config->b_ModulNbr, APCI1710_POSITION_COMPARE_INTERRUPT, &ul_Value);
+		}
+
+	ps_Compare->ul_InsideMask = ul_InsideMask;
+	ps_Compare->b_Valid       = 1;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Position compare sampling thread.
+ *
+ * The BiSS and EnDat transfers wait for the sensor, so the axis is sampled
+ * by a kernel thread rather than by a timer callback. The thread wakes up
+ * on an absolute deadline every period.
+ */
+static int i_APCI1710_PositionCompareThread (void * pv_Data)
+	{
+	struct pci_dev * pdev = (struct pci_dev *) pv_Data;
+	str_PositionCompareInfos * ps_Compare = &(APCI1710_PRIVDATA(pdev)->s_PositionCompare);
+	ktime_t kt_Period = ns_to_ktime ((uint64_t) ps_Compare->s_Config.ul_Period * NSEC_PER_USEC);
+	ktime_t kt_Next = ktime_get ();
+
+	while (!kthread_should_stop ())
+		{
+		uint64_t ull_Position = 0;
+		uint64_t ull_TimeStamp = APCI1710_TIMESTAMP();
+		int i_ReturnValue = i_APCI1710_ReadComparedPosition (pdev, ps_Compare, &ull_Position, &ull_TimeStamp);
+
+		{
+			unsigned long irqstate;
+			APCI1710_LOCK(pdev,&irqstate);
+			{
+				if (i_ReturnValue == -EAGAIN)
+					; /* No position this period */
+				else if (i_ReturnValue == 0)
+					{
+					ps_Compare->ull_Samples++;
+					ps_Compare->ull_Position = ull_Position;
+					v_APCI1710_ComparePosition (pdev, ps_Compare, ull_Position, ull_TimeStamp);
+					}
+				else
+					{
+					ps_Compare->i_LastError = i_ReturnValue;
+					ps_Compare->ul_Errors++;
+					}
+			}
+			APCI1710_UNLOCK(pdev, irqstate);
+		}
+
+		/* Next deadline, skip the periods already missed */
+		kt_Next = ktime_add (kt_Next, kt_Period);
+		if (ktime_before (kt_Next, ktime_get ()))
+			kt_Next = ktime_add (ktime_get (), kt_Period);
+
+		set_current_state (TASK_INTERRUPTIBLE);
+		if (!kthread_should_stop ())
+			schedule_hrtimeout (&kt_Next, HRTIMER_MODE_ABS);
+		__set_current_state (TASK_RUNNING);
+		}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the position compare of a new board. */
+void apci1710_position_compare_init (struct pci_dev *pdev)
+	{
+	mutex_init (&(APCI1710_PRIVDATA(pdev)->s_PositionCompare.s_Mutex));
+	}
+
+//------------------------------------------------------------------------------
+
+/** Move the sampling thread on the worker CPUs after an affinity change. */
+void apci1710_position_compare_bind (struct pci_dev *pdev)
+	{
+	str_PositionCompareInfos * ps_Compare = &(APCI1710_PRIVDATA(pdev)->s_PositionCompare);
+
+	mutex_lock (&ps_Compare->s_Mutex);
+	if (ps_Compare->ps_Thread)
+		apci1710_worker_bind (pdev, ps_Compare->ps_Thread);
+	mutex_unlock (&ps_Compare->s_Mutex);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Check the axis of a position compare configuration.
+ *
+ * @retval 0: No error.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 8: The EnDat channel runs its position stream.
+ */
+static int i_APCI1710_CheckComparedAxis (struct pci_dev *pdev,
+                                         const str_APCI1710_PositionCompare * ps_Config)
+	{
+	uint8_t b_ModulNbr = ps_Config->b_ModulNbr;
+
+	if (b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+		return 3;
+
+	switch (ps_Config->b_AxisType)
+		{
+		case APCI1710_COMPARE_AXIS_SSI:
+			if ((APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_SSI_COUNTER) || (ps_Config->b_Channel > 2))
+				return 3;
+			if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_SSICounterInfo.b_SSIInit != 1)
+				return 4;
+			return 0;
+
+		case APCI1710_COMPARE_AXIS_BISS:
+			if (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_BISS_MASTER)
+				return 3;
+			if ((APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_BissModuleInfo.singleCycleInitStatus == 0) ||
+			    (ps_Config->b_Channel >= APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_BissModuleInfo.initialisedSlaveCount))
+				return 4;
+			return 0;
+
+		case APCI1710_COMPARE_AXIS_ENDAT:
+			/* The sensor initialisation is tested by each read */
+			if ((APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != PCIE1711_ENDAT) || (ps_Config->b_Channel > 1))
+				return 3;
+			/* The stream owns the channel, each read would fail with -EBUSY */
+			if (apci1710_endat_stream_running (pdev, b_ModulNbr, ps_Config->b_Channel))
+				return 8;
+			return 0;
+
+		default:
+			return 3;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Configure the software position compare of an absolute encoder axis.
+ *
+ * See CMD_APCI1710_SetPositionCompare.
+ *
+ * @warning This function sleeps, it must be called without the board lock.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Config             : The configuration, a period of 0 stops the compare.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 5: The number of windows is wrong.
+ * @retval 6: A window is wrong (limits or output module).
+ * @retval 7: The sampling thread can not be started.
+ * @retval 8: The EnDat channel runs its position stream.
+ */
+int i_APCI1710_SetPositionCompare (struct pci_dev *pdev,
+                                   const str_APCI1710_PositionCompare * ps_Config)
+	{
+	str_PositionCompareInfos * ps_Compare = NULL;
+	uint32_t ul_Window = 0;
+	int i_ReturnValue = 0;
+
+	if (!pdev || !ps_Config) return 1;
+
+	ps_Compare = &(APCI1710_PRIVDATA(pdev)->s_PositionCompare);
+
+	if (ps_Config->ul_Period != 0)
+		{
+		if (ps_Config->ul_Period < APCI1710_POSITION_COMPARE_MIN_PERIOD)
+			return 2;
+
+		i_ReturnValue = i_APCI1710_CheckComparedAxis (pdev, ps_Config);
+		if (i_ReturnValue != 0)
+			return i_ReturnValue;
+
+		if ((ps_Config->ul_NumberOfWindows == 0) ||
+		    (ps_Config->ul_NumberOfWindows > APCI1710_POSITION_COMPARE_MAX_WINDOWS))
+			return 5;
+
+		for (ul_Window = 0; ul_Window < ps_Config->ul_NumberOfWindows; ul_Window++)
+			{
+			const str_APCI1710_PositionWindow * ps_Window = &ps_Config->s_Window [ul_Window];
+
+			if (ps_Window->ull_Low > ps_Window->ull_High)
+				return 6;
+
+			if (ps_Window->b_OutputModule >= NUMBER_OF_MODULE(pdev))
+				return 6;
+
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,ps_Window->b_OutputModule))
+				{
+				case APCI1710_INCREMENTAL_COUNTER:
+				case APCI1710_DIGITAL_IO:
+				case APCI1710_TTL_IO:
+					break;
+
+				default:
+					return 6;
+				}
+			}
+		}
+
+	mutex_lock (&ps_Compare->s_Mutex);
+
+	/* Stop the running thread, the configuration is then free to change */
+	if (ps_Compare->ps_Thread)
+		{
+		kthread_stop (ps_Compare->ps_Thread);
+		ps_Compare->ps_Thread = NULL;
+		}
+
+	if (ps_Config->ul_Period != 0)
+		{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			memcpy (&ps_Compare->s_Config, ps_Config, sizeof (str_APCI1710_PositionCompare));
+			ps_Compare->b_Valid      = 0;
+			ps_Compare->ul_Read      = 0;
+			ps_Compare->ul_Write     = 0;
+			ps_Compare->ul_Lost      = 0;
+			ps_Compare->ull_Samples  = 0;
+			ps_Compare->ull_Position = 0;
+			ps_Compare->i_LastError  = 0;
+			ps_Compare->ul_Errors    = 0;
+			ps_Compare->b_SSIStarted = 0;
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+
+		ps_Compare->ps_Thread = apci1710_worker_run (pdev, i_APCI1710_PositionCompareThread, pdev, "apci1710-cmp");
+		if (IS_ERR (ps_Compare->ps_Thread))
+			{
+			ps_Compare->ps_Thread = NULL;
+			i_ReturnValue = 7;
+			}
+		}
+
+	mutex_unlock (&ps_Compare->s_Mutex);
+
+	return i_ReturnValue;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the trigger log of the position compare.
+ *
+ * The board lock is held by the caller.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Triggers          : The logged triggers, oldest first.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_ReadPositionTriggers (struct pci_dev *pdev,
+                                     str_APCI1710_PositionTriggers * ps_Triggers)
+	{
+	str_PositionCompareInfos * ps_Compare = NULL;
+	uint32_t ul_Count = 0;
+
+	if (!pdev || !ps_Triggers) return 1;
+
+	ps_Compare = &(APCI1710_PRIVDATA(pdev)->s_PositionCompare);
+
+	while ((ps_Compare->ul_Read != ps_Compare->ul_Write) && (ul_Count < APCI1710_POSITION_TRIGGER_LOG_SIZE))
+		{
+		ps_Triggers->s_Trigger [ul_Count++] = ps_Compare->s_Trigger [ps_Compare->ul_Read % APCI1710_POSITION_TRIGGER_LOG_SIZE];
+		ps_Compare->ul_Read++;
+		}
+
+	ps_Triggers->ul_NumberOfTriggers = ul_Count;
+	ps_Triggers->ul_LostTriggers     = ps_Compare->ul_Lost;
+	ps_Triggers->ull_Samples         = ps_Compare->ull_Samples;
+	ps_Triggers->ull_Position        = ps_Compare->ull_Position;
+	ps_Triggers->i_LastError         = ps_Compare->i_LastError;
+	ps_Triggers->ul_Errors           = ps_Compare->ul_Errors;
+
+	ps_Compare->ul_Lost = 0;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
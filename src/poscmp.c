@@ -0,0 +1,128 @@
+/** @file poscmp.c
+ 
+   Software position compare of SSI, BiSS and EnDat axes (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Configure the software position compare of an absolute encoder axis.
+ *
+ * The board is locked by i_APCI1710_SetPositionCompare itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_PositionCompare) : The configuration.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The axis type, module or channel is wrong.
+ * @retval 4: The axis is not initialised.
+ * @retval 5: The number of windows is wrong.
+ * @retval 6: A window is wrong (limits or output module).
+ * @retval 7: The sampling thread can not be started.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_SetPositionCompare (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_PositionCompare * ps_Config = kmalloc (sizeof (str_APCI1710_PositionCompare), GFP_KERNEL);
+
+	if (!ps_Config)
+		return -ENOMEM;
+
+	if ( copy_from_user(ps_Config, (str_APCI1710_PositionCompare __user *)arg, sizeof(str_APCI1710_PositionCompare) ) )
+	{
+		kfree (ps_Config);
+		return -EFAULT;
+	}
+
+	i_ErrorCode = i_APCI1710_SetPositionCompare (pdev, ps_Config);
+
+	kfree (ps_Config);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return and clear the trigger log of the position compare.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_PositionTriggers) : The logged triggers.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_ReadPositionTriggers (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_PositionTriggers * ps_Triggers = kmalloc (sizeof (str_APCI1710_PositionTriggers), GFP_KERNEL);
+
+	if (!ps_Triggers)
+		return -ENOMEM;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_APCI1710_ReadPositionTriggers (pdev, ps_Triggers);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if ( copy_to_user( (str_APCI1710_PositionTriggers __user *)arg, ps_Triggers, sizeof(str_APCI1710_PositionTriggers) ) )
+	{
+		kfree (ps_Triggers);
+		return -EFAULT;
+	}
+
+	kfree (ps_Triggers);
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
@@ -55,6 +55,9 @@
 	#define __iomem
 #endif
 
+/* Number of EnDat memory areas with a parameter cache (0xA1 to 0xAF), see Endat_1711-kapi.c */
+#define APCI1711_ENDAT_CACHED_AREAS 8
+
 //------------------------------------------------------------------------------
 
 /* Interrupt functionality: Timer, counter... */
@@ -97,6 +100,187 @@ typedef struct
 }
 str_UserInterruptCallback;
 
+/* Event subscription of one open file */
+typedef struct
+{
+	struct list_head list;           /* Entry in the board subscriber list              */
+	uint8_t   b_ModuleMask;          /* Bit n set: the events of module n are delivered */
+	uint32_t ul_InterruptMask;       /* Interrupt mask filter, 0: all the events        */
+	uint32_t ul_Size;                /* Number of events of the ring (power of 2)       */
+	uint32_t ul_Write;               /* Free running write index, interrupt side        */
+	uint32_t ul_Read;                /* Free running read index, file side              */
+	uint32_t ul_LostEvents;          /* Events lost because the ring was full           */
+	uint8_t   b_WakeUp;              /* Events received since the last notification     */
+	str_APCI1710_Event * ps_Ring;    /* NULL: the file has no subscription              */
+	wait_queue_head_t wq;            /* Readers waiting for an event                    */
+}
+str_EventSubscription;
+
+/* Latest value cache and its sampler */
+typedef struct
+{
+	str_APCI1710_ValueCache * ps_Cache;  /* One page, mapped read only by the users */
+	struct hrtimer s_Timer;              /* Sampler timer                           */
+	ktime_t kt_Period;                   /* Sampler period                          */
+	uint8_t b_ModuleMask;                /* Modules read by the sampler             */
+}
+str_ValueCacheInfos;
+
+/* Input edge detection of the digital I/O and TTL I/O modules */
+typedef struct
+{
+	struct hrtimer s_Timer;              /* Sampler timer                            */
+	ktime_t kt_Period;                   /* Sampler period                           */
+	uint8_t b_ModuleMask;                /* Modules with edges to detect             */
+	uint8_t b_ValidMask;                 /* Modules with a reference sample          */
+	uint32_t ul_RisingMask[4];           /* Channels reporting their rising edges    */
+	uint32_t ul_FallingMask[4];          /* Channels reporting their falling edges   */
+	uint32_t ul_LastValue[4];            /* Previous sample of each module           */
+}
+str_EdgeDetectionInfos;
+
+/* 64-bit extended position of the 32-bit incremental counters */
+typedef struct
+{
+	struct hrtimer s_Timer;              /* Background sampler timer                 */
+	ktime_t kt_Period;                   /* Background sampler period                */
+	uint8_t b_ValidMask;                 /* Modules with a reference raw value       */
+	uint32_t ul_LastValue[4];            /* Last raw 32-bit value of each module     */
+	int64_t ll_Position[4];              /* Extended position of each module         */
+}
+str_CounterExtensionInfos;
+
+/* Cyclic scan program */
+typedef struct
+{
+	struct hrtimer s_Timer;              /* Cycle timer                              */
+	ktime_t kt_Period;                   /* Cycle period                             */
+	uint32_t ul_NumberOfInstructions;    /* Used entries of s_Instruction            */
+	str_APCI1710_ScanInstruction s_Instruction [APCI1710_SCAN_MAX_INSTRUCTIONS];
+	str_APCI1710_ScanStatus s_Status;    /* State and registers                      */
+	uint8_t b_SSIStarted;                /* Modules with a conversion started by the program */
+	uint8_t b_SSIReadMask;               /* Modules already read in the current cycle */
+	uint32_t ul_SSIPosition[4][3];       /* Positions of the last complete conversion */
+}
+str_ScanProgramInfos;
+
+/* Software position compare of an absolute encoder axis */
+typedef struct
+{
+	struct mutex s_Mutex;                /* Serialises the configuration changes     */
+	struct task_struct * ps_Thread;      /* Sampling thread, NULL: stopped           */
+	str_APCI1710_PositionCompare s_Config; /* Only changed while the thread is stopped */
+	uint32_t ul_InsideMask;              /* Windows containing the last position     */
+	uint8_t  b_Valid;                    /* ul_InsideMask holds a sample             */
+	uint32_t ul_Read;                    /* Free running read index of the log       */
+	uint32_t ul_Write;                   /* Free running write index of the log      */
+	uint32_t ul_Lost;                    /* Triggers lost because the log was full   */
+	uint64_t ull_Samples;                /* Positions sampled                        */
+	uint64_t ull_Position;               /* Last sampled position                    */
+	int32_t  i_LastError;                /* Last error of a read or write            */
+	uint32_t ul_Errors;                  /* Number of failing reads and writes       */
+	uint8_t  b_SSIStarted;               /* A SSI conversion of the axis was started */
+	uint64_t ull_SSIStartTime;           /* Time stamp of the SSI conversion start   */
+	str_APCI1710_PositionTrigger s_Trigger [APCI1710_POSITION_TRIGGER_LOG_SIZE];
+}
+str_PositionCompareInfos;
+
+/* Timed output scheduler */
+typedef struct
+{
+	struct hrtimer s_Timer;              /* Fires at the time of the first output   */
+	uint32_t ul_Pending;                 /* Used entries of s_Schedule              */
+	str_APCI1710_TimedOutput s_Schedule [APCI1710_TIMED_OUTPUT_SCHEDULE_SIZE]; /* Sorted by time */
+	uint32_t ul_Read;                    /* Free running read index of the reports  */
+	uint32_t ul_Write;                   /* Free running write index of the reports */
+	uint32_t ul_Lost;                    /* Reports lost because the log was full   */
+	str_APCI1710_TimedOutputReport s_Report [APCI1710_TIMED_OUTPUT_REPORT_SIZE];
+}
+str_TimedOutputInfos;
+
+/* Coalescing of the event notifications */
+typedef struct
+{
+	struct hrtimer s_Timer;              /* Fires ul_Delay after the first pending event */
+	ktime_t kt_Delay;                    /* Maximal delay of a notification          */
+	uint32_t ul_MaxEvents;               /* Events per notification, 1: each event   */
+	uint32_t ul_Pending;                 /* Events not notified yet                  */
+}
+str_NotifyCoalescingInfos;
+
+/* CPU affinity of the interrupt and kernel threads of a board */
+typedef struct
+{
+	struct mutex s_Mutex;                /* Serialises the affinity changes          */
+	struct cpumask s_IrqMask;            /* Kept: the IRQ core refers to the hint    */
+	struct cpumask s_WorkerMask;         /* CPUs of the kernel threads               */
+	uint32_t ul_Flags;                   /* APCI1710_AFFINITY_* masks set by the user */
+}
+str_AffinityInfos;
+
+/* Reload values of a pulse encoder, consumed by its underflow interrupt */
+typedef struct
+{
+	uint32_t ul_Value[APCI1710_PULSE_ENCODER_QUEUE_SIZE]; /* Values to reload                   */
+	uint32_t ul_Read;                                     /* Free running read index            */
+	uint32_t ul_Write;                                    /* Free running write index           */
+	uint32_t ul_Underruns;                                /* Underflows with an empty queue     */
+	uint8_t b_Active;                                     /* Values queued since the last clear */
+}
+str_PulseEncoderQueue;
+
+/* Measurement stream and statistics of a chronometer, filled by its interrupt */
+typedef struct
+{
+	uint8_t b_Flags;                                  /* APCI1710_CHRONO_STREAM ...      */
+	uint32_t ul_Value[APCI1710_CHRONO_STREAM_SIZE];   /* Raw measured values             */
+	uint32_t ul_Read;                                 /* Free running read index         */
+	uint32_t ul_Write;                                /* Free running write index        */
+	uint32_t ul_Lost;                                 /* Values dropped since last read  */
+	str_APCI1710_ChronoStatistics s_Statistics;       /* Returned statistics             */
+	uint64_t ull_Mean;                                /* Running mean (Welford)          */
+	uint64_t ull_M2;                                  /* Sum of squared deviations, saturates */
+}
+str_ChronoStreamInfos;
+
+/* Capture ring and aggregates of an ETM, filled by its interrupt */
+typedef struct
+{
+	uint8_t b_Flags;                                  /* APCI1710_ETM_CAPTURE_RING ...   */
+	str_APCI1710_ETMCaptureRecord s_Record[APCI1710_ETM_CAPTURE_SIZE]; /* Records    */
+	uint32_t ul_Read;                                 /* Free running read index         */
+	uint32_t ul_Write;                                /* Free running write index        */
+	uint32_t ul_Lost;                                 /* Records dropped since last read */
+	str_APCI1710_ETMCaptureStatistics s_Statistics;   /* Returned aggregates             */
+	uint64_t ull_TotalTimeSum;                        /* Sum of the total times          */
+	uint64_t ull_DutyCycleSum;                        /* Sum of the duty cycles          */
+}
+str_ETMCaptureInfos;
+
+/* Position stream of an EnDat channel */
+typedef struct
+{
+	struct mutex s_Mutex;                /* Serialises the start and the stop        */
+	struct mutex s_ChannelLock;          /* Taken by the EnDat functions for their whole execution */
+	uint8_t b_Running;                   /* The thread owns the channel, protected by s_ChannelLock */
+	struct task_struct * ps_Thread;      /* Acquisition thread, NULL: stopped        */
+	str_APCI1711_EndatStream * ps_Stream; /* Pages mapped read only by the users, NULL: never started */
+	unsigned int ui_Order;               /* Allocation order of ps_Stream            */
+	struct pci_dev * pdev;               /* The board, for the thread                */
+	uint8_t b_ModulNbr;                  /* Module of the channel                    */
+	uint8_t b_Channel;                   /* EnDat channel (0 or 1)                   */
+}
+str_EndatStreamInfos;
+
+/* Per open file data (filp->private_data) */
+struct apci1710_str_FileInformations
+{
+	struct pci_dev * pdev;                  /**< board associated with the minor number */
+	struct apci1710_str_BoardInformations * ps_Board; /**< its data, held until the file is released */
+	struct mutex read_lock;                 /**< serialise the readers and the subscription changes */
+	str_EventSubscription s_Subscription;   /**< event subscription of the file */
+};
+
 
 /***************************/
 /* Interrupt routine infos */
@@ -150,6 +334,7 @@ typedef union
         uint8_t  b_TimingUnit;
         uint8_t  b_CycleMode;
         uint32_t dw_ConfigReg;
+        uint32_t ul_TimingInterval;
     } s_ChronoModuleInfo;
 
     /* BiSS infos */
@@ -168,6 +353,9 @@ typedef union
             uint8_t CRCInvert;
             uint8_t dataSlaveIndex;
             uint8_t registerSlaveID;
+            uint32_t staticMask[4]; /* bit n set: register n never changes, it is cached once read, see biss_1711-kapi.c */
+            uint32_t cachedMask[4]; /* bit n set: registerCache[n] holds the register n */
+            uint8_t registerCache[128];
         } slaveInfo[6];
     } s_BissModuleInfo;
 
@@ -175,6 +363,9 @@ typedef union
     struct
     {
     	uint8_t sensorInitialized[2]; /* set to 1 if the sensor is initialized */
+    	uint32_t selectedMrsCode[2]; /* memory area selected on the sensor, 0 if unknown */
+    	uint16_t parameterCacheValid[2][APCI1711_ENDAT_CACHED_AREAS]; /* bit n set: parameter n is cached */
+    	uint32_t parameterCache[2][APCI1711_ENDAT_CACHED_AREAS][16]; /* parameters 0x0 - 0xF of the static memory areas, see Endat_1711-kapi.c */
  	} s_EndatModuleInfo;
 
 	/* Incremental counter infos */
@@ -203,6 +394,7 @@ typedef union
 			unsigned int b_CompareLogicInit           : 1;
 			unsigned int b_FrequencyMeasurementInit   : 1;
 			unsigned int b_FrequencyMeasurementEnable : 1;
+			unsigned int b_Latch0Used                 : 1; /* software latch in latch register 0 not read yet */
 		} s_InitFlag;
 
 		union
@@ -225,6 +417,7 @@ typedef union
     {
         uint8_t b_TTLInit;
         uint8_t b_PortConfiguration[4];
+        uint32_t dw_InputMask; /* channels of the port register readable as input, set at init */
     } s_TTLIOInfo;
 
 	/* Digital I/O infos */
@@ -302,28 +495,64 @@ struct apci1710_str_BoardInformations
 {
 	spinlock_t lock; /**< protect the board data */
 
+	struct kref kref; /**< one reference for the probe, one per open file, see knowndev.c */
+	struct rw_semaphore remove_sem; /**< held for reading by the file operations, for writing by remove() */
+	uint8_t b_Removed; /**< the board is removed, the open files fail with -ENODEV */
+	wait_queue_head_t remove_wait; /**< woken when b_Removed is set: the functions sleeping under remove_sem give up */
+
 	str_BoardInfos s_BoardInfos;
 	str_ModuleInfo s_ModuleInfo[4];
 	str_InterruptInfos s_InterruptInfos;
 	str_InterruptParameters s_InterruptParameters;
 	str_InterruptFunctionality  s_InterruptFunctionality [4];
-	/* field used to implement linked list */
-	struct pci_dev * previous; /**< previous in known-devices linked list */
-	struct pci_dev * next; /**< next in known-devices linked list */
+	uint8_t b_ArmedModules; /**< modules with an enabled interrupt source, see v_APCI1710_UpdateArmedModules */
+	unsigned int ui_Index; /**< index in the known devices = minor number, see knowndev.c */
 
 	str_UserInterruptCallback s_UserInterruptCallback; /* One user interrupt for each board */
 
     struct fasync_struct * async_queue; /* asynchronous readers */
 
+	struct list_head subscriptions; /**< str_EventSubscription list, protected by lock */
+
+	str_ValueCacheInfos s_ValueCache; /**< latest values, see cache-kapi.c */
+
+	str_EdgeDetectionInfos s_EdgeDetection; /**< input edge detection, see edge-kapi.c */
+
+	str_CounterExtensionInfos s_CounterExtension; /**< 64-bit counter positions, see counter64-kapi.c */
+
+	str_ScanProgramInfos s_ScanProgram; /**< cyclic scan program, see scan-kapi.c */
+
+	str_NotifyCoalescingInfos s_NotifyCoalescing; /**< coalescing of the event notifications, see notify-kapi.c */
+
+	str_PositionCompareInfos s_PositionCompare; /**< software position compare, see poscmp-kapi.c */
+
+	str_TimedOutputInfos s_TimedOutput; /**< timed output scheduler, see outsched-kapi.c */
+
+	str_AffinityInfos s_Affinity; /**< IRQ and worker CPU affinity, see affinity-kapi.c */
+
+	str_APCI1710_ModuleConfig s_ModuleConfig [4]; /**< parameters of the succeeded initialisations, see config-kapi.c */
+
+	str_PulseEncoderQueue s_PulseEncoderQueue [4][4]; /**< [module][encoder] reload values, see imp_cpt-kapi.c */
+
+	str_ChronoStreamInfos s_ChronoStream [4]; /**< chronometer measurements, see chronos-kapi.c */
+
+	str_ETMCaptureInfos s_ETMCapture [4][2]; /**< [module][ETM] captured interrupts, see etm-kapi.c */
+
+	str_EndatStreamInfos s_EndatStream [4][2]; /**< [module][channel] EnDat position streams, see Endat_1711-kapi.c */
+
+	struct pci_dev * pdev; /**< the board itself, used by the timer callbacks */
+
 	void __iomem * memBaseAddress3;
 };
 
 /** initialise board's private data - fill it when adding new members and ioctl handlers */
+/* data is zeroed by the allocation (kzalloc_node) */
 static __inline__ void apci1710_init_priv_data(struct apci1710_str_BoardInformations * data)
 {
-	memset (data, 0, sizeof(struct apci1710_str_BoardInformations));
-
 	spin_lock_init(& (data->lock) );
+	kref_init(& (data->kref) );
+	init_rwsem(& (data->remove_sem) );
+	init_waitqueue_head(& (data->remove_wait) );
 
 	/*
 	 * This driver is only for the APCI-1710,
@@ -336,6 +565,8 @@ static __inline__ void apci1710_init_priv_data(struct apci1710_str_BoardInformat
 	data->s_InterruptFunctionality[2].v_InterruptFunction = NULL;
 	data->s_InterruptFunctionality[3].v_InterruptFunction = NULL;
 	data->s_UserInterruptCallback.v_UserInterruptFunction = NULL;
+
+	INIT_LIST_HEAD(& (data->subscriptions) );
 }
 
 
@@ -348,6 +579,50 @@ static __inline__ struct apci1710_str_BoardInformations * APCI1710_PRIVDATA(stru
 }
 
 
+/** return the board associated with an open file */
+static __inline__ struct pci_dev * APCI1710_FILE_PDEV(struct file * filp)
+{
+	return ((struct apci1710_str_FileInformations *) filp->private_data)->pdev;
+}
+
+/** return the monotonic time in ns, used to timestamp the events */
+static __inline__ uint64_t APCI1710_TIMESTAMP(void)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3,17,0)
+	return ktime_get_ns();
+#else
+	return ktime_to_ns(ktime_get());
+#endif
+}
+
+/* ordered accesses to the event rings, for kernels older than 3.14 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3,14,0)
+	#define smp_load_acquire(p) ({ typeof(*(p)) ___v = ACCESS_ONCE(*(p)); smp_mb(); ___v; })
+	#define smp_store_release(p, v) do { smp_mb(); ACCESS_ONCE(*(p)) = (v); } while (0)
+#endif
+
+/* single accesses to the value cache sequence, for kernels older than 3.19 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3,19,0)
+	#define READ_ONCE(x) ACCESS_ONCE(x)
+	#define WRITE_ONCE(x, v) (ACCESS_ONCE(x) = (v))
+#endif
+
+/* deadline tests of the sampling threads, for kernels older than 3.17 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(3,17,0)
+static __inline__ int ktime_before(const ktime_t cmp1, const ktime_t cmp2)
+{
+	return ktime_to_ns(cmp1) < ktime_to_ns(cmp2);
+}
+#endif
+
+/* accesses to the RCU board table, for kernels older than 2.6.34 and 2.6.38 */
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,34)
+	#define rcu_access_pointer(p) ACCESS_ONCE(p)
+#endif
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,38) && !defined(RCU_INIT_POINTER)
+	#define RCU_INIT_POINTER(p, v) rcu_assign_pointer(p, v)
+#endif
+
 /** lock the board */
 static __inline__ void APCI1710_LOCK(struct pci_dev * pdev, unsigned long * flags)
 {
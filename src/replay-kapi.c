@@ -0,0 +1,166 @@
+/** @file replay-kapi.c
+ 
+   Replay of recorded events through the board event delivery.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+
+#include "apci1710-private.h"
+#include "irq-private-kapi.h"
+
+EXPORT_SYMBOL(i_APCI1710_ReplayEvents);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Wait until a recorded event is due.
+ *
+ * The ioctl holds the removal semaphore of the board: the removal of the
+ * board wakes the wait up (remove_wait) instead of waiting for its end.
+ *
+ * @retval 0: The event is due.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -ENODEV : The board is being removed.
+ */
+static int i_APCI1710_WaitReplayedEvent (struct apci1710_str_BoardInformations * ps_Board,
+                                         const str_APCI1710_EventReplay * ps_Replay,
+                                         const str_APCI1710_Event * ps_Event)
+	{
+	ktime_t kt_Due;
+	DEFINE_WAIT (s_Wait);
+
+	if ((ps_Replay->ul_Speed != 0) && (ps_Event->ull_TimeStamp > ps_Replay->ull_RecordStart))
+		{
+		kt_Due = ns_to_ktime (ps_Replay->ull_ReplayStart +
+		                      div_u64 (ps_Event->ull_TimeStamp - ps_Replay->ull_RecordStart, ps_Replay->ul_Speed));
+
+		/* Late events are delivered at once */
+		prepare_to_wait (&ps_Board->remove_wait, &s_Wait, TASK_INTERRUPTIBLE);
+		if (!ps_Board->b_Removed && ktime_before (ktime_get (), kt_Due))
+			schedule_hrtimeout (&kt_Due, HRTIMER_MODE_ABS);
+		finish_wait (&ps_Board->remove_wait, &s_Wait);
+		}
+
+	if (ps_Board->b_Removed)
+		return -ENODEV;
+
+	return signal_pending (current) ? -EINTR : 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Feed recorded events back to the board event delivery.
+ *
+ * See CMD_APCI1710_ReplayEvents. Each event is delivered under the board
+ * lock through v_APCI1710_UserInterruptManagement, at the time recorded
+ * scaled by ul_Speed.
+ *
+ * The events reach every subscriber of the board, with
+ * APCI1710_REPLAYED_INTERRUPT set in their interrupt mask. The ioctl
+ * requires CAP_SYS_ADMIN (do_CMD_APCI1710_ReplayEvents), this function
+ * does not check the caller.
+ * The replay stops when the board is removed.
+ *
+ * @warning This function must be called without the board lock, it sleeps.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in,out] ps_Replay         : The events, ul_Replayed is set to the events delivered,
+ *                                     ull_ReplayStart and ull_RecordStart are set if ull_ReplayStart is 0.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The module of an event is wrong, the events before it are replayed.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -ENODEV : The board is being removed.
+ */
+int i_APCI1710_ReplayEvents (struct pci_dev *pdev,
+                             str_APCI1710_EventReplay * ps_Replay)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = NULL;
+	uint32_t ul_Cpt = 0;
+
+	if (!pdev)
+		return 1;
+
+	ps_Board = APCI1710_PRIVDATA(pdev);
+
+	ps_Replay->ul_Replayed = 0;
+
+	if (ps_Replay->ul_NumberOfEvents > APCI1710_REPLAY_MAX_EVENTS)
+		return 2;
+
+	if (ps_Replay->ul_NumberOfEvents == 0)
+		return 0;
+
+	/* First batch of a recording */
+	if (ps_Replay->ull_ReplayStart == 0)
+		{
+		ps_Replay->ull_ReplayStart = APCI1710_TIMESTAMP();
+		ps_Replay->ull_RecordStart = ps_Replay->s_Event[0].ull_TimeStamp;
+		}
+
+	for (ul_Cpt = 0; ul_Cpt < ps_Replay->ul_NumberOfEvents; ul_Cpt++)
+		{
+		const str_APCI1710_Event * ps_Event = &ps_Replay->s_Event[ul_Cpt];
+		uint32_t ul_Value[2] = {ps_Event->ul_Value[0], ps_Event->ul_Value[1]};
+		int i_ReturnValue = 0;
+
+		if (ps_Event->b_ModuleNbr >= NUMBER_OF_MODULE(pdev))
+			return 3;
+
+		i_ReturnValue = i_APCI1710_WaitReplayedEvent (ps_Board, ps_Replay, ps_Event);
+		if (i_ReturnValue != 0)
+			return i_ReturnValue;
+
+		/* Same path as the events of the interrupt routine */
+		{
+			unsigned long irqstate;
+			APCI1710_LOCK(pdev,&irqstate);
+			{
+				v_APCI1710_UserInterruptManagement (pdev,
+				                                    ps_Event->b_ModuleNbr,
+				                                    ps_Event->ul_InterruptMask | APCI1710_REPLAYED_INTERRUPT,
+				                                    ul_Value);
+			}
+			APCI1710_UNLOCK(pdev, irqstate);
+		}
+
+		ps_Replay->ul_Replayed++;
+		}
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/** @file replay.c
+ 
+   Ioctl handler of the event replay.
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+#include <linux/capability.h>
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Feed recorded events back to the board event delivery.
+ *
+ * The board is locked by i_APCI1710_ReplayEvents for each event.
+ * The structure is written back on errors too, ul_Replayed tells
+ * the events delivered.
+ * The events reach every subscriber of the board, not only the caller:
+ * CAP_SYS_ADMIN is required.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in,out] arg (str_APCI1710_EventReplay) : The events.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The number of events is wrong.
+ * @retval 3: The module of an event is wrong.
+ * @retval -EINTR : Interrupted by a signal.
+ * @retval -ENODEV : The board is being removed.
+ * @retval -EFAULT : Fail to retrieve or write user data.
+ * @retval -ENOMEM : Not enough memory.
+ * @retval -EPERM : The caller does not have CAP_SYS_ADMIN.
+ */
+int do_CMD_APCI1710_ReplayEvents (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_EventReplay * ps_Replay = NULL;
+
+	if (!capable (CAP_SYS_ADMIN))
+		return -EPERM;
+
+	ps_Replay = kmalloc (sizeof (str_APCI1710_EventReplay), GFP_KERNEL);
+	if (!ps_Replay)
+		return -ENOMEM;
+
+	if ( copy_from_user(ps_Replay, (str_APCI1710_EventReplay __user *)arg, sizeof(str_APCI1710_EventReplay) ) )
+	{
+		kfree (ps_Replay);
+		return -EFAULT;
+	}
+
+	i_ErrorCode = i_APCI1710_ReplayEvents (pdev, ps_Replay);
+
+	if ( copy_to_user( (str_APCI1710_EventReplay __user *)arg, ps_Replay, sizeof(str_APCI1710_EventReplay) ) )
+	{
+		kfree (ps_Replay);
+		return -EFAULT;
+	}
+
+	kfree (ps_Replay);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
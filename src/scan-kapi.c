@@ -0,0 +1,437 @@
+/** @file scan-kapi.c
+ 
+   Cyclic scan program executed in the kernel (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_LoadScanProgram);
+EXPORT_SYMBOL(i_APCI1710_GetScanStatus);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Check one instruction of a scan program.
+ *
+ * @retval 0: No error.
+ * @retval 4: Wrong opcode, register or condition.
+ * @retval 5: The module does not support the instruction.
+ */
+static int i_APCI1710_CheckScanInstruction (struct pci_dev *pdev,
+                                            const str_APCI1710_ScanInstruction * ps_Instruction)
+	{
+	if (ps_Instruction->b_Register >= APCI1710_SCAN_NUMBER_OF_REGISTERS)
+		return 4;
+
+	switch (ps_Instruction->b_OpCode)
+		{
+		case APCI1710_SCAN_READ:
+			if (ps_Instruction->b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+				return 5;
+
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,ps_Instruction->b_ModulNbr))
+				{
+				case APCI1710_SSI_COUNTER:
+					if (ps_Instruction->b_Channel > 2)
+						return 4;
+					return 0;
+
+				case APCI1710_INCREMENTAL_COUNTER:
+				case APCI1710_DIGITAL_IO:
+				case APCI1710_TTL_IO:
+					return 0;
+
+				default:
+					return 5;
+				}
+
+		case APCI1710_SCAN_COMPARE:
+			if (ps_Instruction->b_Channel > APCI1710_SCAN_GREATER_EQUAL)
+				return 4;
+			return 0;
+
+		case APCI1710_SCAN_AND:
+		case APCI1710_SCAN_OR:
+			if (ps_Instruction->ul_Value >= APCI1710_SCAN_NUMBER_OF_REGISTERS)
+				return 4;
+			return 0;
+
+		case APCI1710_SCAN_WRITE:
+			if (ps_Instruction->b_ModulNbr >= NUMBER_OF_MODULE(pdev))
+				return 5;
+
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,ps_Instruction->b_ModulNbr))
+				{
+				case APCI1710_INCREMENTAL_COUNTER:
+				case APCI1710_DIGITAL_IO:
+				case APCI1710_TTL_IO:
+					return 0;
+
+				default:
+					return 5;
+				}
+
+		default:
+			return 4;
+		}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the SSI positions of a module converted during the previous cycle
+ * and start the conversion of the next cycle.
+ *
+ * The cycle runs in interrupt context and does not wait for the end of the
+ * conversion. The module is read once per cycle; a conversion longer than
+ * the period keeps the previous positions.
+ *
+ * The board lock is held.
+ *
+ * @return The error code of apci1710_ssi_read_conversion, 0 if no error.
+ */
+static int i_APCI1710_ScanSSIConversion (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	str_ScanProgramInfos * ps_Scan = &(APCI1710_PRIVDATA(pdev)->s_ScanProgram);
+	uint8_t b_Mask = (uint8_t) (1 << b_ModulNbr);
+	uint32_t ul_Position[3] = {0, 0, 0};
+	uint32_t ul_TurnCpt[3] = {0, 0, 0};
+	int i_ReturnValue = 0;
+
+	if (ps_Scan->b_SSIReadMask & b_Mask)
+		return 0;
+
+	ps_Scan->b_SSIReadMask |= b_Mask;
+
+	i_ReturnValue = apci1710_ssi_read_conversion (pdev, b_ModulNbr, ul_Position, ul_TurnCpt);
+	if (i_ReturnValue == 1)
+		return 0;
+	if (i_ReturnValue != 0)
+		return i_ReturnValue;
+
+	/* Before the first conversion of the program the registers are not meaningful */
+	if (ps_Scan->b_SSIStarted & b_Mask)
+		memcpy (ps_Scan->ul_SSIPosition [b_ModulNbr], ul_Position, sizeof (ul_Position));
+
+	apci1710_ssi_start_conversion (pdev, b_ModulNbr);
+	ps_Scan->b_SSIStarted |= b_Mask;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Execute one instruction of the scan program.
+ *
+ * The board lock is held.
+ *
+ * @return The error code of the kernel function called, 0 if no error.
+ */
+static int i_APCI1710_ExecuteScanInstruction (struct pci_dev *pdev,
+                                              const str_APCI1710_ScanInstruction * ps_Instruction,
+                                              int32_t * pl_Register)
+	{
+	int32_t * pl_Value = &pl_Register [ps_Instruction->b_Register];
+	uint8_t b_ModulNbr = ps_Instruction->b_ModulNbr;
+	int i_ReturnValue = 0;
+
+	switch (ps_Instruction->b_OpCode)
+		{
+		case APCI1710_SCAN_READ:
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+				{
+				case APCI1710_INCREMENTAL_COUNTER:
+					{
+					uint32_t ul_CounterValue = 0;
+
+					i_ReturnValue = i_APCI1710_Read32BitCounterValue (pdev, b_ModulNbr, &ul_CounterValue);
+					*pl_Value = (int32_t) ul_CounterValue;
+					}
+					break;
+
+				case APCI1710_SSI_COUNTER:
+					i_ReturnValue = i_APCI1710_ScanSSIConversion (pdev, b_ModulNbr);
+					*pl_Value = (int32_t) APCI1710_PRIVDATA(pdev)->s_ScanProgram.ul_SSIPosition [b_ModulNbr][ps_Instruction->b_Channel];
+					break;
+
+				case APCI1710_DIGITAL_IO:
+					{
+					uint8_t b_PortValue = 0;
+
+					i_ReturnValue = i_APCI1710_ReadDigitalIOPortValue (pdev, b_ModulNbr, &b_PortValue);
+					*pl_Value = b_PortValue;
+					}
+					break;
+
+				case APCI1710_TTL_IO:
+					{
+					uint8_t b_ModuleMask = 0;
+					uint32_t ul_PortValue[4];
+					uint32_t ul_InputMask[4];
+
+					i_ReturnValue = i_APCI1710_ReadTTLIOAllPortValues (pdev, &b_ModuleMask, ul_PortValue, ul_InputMask);
+					if ((i_ReturnValue == 0) && ((b_ModuleMask & (1 << b_ModulNbr)) == 0))
+						i_ReturnValue = 2;
+					if (i_ReturnValue == 0)
+						*pl_Value = (int32_t) ul_PortValue [b_ModulNbr];
+					}
+					break;
+				}
+			break;
+
+		case APCI1710_SCAN_COMPARE:
+			{
+			int32_t l_Constant = (int32_t) ps_Instruction->ul_Value;
+
+			switch (ps_Instruction->b_Channel)
+				{
+				case APCI1710_SCAN_EQUAL:         *pl_Value = (*pl_Value == l_Constant); break;
+				case APCI1710_SCAN_NOT_EQUAL:     *pl_Value = (*pl_Value != l_Constant); break;
+				case APCI1710_SCAN_LESS:          *pl_Value = (*pl_Value <  l_Constant); break;
+				case APCI1710_SCAN_LESS_EQUAL:    *pl_Value = (*pl_Value <= l_Constant); break;
+				case APCI1710_SCAN_GREATER:       *pl_Value = (*pl_Value >  l_Constant); break;
+				case APCI1710_SCAN_GREATER_EQUAL: *pl_Value = (*pl_Value >= l_Constant); break;
+				}
+			}
+			break;
+
+		case APCI1710_SCAN_AND:
+			*pl_Value = (*pl_Value != 0) && (pl_Register [ps_Instruction->ul_Value] != 0);
+			break;
+
+		case APCI1710_SCAN_OR:
+			*pl_Value = (*pl_Value != 0) || (pl_Register [ps_Instruction->ul_Value] != 0);
+			break;
+
+		case APCI1710_SCAN_WRITE:
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+				{
+				case APCI1710_INCREMENTAL_COUNTER:
+					if (*pl_Value)
+						i_ReturnValue = i_APCI1710_SetDigitalChlOn (pdev, b_ModulNbr);
+					else
+						i_ReturnValue = i_APCI1710_SetDigitalChlOff (pdev, b_ModulNbr);
+					break;
+
+				case APCI1710_DIGITAL_IO:
+					if (*pl_Value)
+						i_ReturnValue = i_APCI1710_SetDigitalIOChlOn (pdev, b_ModulNbr, ps_Instruction->b_Channel);
+					else
+						i_ReturnValue = i_APCI1710_SetDigitalIOChlOff (pdev, b_ModulNbr, ps_Instruction->b_Channel);
+					break;
+
+				case APCI1710_TTL_IO:
+					if (*pl_Value)
+						i_ReturnValue = i_APCI1710_SetTTLIOChlOn (pdev, b_ModulNbr, ps_Instruction->b_Channel);
+					else
+						i_ReturnValue = i_APCI1710_SetTTLIOChlOff (pdev, b_ModulNbr, ps_Instruction->b_Channel);
+					break;
+				}
+			break;
+		}
+
+	return i_ReturnValue;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Scan program cycle, hrtimer callback.
+ *
+ * Executes the whole program with the board locked. A failing kernel
+ * function stops the program.
+ */
+static enum hrtimer_restart v_APCI1710_ScanProgramCycle (struct hrtimer * ps_Timer)
+	{
+	struct apci1710_str_BoardInformations * ps_Board = container_of (ps_Timer,
+	                                                                struct apci1710_str_BoardInformations,
+	                                                                s_ScanProgram.s_Timer);
+	str_ScanProgramInfos * ps_Scan = &ps_Board->s_ScanProgram;
+	struct pci_dev * pdev = ps_Board->pdev;
+	enum hrtimer_restart e_Restart = HRTIMER_RESTART;
+	uint64_t ull_Start = 0;
+	uint32_t ul_Duration = 0;
+	uint32_t ul_Instruction = 0;
+	int i_ReturnValue = 0;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			ull_Start = APCI1710_TIMESTAMP();
+			ps_Scan->b_SSIReadMask = 0;
+
+			for (ul_Instruction = 0; ul_Instruction < ps_Scan->ul_NumberOfInstructions; ul_Instruction++)
+				{
+				i_ReturnValue = i_APCI1710_ExecuteScanInstruction (pdev,
+				                                                   &ps_Scan->s_Instruction [ul_Instruction],
+				                                                   ps_Scan->s_Status.l_Register);
+				if (i_ReturnValue != 0)
+					break;
+				}
+
+			ul_Duration = (uint32_t) (APCI1710_TIMESTAMP() - ull_Start);
+
+			ps_Scan->s_Status.ull_TimeStamp   = ull_Start;
+			ps_Scan->s_Status.ul_LastDuration = ul_Duration;
+			if (ul_Duration > ps_Scan->s_Status.ul_MaxDuration)
+				ps_Scan->s_Status.ul_MaxDuration = ul_Duration;
+			ps_Scan->s_Status.ul_Cycles++;
+
+			if (i_ReturnValue != 0)
+				{
+				ps_Scan->s_Status.i_Error             = i_ReturnValue;
+				ps_Scan->s_Status.ul_ErrorInstruction = ul_Instruction;
+				ps_Scan->s_Status.ul_Running          = 0;
+				e_Restart = HRTIMER_NORESTART;
+				}
+			else
+				{
+				u64 ull_Periods = hrtimer_forward_now (ps_Timer, ps_Scan->kt_Period);
+
+				/* Updated with the other status fields, i_APCI1710_GetScanStatus copies them under the lock */
+				if (ull_Periods > 1)
+					ps_Scan->s_Status.ul_Overruns += (uint32_t) (ull_Periods - 1);
+				}
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	return e_Restart;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Initialise the scan program timer of a new board. */
+void apci1710_scan_program_init (struct pci_dev *pdev)
+	{
+	str_ScanProgramInfos * ps_Scan = &(APCI1710_PRIVDATA(pdev)->s_ScanProgram);
+
+	hrtimer_init (&ps_Scan->s_Timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ps_Scan->s_Timer.function = v_APCI1710_ScanProgramCycle;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Load a scan program and run it periodically.
+ *
+ * See CMD_APCI1710_LoadScanProgram for the instructions.
+ *
+ * @warning This function must be called without the board lock,
+ *          it waits for the end of a running cycle.
+ *
+ * @param [in] pdev                  : The device to use.
+ * @param [in] ps_Program            : The program. A period of 0 or no instruction stops the program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The number of instructions is wrong.
+ * @retval 4: An instruction has a wrong opcode, register or condition.
+ * @retval 5: An instruction reads or writes a module which does not support it.
+ */
+int i_APCI1710_LoadScanProgram (struct pci_dev *pdev,
+                                const str_APCI1710_ScanProgram * ps_Program)
+	{
+	str_ScanProgramInfos * ps_Scan = NULL;
+	uint32_t ul_Instruction = 0;
+	int i_ReturnValue = 0;
+
+	if (!pdev || !ps_Program) return 1;
+
+	if ((ps_Program->ul_Period != 0) && (ps_Program->ul_Period < APCI1710_SCAN_MIN_PERIOD))
+		return 2;
+
+	if (ps_Program->ul_NumberOfInstructions > APCI1710_SCAN_MAX_INSTRUCTIONS)
+		return 3;
+
+	for (ul_Instruction = 0; ul_Instruction < ps_Program->ul_NumberOfInstructions; ul_Instruction++)
+		{
+		i_ReturnValue = i_APCI1710_CheckScanInstruction (pdev, &ps_Program->s_Instruction [ul_Instruction]);
+		if (i_ReturnValue != 0)
+			return i_ReturnValue;
+		}
+
+	ps_Scan = &(APCI1710_PRIVDATA(pdev)->s_ScanProgram);
+
+	/* Stop the running program */
+	hrtimer_cancel (&ps_Scan->s_Timer);
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			memset (&ps_Scan->s_Status, 0, sizeof (ps_Scan->s_Status));
+			memset (ps_Scan->ul_SSIPosition, 0, sizeof (ps_Scan->ul_SSIPosition));
+			ps_Scan->b_SSIStarted = 0;
+			memcpy (ps_Scan->s_Instruction,
+			        ps_Program->s_Instruction,
+			        ps_Program->ul_NumberOfInstructions * sizeof (str_APCI1710_ScanInstruction));
+
+			ps_Scan->ul_NumberOfInstructions = ps_Program->ul_NumberOfInstructions;
+			ps_Scan->kt_Period               = ns_to_ktime ((uint64_t) ps_Program->ul_Period * NSEC_PER_USEC);
+			ps_Scan->s_Status.ul_Running     = (ps_Program->ul_Period != 0) && (ps_Program->ul_NumberOfInstructions != 0);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if (ps_Scan->s_Status.ul_Running)
+		hrtimer_start (&ps_Scan->s_Timer, ps_Scan->kt_Period, HRTIMER_MODE_REL);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
+/** Return the state and the registers of the scan program.
+ *
+ * The board lock is held by the caller.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] ps_Status            : State of the program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ */
+int i_APCI1710_GetScanStatus (struct pci_dev *pdev,
+                              str_APCI1710_ScanStatus * ps_Status)
+	{
+	if (!pdev || !ps_Status) return 1;
+
+	memcpy (ps_Status, &(APCI1710_PRIVDATA(pdev)->s_ScanProgram.s_Status), sizeof (str_APCI1710_ScanStatus));
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+/** @file scan.c
+ 
+   Cyclic scan program executed in the kernel (ioctl functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+/**@def EXPORT_NO_SYMBOLS
+ * Function in this file are not exported.
+ */
+EXPORT_NO_SYMBOLS;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,4,27)
+#define __user 
+#endif
+
+//------------------------------------------------------------------------------
+
+/** Load a scan program and run it periodically.
+ *
+ * The board is locked by i_APCI1710_LoadScanProgram itself.
+ *
+ * @param [in] pdev                     : The device to use.
+ * @param [in] arg (str_APCI1710_ScanProgram) : The program.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The period is wrong.
+ * @retval 3: The number of instructions is wrong.
+ * @retval 4: An instruction has a wrong opcode, register or condition.
+ * @retval 5: An instruction reads or writes a module which does not support it.
+ * @retval -EFAULT : Fail to retrieve user data.
+ * @retval -ENOMEM : Not enough memory.
+ */
+int do_CMD_APCI1710_LoadScanProgram (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	str_APCI1710_ScanProgram * ps_Program = kmalloc (sizeof (str_APCI1710_ScanProgram), GFP_KERNEL);
+
+	if (!ps_Program)
+		return -ENOMEM;
+
+	if ( copy_from_user(ps_Program, (str_APCI1710_ScanProgram __user *)arg, sizeof(str_APCI1710_ScanProgram) ) )
+	{
+		kfree (ps_Program);
+		return -EFAULT;
+	}
+
+	i_ErrorCode = i_APCI1710_LoadScanProgram (pdev, ps_Program);
+
+	kfree (ps_Program);
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------
+
+/** Return the state and the registers of the scan program.
+ *
+ * @param [in] pdev                     : The device to use.
+ *
+ * @param [out] arg (str_APCI1710_ScanStatus) : State of the program.
+ *
+ * @retval 0: No error.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_GetScanStatus (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	str_APCI1710_ScanStatus s_Status;
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_APCI1710_GetScanStatus (pdev, &s_Status);
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+
+	if ( copy_to_user( (str_APCI1710_ScanStatus __user *)arg, &s_Status, sizeof(s_Status) ) )
+		return -EFAULT;
+
+	return 0;
+}
+
+//------------------------------------------------------------------------------
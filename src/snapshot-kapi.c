@@ -0,0 +1,258 @@
+/** @file snapshot-kapi.c
+ 
+   Coherent snapshot of the modules of all the boards (kernel functions).
+ 
+   @par CREATION  
+   @author agent
+   @date   18.10.2026
+   
+   @par VERSION
+   @verbatim
+   $LastChangedRevision:$
+   $LastChangedDate:$
+   @endverbatim   
+   
+   @par LICENCE
+   @verbatim
+    Copyright (C) 2026  agent for the source code of this module.
+        
+   This program is free software; you can redistribute it and/or modify it under 
+   the terms of the GNU General Public License as published by the Free Software 
+   Foundation; either version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, 
+   but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+   or FITNESS FOR A PARTICULAR PURPOSE. 
+   See the GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along with 
+   this program; if not, write to the Free Software Foundation, 
+   Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+   You shoud also find the complete GPL in the COPYING file 
+   accompanying this source code.
+   @endverbatim   
+ */
+
+#include "apci1710-private.h"
+
+EXPORT_SYMBOL(i_APCI1710_ReadBoardsSnapshot);
+
+EXPORT_NO_SYMBOLS;
+
+//------------------------------------------------------------------------------
+
+/** Latch the modules of one board.
+ *
+ * The board lock is held. The incremental counters are latched in the latch
+ * register 0 and the SSI acquisitions are started; the modules which are
+ * not initialised reject the call and are left out.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [out] ps_Board         : Snapshot of the board (time stamp and counter modules).
+ * @param [out] pb_SSIMask       : Modules whose SSI acquisition was started.
+ */
+static void v_APCI1710_LatchBoard (struct pci_dev *pdev,
+                                   str_APCI1710_BoardSnapshot * ps_Board,
+                                   uint8_t * pb_SSIMask)
+	{
+	uint8_t b_ModulNbr = 0;
+
+	*pb_SSIMask = 0;
+
+	for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr++)
+		{
+		switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+			{
+			case APCI1710_INCREMENTAL_COUNTER:
+				/* Latch register 0 of the application is left alone */
+				if (!apci1710_inc_cpt_latch0_in_use (pdev, b_ModulNbr) &&
+				    (i_APCI1710_LatchCounter (pdev, b_ModulNbr, 0) == 0))
+					ps_Board->ul_ValidMask |= (1 << b_ModulNbr);
+				break;
+
+			case APCI1710_SSI_COUNTER:
+				if (i_APCI1710_StartSSIAcquisition (pdev, b_ModulNbr) == 0)
+					*pb_SSIMask |= (1 << b_ModulNbr);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+	ps_Board->ull_TimeStamp = APCI1710_TIMESTAMP();
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the modules of one board latched by v_APCI1710_LatchBoard.
+ *
+ * Takes the board lock. Waits for the end of the SSI acquisitions
+ * (at most APCI1710_SNAPSHOT_SSI_TIMEOUT us) and reads the counter,
+ * SSI, digital I/O and TTL I/O modules.
+ *
+ * @param [in] pdev              : The device to use.
+ * @param [in] b_SSIMask         : Modules whose SSI acquisition was started.
+ * @param [in,out] ps_Board      : Snapshot of the board.
+ */
+static void v_APCI1710_ReadBoard (struct pci_dev *pdev,
+                                  uint8_t b_SSIMask,
+                                  str_APCI1710_BoardSnapshot * ps_Board)
+	{
+	uint8_t b_ModulNbr = 0;
+	uint8_t b_Pending = b_SSIMask;
+	uint32_t ul_Timeout = 0;
+
+	/* Wait for the SSI acquisitions, the lock is released between two polls */
+	while (b_Pending && (ul_Timeout < APCI1710_SNAPSHOT_SSI_TIMEOUT))
+		{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr++)
+			{
+			uint8_t b_Status = 1;
+
+			if ((b_Pending & (1 << b_ModulNbr)) == 0)
+				continue;
+
+			if ((i_APCI1710_GetSSIAcquisitionStatus (pdev, b_ModulNbr, &b_Status) != 0) || (b_Status == 0))
+				b_Pending &= ~(1 << b_ModulNbr);
+			}
+		APCI1710_UNLOCK(pdev,irqstate);
+
+		if (b_Pending)
+			{
+			udelay (1);
+			ul_Timeout++;
+			}
+		}
+
+	{
+		unsigned long irqstate;
+		uint8_t b_TTLMask = 0;
+		uint32_t ul_TTLPortValue[4];
+		uint32_t ul_TTLInputMask[4];
+
+		APCI1710_LOCK(pdev,&irqstate);
+
+		for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr++)
+			{
+			uint32_t * pul_Value = ps_Board->ul_Value[b_ModulNbr];
+
+			switch (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr))
+				{
+				case APCI1710_INCREMENTAL_COUNTER:
+					if ((ps_Board->ul_ValidMask & (1 << b_ModulNbr)) &&
+					    (i_APCI1710_ReadLatchRegisterValue (pdev, b_ModulNbr, 0, &pul_Value[0]) != 0))
+						ps_Board->ul_ValidMask &= ~(1 << b_ModulNbr);
+					break;
+
+				case APCI1710_SSI_COUNTER:
+					if ((b_SSIMask & (1 << b_ModulNbr)) && !(b_Pending & (1 << b_ModulNbr)))
+						{
+						uint8_t b_SelectedSSI = 0;
+
+						for (b_SelectedSSI = 0; b_SelectedSSI < 3; b_SelectedSSI++)
+							if (i_APCI1710_GetSSIValue (pdev,
+							                            b_ModulNbr,
+							                            b_SelectedSSI,
+							                            &pul_Value[2 * b_SelectedSSI],
+							                            &pul_Value[(2 * b_SelectedSSI) + 1]) != 0)
+								break;
+
+						if (b_SelectedSSI == 3)
+							ps_Board->ul_ValidMask |= (1 << b_ModulNbr);
+						}
+					break;
+
+				case APCI1710_DIGITAL_IO:
+					{
+					uint8_t b_PortValue = 0;
+
+					if (i_APCI1710_ReadDigitalIOPortValue (pdev, b_ModulNbr, &b_PortValue) == 0)
+						{
+						pul_Value[0] = b_PortValue;
+						ps_Board->ul_ValidMask |= (1 << b_ModulNbr);
+						}
+					}
+					break;
+
+				default:
+					break;
+				}
+			}
+
+		/* All the TTL I/O modules in one pass */
+		if (i_APCI1710_ReadTTLIOAllPortValues (pdev, &b_TTLMask, ul_TTLPortValue, ul_TTLInputMask) == 0)
+			for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr++)
+				if (b_TTLMask & (1 << b_ModulNbr))
+					{
+					ps_Board->ul_Value[b_ModulNbr][0] = ul_TTLPortValue[b_ModulNbr];
+					ps_Board->ul_ValidMask |= (1 << b_ModulNbr);
+					}
+
+		APCI1710_UNLOCK(pdev,irqstate);
+	}
+	}
+
+//------------------------------------------------------------------------------
+
+/** Latch and read the initialised modules of all the boards in one call.
+ *
+ * @warning This function must be called without any board lock.
+ *
+ * @param [out] ps_Snapshot      : The snapshot.
+ *
+ * @retval 0: No error.
+ * @retval 1: ps_Snapshot is NULL.
+ */
+int i_APCI1710_ReadBoardsSnapshot (str_APCI1710_Snapshot * ps_Snapshot)
+	{
+	struct pci_dev * pdev[APCI1710_SNAPSHOT_MAX_BOARDS];
+	uint8_t b_SSIMask[APCI1710_SNAPSHOT_MAX_BOARDS];
+	uint32_t ul_Board = 0;
+	uint32_t ul_NumberOfBoards = 0;
+
+	if (!ps_Snapshot)
+		return 1;
+
+	memset (ps_Snapshot, 0, sizeof (str_APCI1710_Snapshot));
+
+	/* The boards can not be removed until the end of the snapshot */
+	rcu_read_lock ();
+
+	/* Minor numbers of removed boards are free */
+	for (ul_Board = 0; ul_Board < APCI1710_SNAPSHOT_MAX_BOARDS; ul_Board++)
+		{
+		pdev[ul_Board] = apci1710_lookup_board_by_index (ul_Board);
+		if (pdev[ul_Board])
+			ul_NumberOfBoards = ul_Board + 1;
+		}
+
+	/* Latch all the boards back to back */
+	for (ul_Board = 0; ul_Board < ul_NumberOfBoards; ul_Board++)
+		{
+		unsigned long irqstate;
+
+		if (!pdev[ul_Board])
+			continue;
+
+		APCI1710_LOCK(pdev[ul_Board],&irqstate);
+		v_APCI1710_LatchBoard (pdev[ul_Board], &ps_Snapshot->s_Board[ul_Board], &b_SSIMask[ul_Board]);
+		APCI1710_UNLOCK(pdev[ul_Board],irqstate);
+		}
+
+	/* Then read them */
+	for (ul_Board = 0; ul_Board < ul_NumberOfBoards; ul_Board++)
+		if (pdev[ul_Board])
+			v_APCI1710_ReadBoard (pdev[ul_Board], b_SSIMask[ul_Board], &ps_Snapshot->s_Board[ul_Board]);
+
+	rcu_read_unlock ();
+
+	ps_Snapshot->ul_NumberOfBoards = ul_NumberOfBoards;
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
@@ -46,6 +46,8 @@
  
 
 #include "apci1710-private.h"
+#include "apci1710-trace.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitSSI);
 EXPORT_SYMBOL(i_APCI1710_InitSSIRawData);
@@ -342,6 +344,17 @@ int   i_APCI1710_InitSSI (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		ps_Config->u.s_SSI.b_SSIProfile         = b_SSIProfile;
+		ps_Config->u.s_SSI.b_PositionTurnLength = b_PositionTurnLength;
+		ps_Config->u.s_SSI.b_TurnCptLength      = b_TurnCptLength;
+		ps_Config->u.s_SSI.b_PCIInputClock      = b_PCIInputClock;
+		ps_Config->u.s_SSI.ul_SSIOutputClock    = ul_SSIOutputClock;
+		ps_Config->u.s_SSI.b_SSICountingMode    = b_SSICountingMode;
+		}
+
 	return (i_ReturnValue);
 	}
 
@@ -492,6 +505,10 @@ int   i_APCI1710_InitSSIRawData (struct pci_dev *pdev,
 		i_ReturnValue = 2;
 		}
 
+	/* Raw data mode, not described by the board configuration */
+	if (i_ReturnValue == 0)
+		v_APCI1710_ForgetModuleConfig (pdev, b_ModulNbr);
+
 	return (i_ReturnValue);
 	}
 	
@@ -572,6 +589,8 @@ int i_APCI1710_Read1SSIValue (struct pci_dev *pdev,
 		    /* Start the conversion */
 		    /************************/
 
+			 trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
 			 OUTPDW (GET_BAR2(pdev),
 					8 + MODULE_OFFSET(b_ModulNbr),
 					0);
@@ -585,6 +604,8 @@ int i_APCI1710_Read1SSIValue (struct pci_dev *pdev,
 		       }
 		    while ((dw_StatusReg & 0x1) != 0);
 
+		    trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
 		    /******************************/
 		    /* Read the SSI counter value */
 		    /******************************/
@@ -826,6 +847,8 @@ int i_APCI1710_Read1SSIRawDataValue (struct pci_dev *pdev,
 					{
 
 					// Start the conversion 
+			 		trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
 			 		OUTPDW (GET_BAR2(pdev),
 						8 + MODULE_OFFSET(b_ModulNbr),
 						0);
@@ -837,6 +860,8 @@ int i_APCI1710_Read1SSIRawDataValue (struct pci_dev *pdev,
 						}
 					while ((dw_StatusReg & 0x1) != 0);
 
+					trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
 					if (b_ValueArraySize >= 1)
 						{
 						// Read the SSI counter value 
@@ -911,27 +936,16 @@ int i_APCI1710_Read1SSIRawDataValue (struct pci_dev *pdev,
 
 //------------------------------------------------------------------------------
 
-/** Read all SSI counter.
- *
- * @param [in] pdev              : The device to initialize.
- * @param [in] b_ModulNbr        : Module number to configure (0 to 3).
- *
- * @param [out] pul_Position     : SSI position in the turn.
- * @param [out] pul_TurnCpt      : Number of turns.
+/** Convert the SSI counter registers of a module to the positions and
+ * turn counts, the conversion is complete.
  *
- * @retval 0: No error.
- * @retval 1: The handle parameter of the board is wrong.
- * @retval 2: The module parameter is wrong.
- * @retval 3: The module is not a SSI module.
- * @retval 4: SSI not initialised see function "i_APCI1710_InitSSI".
- * @retval 5: This function does not support more than 32 bits profile length.
+ * The module is an initialised SSI module with a profile of 32 bits or less.
  */
-int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
-                                uint8_t b_ModulNbr,
-                                uint32_t * pul_Position,
-                                uint32_t *pul_TurnCpt)
+static void v_APCI1710_ConvertSSIValue (struct pci_dev *pdev,
+                                        uint8_t b_ModulNbr,
+                                        uint32_t * pul_Position,
+                                        uint32_t *pul_TurnCpt)
 	{
-	int i_ReturnValue = 0;
 	unsigned char b_Cpt = 0;
 	unsigned char b_Length = 0;
 	unsigned char b_Schift = 0;
@@ -942,35 +956,8 @@ int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
 	uint32_t dw_And = 0;
 	uint32_t dw_And1 = 0;
 	uint32_t dw_And2 = 0;
-	uint32_t dw_StatusReg = 0;
 	uint32_t dw_CounterValue = 0;
 
-	if (!pdev) return 1;
-
-	/**************************/
-	/* Test the module number */
-	/**************************/
-
-	if (b_ModulNbr < APCI1710_PRIVDATA(pdev)->s_BoardInfos.b_NumberOfModule)
-	   {
-	   /***********************/
-	   /* Test if SSI counter */
-	   /***********************/
-
-	   if ( APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) == APCI1710_SSI_COUNTER)
-			{
-			// Test if SSI initialised 
-			if (APCI1710_PRIVDATA(pdev)->
-				s_ModuleInfo [(int)b_ModulNbr].
-				s_SSICounterInfo.
-				b_SSIInit == 1)
-				{
-			 // Test if more than 32 bits profile length initialisied
-			 if (APCI1710_PRIVDATA(pdev)->
-				s_ModuleInfo [(int)b_ModulNbr].
-					s_SSICounterInfo.
-					b_SSIProfile < 33)
-				{
 
 		 dw_And1 = 1;
 
@@ -992,23 +979,6 @@ int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
 		    dw_And2 = dw_And2 * 2;
 		    }
 
-		 /************************/
-		 /* Start the conversion */
-		 /************************/
-
-		OUTPDW (GET_BAR2(pdev),
-			8 + MODULE_OFFSET(b_ModulNbr),
-			0);
-
-		 do
-		    {
-		    /*******************/
-		    /* Read the status */
-		    /*******************/
-			 INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
-		    }
-		 while ((dw_StatusReg & 0x1) != 0);
-
 		 for (b_SSICpt = 0; b_SSICpt < 3; b_SSICpt ++)
 		    {
 		    /******************************/
@@ -1127,6 +1097,82 @@ int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
 		       // Begin 16.09.03 SW : 2243-0703 -> 2244-0903 : Only for multi turn
 		       }
 		    }
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read all SSI counter.
+ *
+ * @param [in] pdev              : The device to initialize.
+ * @param [in] b_ModulNbr        : Module number to configure (0 to 3).
+ *
+ * @param [out] pul_Position     : SSI position in the turn.
+ * @param [out] pul_TurnCpt      : Number of turns.
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: The module parameter is wrong.
+ * @retval 3: The module is not a SSI module.
+ * @retval 4: SSI not initialised see function "i_APCI1710_InitSSI".
+ * @retval 5: This function does not support more than 32 bits profile length.
+ */
+int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
+                                uint8_t b_ModulNbr,
+                                uint32_t * pul_Position,
+                                uint32_t *pul_TurnCpt)
+	{
+	int i_ReturnValue = 0;
+	uint32_t dw_StatusReg = 0;
+
+	if (!pdev) return 1;
+
+	/**************************/
+	/* Test the module number */
+	/**************************/
+
+	if (b_ModulNbr < APCI1710_PRIVDATA(pdev)->s_BoardInfos.b_NumberOfModule)
+	   {
+	   /***********************/
+	   /* Test if SSI counter */
+	   /***********************/
+
+	   if ( APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) == APCI1710_SSI_COUNTER)
+			{
+			// Test if SSI initialised 
+			if (APCI1710_PRIVDATA(pdev)->
+				s_ModuleInfo [(int)b_ModulNbr].
+				s_SSICounterInfo.
+				b_SSIInit == 1)
+				{
+			 // Test if more than 32 bits profile length initialisied
+			 if (APCI1710_PRIVDATA(pdev)->
+				s_ModuleInfo [(int)b_ModulNbr].
+					s_SSICounterInfo.
+					b_SSIProfile < 33)
+				{
+
+		 /************************/
+		 /* Start the conversion */
+		 /************************/
+
+		trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
+		OUTPDW (GET_BAR2(pdev),
+			8 + MODULE_OFFSET(b_ModulNbr),
+			0);
+
+		 do
+		    {
+		    /*******************/
+		    /* Read the status */
+		    /*******************/
+			 INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
+		    }
+		 while ((dw_StatusReg & 0x1) != 0);
+
+		 trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
+		 v_APCI1710_ConvertSSIValue (pdev, b_ModulNbr, pul_Position, pul_TurnCpt);
 				}
 			 else
 				{
@@ -1166,6 +1212,61 @@ int i_APCI1710_ReadAllSSIValue (struct pci_dev *pdev,
 
 //------------------------------------------------------------------------------
 
+/** Start the conversion of the SSI counters of a module, without waiting
+ * for its end (scan program).
+ *
+ * The board lock is held, b_ModulNbr is a SSI module.
+ * The positions are read by apci1710_ssi_read_conversion.
+ */
+void apci1710_ssi_start_conversion (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
+	OUTPDW (GET_BAR2(pdev),
+		8 + MODULE_OFFSET(b_ModulNbr),
+		0);
+	}
+
+//------------------------------------------------------------------------------
+
+/** Read the positions of the last SSI conversion of a module if it is complete.
+ *
+ * The board lock is held, b_ModulNbr is a SSI module.
+ *
+ * @param [out] pul_Position     : SSI position in the turn, not changed unless 0 is returned.
+ * @param [out] pul_TurnCpt      : Number of turns, not changed unless 0 is returned.
+ *
+ * @retval 0: No error.
+ * @retval 1: The conversion is running.
+ * @retval 4: SSI not initialised see function "i_APCI1710_InitSSI".
+ * @retval 5: This function does not support more than 32 bits profile length.
+ */
+int apci1710_ssi_read_conversion (struct pci_dev *pdev,
+                                  uint8_t b_ModulNbr,
+                                  uint32_t * pul_Position,
+                                  uint32_t *pul_TurnCpt)
+	{
+	uint32_t dw_StatusReg = 0;
+
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SSICounterInfo.b_SSIInit != 1)
+		return 4;
+
+	if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [(int)b_ModulNbr].s_SSICounterInfo.b_SSIProfile >= 33)
+		return 5;
+
+	INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
+	if ((dw_StatusReg & 0x1) != 0)
+		return 1;
+
+	trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
+	v_APCI1710_ConvertSSIValue (pdev, b_ModulNbr, pul_Position, pul_TurnCpt);
+
+	return 0;
+	}
+
+//------------------------------------------------------------------------------
+
 /** Read all raw SSI counter.
  *
  * @param [in] pdev              : The device to initialize.
@@ -1212,6 +1313,8 @@ int i_APCI1710_ReadAllSSIRawDataValue (struct pci_dev *pdev,
 				b_SSIInit == 1)
 				{
 			// Start the conversion 
+				trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
 				OUTPDW (GET_BAR2(pdev),
 					8 + MODULE_OFFSET(b_ModulNbr),
 					0);
@@ -1223,6 +1326,8 @@ int i_APCI1710_ReadAllSSIRawDataValue (struct pci_dev *pdev,
 		    }
 		 while ((dw_StatusReg & 0x1) != 0);
 
+		 trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
 		 for (b_SSICpt = 0; b_SSICpt < 3; b_SSICpt ++)
 		    {
 			if (b_ValueArraySize >= 3)
@@ -1391,6 +1496,8 @@ int i_APCI1710_StartSSIAcquisition (struct pci_dev *pdev,
 		    /* Start the conversion */
 		    /************************/
 
+			trace_apci1710_ssi_start (pdev, b_ModulNbr);
+
 			OUTPDW (GET_BAR2(pdev),
 						8 + MODULE_OFFSET(b_ModulNbr),
 						0);
@@ -1588,6 +1695,8 @@ int i_APCI1710_GetSSIValue (struct pci_dev *pdev,
 
 		    if ((dw_StatusReg & 1) == 0)
 		       {
+		       trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
 			 // Test if more than 32 bits profile length initialisied
 			 if (APCI1710_PRIVDATA(pdev)->
 				s_ModuleInfo [(int)b_ModulNbr].
@@ -1820,6 +1929,8 @@ int i_APCI1710_GetSSIRawDataValue (struct pci_dev *pdev,
 
 				    if ((dw_StatusReg & 1) == 0)
 						{
+						trace_apci1710_ssi_complete (pdev, b_ModulNbr, dw_StatusReg);
+
 						if (b_ValueArraySize >= 1)
 							{
 							// Read the SSI counter value 
@@ -46,12 +46,60 @@
  
 
 #include "apci1710-private.h"
+#include "cache-private-kapi.h"
+#include "config-private-kapi.h"
 
 EXPORT_SYMBOL(i_APCI1710_InitTTLIO);
 EXPORT_SYMBOL(i_APCI1710_InitTTLIODirection);
 EXPORT_SYMBOL(i_APCI1710_ReadTTLIOChannelValue);
 EXPORT_SYMBOL(i_APCI1710_SetTTLIOChlOn);
 EXPORT_SYMBOL(i_APCI1710_SetTTLIOChlOff);
+EXPORT_SYMBOL(i_APCI1710_ReadTTLIOAllPortValues);
+
+//------------------------------------------------------------------------------
+
+/** Save the input channels of a TTL I/O module.
+ *
+ * Computes, from the firmware version and the port configuration,
+ * the bits of the port register (see APCI1710_TTL_PORT_A_MASK) that can
+ * be read as input, so the read functions don't have to test them again.
+ * The versions are the ones i_APCI1710_ReadTTLIOChannelValue accepts:
+ * 0x3130 (ports A, B and C) and 0x3230 or later (ports set as input).
+ *
+ * @param [in] pdev                  : The device.
+ * @param [in] b_ModulNbr            : Module number (0 to 3).
+ */
+static void v_APCI1710_SetTTLIOInputMask (struct pci_dev *pdev, uint8_t b_ModulNbr)
+	{
+	uint8_t  b_Port = 0;
+	uint32_t dw_InputMask = 0;
+
+	if ((APCI1710_PRIVDATA(pdev)->s_BoardInfos.dw_MolduleConfiguration [b_ModulNbr] & 0xFFFF) >= 0x3230)
+	   {
+	   /**********************************/
+	   /* Ports configured as input      */
+	   /**********************************/
+
+	   for (b_Port = 0; b_Port < 3; b_Port ++)
+	      if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_PortConfiguration [b_Port] == 0)
+		 dw_InputMask |= APCI1710_TTL_PORT_A_MASK << (8 * b_Port);
+
+	   if (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_PortConfiguration [3] == 0)
+	      dw_InputMask |= APCI1710_TTL_PORT_D_MASK;
+	   }
+	else if ((APCI1710_PRIVDATA(pdev)->s_BoardInfos.dw_MolduleConfiguration [b_ModulNbr] & 0xFFFF) == 0x3130)
+	   {
+	   /*********************************/
+	   /* Ports A, B and C always input */
+	   /*********************************/
+
+	   dw_InputMask = APCI1710_TTL_PORT_A_MASK | APCI1710_TTL_PORT_B_MASK | APCI1710_TTL_PORT_C_MASK;
+	   }
+
+	/* The other versions have no input */
+
+	APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.dw_InputMask = dw_InputMask;
+	}
 
 //------------------------------------------------------------------------------
 
@@ -130,6 +178,8 @@ int i_APCI1710_InitTTLIO (struct pci_dev *pdev, uint8_t b_ModulNbr)
 	      /*************************/
 
 		   OUTPDW (GET_BAR2(pdev), 20 + (64 * b_ModulNbr), 0x8);
+
+		   v_APCI1710_SetTTLIOInputMask (pdev, b_ModulNbr);
 	      }
 	   else
 	      {
@@ -149,6 +199,12 @@ int i_APCI1710_InitTTLIO (struct pci_dev *pdev, uint8_t b_ModulNbr)
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		memcpy (ps_Config->u.s_TTLIO.b_PortMode, APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_PortConfiguration, 4);
+		}
+
 	return (i_ReturnValue);
 	}
 
@@ -276,6 +332,8 @@ int i_APCI1710_InitTTLIODirection (struct pci_dev *pdev,
 													(b_PortBMode << 1) |
 													(b_PortCMode << 2) |
 													(b_PortDMode << 3));
+
+								v_APCI1710_SetTTLIOInputMask (pdev, b_ModulNbr);
 			     }
 			  else
 			     {
@@ -340,6 +398,12 @@ int i_APCI1710_InitTTLIODirection (struct pci_dev *pdev,
 	   i_ReturnValue = 2;
 	   }
 
+	if (i_ReturnValue == 0)
+		{
+		str_APCI1710_ModuleConfig * ps_Config = ps_APCI1710_RecordModuleInit (pdev, b_ModulNbr);
+		memcpy (ps_Config->u.s_TTLIO.b_PortMode, APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_PortConfiguration, 4);
+		}
+
 	return (i_ReturnValue);
 	}
 
@@ -419,12 +483,10 @@ int i_APCI1710_ReadTTLIOChannelValue (struct pci_dev *pdev,
 		       /* Test if TTL port used for input */
 		       /***********************************/
 
-		       if (((APCI1710_PRIVDATA(pdev)->s_BoardInfos.dw_MolduleConfiguration [b_ModulNbr] & 0xFFFF) == 0x3130) ||
-			   (((APCI1710_PRIVDATA(pdev)->s_BoardInfos.dw_MolduleConfiguration [b_ModulNbr] & 0xFFFF) >= 0x3230) &&
-			    (APCI1710_PRIVDATA(pdev)->
+		       if ((APCI1710_PRIVDATA(pdev)->
 								s_ModuleInfo [b_ModulNbr].
 								s_TTLIOInfo.
-			     b_PortConfiguration [b_SelectedPort] == 0)))
+			    dw_InputMask >> (8 * b_SelectedPort)) & 1)
 			  {
 			  /**************************/
 			  /* Read all digital input */
@@ -435,6 +497,8 @@ int i_APCI1710_ReadTTLIOChannelValue (struct pci_dev *pdev,
 			      &dw_StatusReg);
 
 			  *b_ChannelStatus = (uint8_t) ((dw_StatusReg >> (8 * b_SelectedPort)) >> b_InputChannel) & 1;
+
+			  v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, dw_StatusReg & 0x03FFFFFFUL);
 			  }
 		       else
 			  {
@@ -815,12 +879,65 @@ int i_APCI1710_SetTTLIOChlOff (struct pci_dev *pdev,
 	return (i_ReturnValue);
 	}
 
+//------------------------------------------------------------------------------
+
+/** Read all ports of all initialised TTL I/O modules of the board.
+ *
+ * Each module is read with one access to its port register. The value
+ * is returned with the layout of the port register (see
+ * APCI1710_TTL_PORT_A_MASK), like the masks of
+ * i_APCI1710_SetDigitalOutputsMasked, together with the mask of the channels configured
+ * as input at "i_APCI1710_InitTTLIO" / "i_APCI1710_InitTTLIODirection" time.
+ * The other bits of the value are the state of the outputs.
+ *
+ * @param [in] pdev                  : The device to use.
+ *
+ * @param [out] pb_ModuleMask        : Modules read (bit n set: module n).
+ * @param [out] pul_PortValue        : Port register of each module (0 for modules not read).
+ * @param [out] pul_InputMask        : Input channels of each module (0 for modules not read).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised TTL I/O module on this board.
+ */
+int i_APCI1710_ReadTTLIOAllPortValues (struct pci_dev *pdev,
+                                       uint8_t * pb_ModuleMask,
+                                       uint32_t pul_PortValue[4],
+                                       uint32_t pul_InputMask[4])
+	{
+	uint8_t  b_ModulNbr = 0;
+	uint32_t dw_StatusReg = 0;
+
+	if (!pdev) return 1;
+
+	*pb_ModuleMask = 0;
 
+	for (b_ModulNbr = 0; b_ModulNbr < 4; b_ModulNbr ++)
+	   {
+	   pul_PortValue [b_ModulNbr] = 0;
+	   pul_InputMask [b_ModulNbr] = 0;
 
+	   if ((b_ModulNbr >= APCI1710_PRIVDATA(pdev)->s_BoardInfos.b_NumberOfModule) ||
+	       (APCI1710_MODULE_FUNCTIONALITY(pdev,b_ModulNbr) != APCI1710_TTL_IO) ||
+	       (APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.b_TTLInit != 1))
+	      continue;
 
+	   /**************************/
+	   /* Read all digital input */
+	   /**************************/
 
+	   INPDW (GET_BAR2(pdev), MODULE_OFFSET(b_ModulNbr), &dw_StatusReg);
 
+	   pul_PortValue [b_ModulNbr] = dw_StatusReg & 0x03FFFFFFUL;
+	   pul_InputMask [b_ModulNbr] = APCI1710_PRIVDATA(pdev)->s_ModuleInfo [b_ModulNbr].s_TTLIOInfo.dw_InputMask;
 
+	   v_APCI1710_UpdateValueCache (pdev, b_ModulNbr, pul_PortValue [b_ModulNbr]);
 
+	   *pb_ModuleMask |= (1 << b_ModulNbr);
+	   }
 
+	if (*pb_ModuleMask == 0)
+	   return 2;
 
+	return 0;
+	}
@@ -199,3 +199,45 @@ int do_CMD_APCI1710_SetTTLIOChlOff (struct pci_dev *pdev, unsigned int cmd, unsi
 
 //------------------------------------------------------------------------------
 
+/** Read all ports of all initialised TTL I/O modules of the board.
+ *
+ * @param [in] pdev                        : The device to use.
+ *
+ * @param [out] arg[0] (b_ModuleMask)      : Modules read (bit n set: module n).
+ * @param [out] arg[1 + n] (ul_PortValue)  : Port register of module n (n = 0 to 3).
+ * @param [out] arg[5 + n] (ul_InputMask)  : Input channels of module n (n = 0 to 3).
+ *
+ * @retval 0: No error.
+ * @retval 1: The handle parameter of the board is wrong.
+ * @retval 2: No initialised TTL I/O module on this board.
+ * @retval -EFAULT : Fail to write user data.
+ */
+int do_CMD_APCI1710_ReadTTLIOAllPortValues (struct pci_dev *pdev, unsigned int cmd, unsigned long arg)
+{
+	int i_ErrorCode = 0;
+	uint8_t b_ModuleMask = 0;
+	uint32_t ul_ArgArray[9];
+
+	{
+		unsigned long irqstate;
+		APCI1710_LOCK(pdev,&irqstate);
+		{
+			i_ErrorCode = i_APCI1710_ReadTTLIOAllPortValues (pdev,
+																		&b_ModuleMask,
+																		&ul_ArgArray[1],  // pul_PortValue
+																		&ul_ArgArray[5]); // pul_InputMask
+		}
+		APCI1710_UNLOCK(pdev, irqstate);
+	}
+	if (i_ErrorCode != 0)
+		return (i_ErrorCode);
+
+	ul_ArgArray[0] = b_ModuleMask;
+
+	if ( copy_to_user( (uint32_t __user *)arg, ul_ArgArray, sizeof(ul_ArgArray) ) )
+		return -EFAULT;
+
+	return (i_ErrorCode);
+}
+
+//------------------------------------------------------------------------------